@@ -0,0 +1,15 @@
+#pragma once
+
+#include <nanobench.h>
+
+namespace jank::bench
+{
+  /* Each suite runs all of its benchmarks on the given bench, which is already configured
+   * and titled by the driver. */
+  void box(ankerl::nanobench::Bench &b);
+  void core(ankerl::nanobench::Bench &b);
+  void call(ankerl::nanobench::Bench &b);
+  void collection(ankerl::nanobench::Bench &b);
+  void read(ankerl::nanobench::Bench &b);
+  void jit(ankerl::nanobench::Bench &b);
+}
@@ -0,0 +1,31 @@
+#include <jank/runtime/context.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using namespace jank::runtime;
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  void jit(ankerl::nanobench::Bench &b)
+  {
+    /* Every eval is a round trip through the analyzer, codegen, and the JIT, so there's no
+     * point in running many of them per epoch. */
+    b.epochs(5).epochIterations(4).warmup(1);
+
+    b.run("eval_string constant", [&] { doNotOptimizeAway(__rt_ctx->eval_string("42")); });
+    b.run("eval_string call", [&] { doNotOptimizeAway(__rt_ctx->eval_string("(+ 1 2)")); });
+
+    /* Each fn gets a fresh name, so we're not measuring redefinition. */
+    usize i{};
+    b.run("eval_string defn", [&] {
+      doNotOptimizeAway(__rt_ctx->eval_string(
+        util::format("(defn bench-fn-{} [a b] (if (< a b) (str a) (vector a b)))", i++)));
+    });
+
+    b.run("jit_prc eval_string", [&] {
+      __rt_ctx->jit_prc.eval_string(
+        util::format("int jank_bench_fn_{}(int a) { return a * 2; }", i++));
+    });
+  }
+}
@@ -0,0 +1,70 @@
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  /* A mix of the forms which make up most jank source, repeated to a size where the
+   * per file setup doesn't matter. */
+  static jtl::immutable_string make_corpus()
+  {
+    static constexpr char const *forms{ R"(
+(ns jank.bench.corpus
+  (:require [clojure.string :as str]))
+
+(defn ^:private word-frequencies
+  "Counts how many times each word appears in the given text."
+  [text]
+  (->> (str/split text #"\s+")
+       (map str/lower-case)
+       (reduce (fn [acc word]
+                 (update acc word (fnil inc 0)))
+               {})))
+
+(def config {:name "corpus" :version [1 2 3] :ratio 22/7 :pi 3.14159 :enabled? true
+             :tags #{:a :b :c} :chars [\a \b \newline] :big 12345678901234567890N})
+
+(defmacro with-timing [& body]
+  `(let [start# (System/nanoTime)
+         ret# (do ~@body)]
+     [ret# (- (System/nanoTime) start#)]))
+
+(comment
+  (word-frequencies "the quick brown fox jumps over the lazy dog")
+  #_(ignored form)
+  @(future (+ 1 2)))
+)" };
+
+    jtl::string_builder sb;
+    for(usize i{}; i < 256; ++i)
+    {
+      sb(forms);
+    }
+    return sb.release();
+  }
+
+  void read(ankerl::nanobench::Bench &b)
+  {
+    auto const corpus{ make_corpus() };
+    b.batch(corpus.size()).unit("byte");
+
+    b.run("lex", [&] {
+      read::lex::processor l_prc{ corpus };
+      for(auto const &token : l_prc)
+      {
+        doNotOptimizeAway(token.expect_ok().kind);
+      }
+    });
+
+    b.run("lex and parse", [&] {
+      read::lex::processor l_prc{ corpus };
+      read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+      for(auto const &form : p_prc)
+      {
+        doNotOptimizeAway(form.expect_ok());
+      }
+    });
+  }
+}
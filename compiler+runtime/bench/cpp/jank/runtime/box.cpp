@@ -0,0 +1,41 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using namespace jank::runtime;
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  void box(ankerl::nanobench::Bench &b)
+  {
+    i64 i{};
+    b.run("make_box integer", [&] { doNotOptimizeAway(make_box(i++)); });
+
+    f64 r{};
+    b.run("make_box real", [&] { doNotOptimizeAway(make_box(r += 1.0)); });
+
+    b.run("make_box string", [&] { doNotOptimizeAway(make_box("a short string")); });
+
+    jtl::immutable_string const long_string(256, 'x');
+    b.run("make_box string 256", [&] {
+      doNotOptimizeAway(make_box<obj::persistent_string>(long_string));
+    });
+
+    b.run("make_box vector 3", [&] {
+      doNotOptimizeAway(
+        make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box(2), make_box(3)));
+    });
+
+    /* Interning an existing keyword is the common case, since most are interned when their
+     * module is loaded. */
+    b.run("intern_keyword existing",
+          [&] { doNotOptimizeAway(__rt_ctx->intern_keyword("bench-keyword").expect_ok()); });
+    b.run("intern_keyword qualified existing", [&] {
+      doNotOptimizeAway(__rt_ctx->intern_keyword("jank.bench", "bench-keyword").expect_ok());
+    });
+  }
+}
@@ -0,0 +1,57 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/call.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using namespace jank::runtime;
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  /* A fn with every fixed arity dynamic_call supports, plus a variadic arity. */
+  static object_ref make_every_arity_fn()
+  {
+    jtl::string_builder sb;
+    sb("(fn");
+    jtl::string_builder params;
+    for(usize arity{}; arity <= 10; ++arity)
+    {
+      util::format_to(sb, " ([{}] nil)", params.view());
+      params(" p")(static_cast<unsigned long long>(arity));
+    }
+    util::format_to(sb, " ([{} & more] more))", params.view());
+    return __rt_ctx->eval_string(sb.release()).unwrap();
+  }
+
+  void call(ankerl::nanobench::Bench &b)
+  {
+    auto const f{ make_every_arity_fn() };
+    object_ref const a{ make_box(1) };
+
+    b.run("dynamic_call 0", [&] { doNotOptimizeAway(dynamic_call(f)); });
+    b.run("dynamic_call 1", [&] { doNotOptimizeAway(dynamic_call(f, a)); });
+    b.run("dynamic_call 2", [&] { doNotOptimizeAway(dynamic_call(f, a, a)); });
+    b.run("dynamic_call 3", [&] { doNotOptimizeAway(dynamic_call(f, a, a, a)); });
+    b.run("dynamic_call 4", [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a)); });
+    b.run("dynamic_call 5", [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a)); });
+    b.run("dynamic_call 6", [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a)); });
+    b.run("dynamic_call 7", [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a, a)); });
+    b.run("dynamic_call 8",
+          [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a, a, a)); });
+    b.run("dynamic_call 9",
+          [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a, a, a, a)); });
+    b.run("dynamic_call 10",
+          [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a, a, a, a, a)); });
+
+    auto const rest{ make_box<obj::persistent_list>(std::in_place, a, a) };
+    b.run("dynamic_call 10 & 2",
+          [&] { doNotOptimizeAway(dynamic_call(f, a, a, a, a, a, a, a, a, a, a, rest)); });
+
+    auto const inc{ __rt_ctx->find_var("clojure.core", "inc") };
+    b.run("var deref", [&] { doNotOptimizeAway(inc->deref()); });
+    b.run("var deref and call", [&] { doNotOptimizeAway(dynamic_call(inc->deref(), a)); });
+  }
+}
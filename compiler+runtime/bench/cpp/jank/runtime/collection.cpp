@@ -0,0 +1,121 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using namespace jank::runtime;
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  /* Small sizes stay within an array map and a vector's tail, while the larger ones need
+   * a few levels of trie. */
+  static constexpr usize sizes[]{ 1, 8, 32, 1024, 32768 };
+
+  static object_ref make_vector(usize const size)
+  {
+    runtime::detail::native_transient_vector items;
+    for(usize i{}; i < size; ++i)
+    {
+      items.push_back(make_box(i));
+    }
+    return make_box<obj::persistent_vector>(items.persistent());
+  }
+
+  static object_ref make_list(usize const size)
+  {
+    object_ref ret{ obj::persistent_list::empty() };
+    for(usize i{ size }; i > 0; --i)
+    {
+      ret = conj(ret, make_box(i - 1));
+    }
+    return ret;
+  }
+
+  static object_ref make_map(object_ref ret, usize const size)
+  {
+    for(usize i{}; i < size; ++i)
+    {
+      ret = assoc(ret, make_box(i), make_box(i));
+    }
+    return ret;
+  }
+
+  static object_ref make_set(usize const size)
+  {
+    object_ref ret{ obj::persistent_hash_set::empty() };
+    for(usize i{}; i < size; ++i)
+    {
+      ret = conj(ret, make_box(i));
+    }
+    return ret;
+  }
+
+  static jtl::immutable_string
+  bench_name(char const * const op, object_ref const coll, usize const size)
+  {
+    return util::format("{} {} {}", op, object_type_str(coll->type), size);
+  }
+
+  void collection(ankerl::nanobench::Bench &b)
+  {
+    auto const counter{ __rt_ctx->eval_string("(fn [acc _] (inc acc))").unwrap() };
+    object_ref const zero{ make_box(0) };
+
+    for(auto const size : sizes)
+    {
+      /* Keys and values which are present, along with ones which aren't. */
+      object_ref const present{ make_box(size / 2) };
+      object_ref const missing{ make_box(size) };
+
+      auto const vector{ make_vector(size) };
+      b.run(bench_name("conj", vector, size).c_str(),
+            [&] { doNotOptimizeAway(conj(vector, missing)); });
+      b.run(bench_name("assoc", vector, size).c_str(),
+            [&] { doNotOptimizeAway(assoc(vector, present, missing)); });
+      b.run(bench_name("get", vector, size).c_str(),
+            [&] { doNotOptimizeAway(get(vector, present)); });
+      b.run(bench_name("reduce", vector, size).c_str(),
+            [&] { doNotOptimizeAway(reduce(counter, zero, vector)); });
+
+      auto const list{ make_list(size) };
+      b.run(bench_name("conj", list, size).c_str(),
+            [&] { doNotOptimizeAway(conj(list, missing)); });
+      b.run(bench_name("reduce", list, size).c_str(),
+            [&] { doNotOptimizeAway(reduce(counter, zero, list)); });
+
+      /* Array maps are promoted to hash maps once they're full, so only the small sizes
+       * are measured for them. */
+      native_vector<object_ref> maps{ make_map(obj::persistent_hash_map::empty(), size) };
+      if(size <= runtime::detail::native_array_map::max_size)
+      {
+        maps.emplace_back(make_map(obj::persistent_array_map::empty(), size));
+      }
+      for(auto const &map : maps)
+      {
+        b.run(bench_name("assoc new", map, size).c_str(),
+              [&] { doNotOptimizeAway(assoc(map, missing, missing)); });
+        b.run(bench_name("assoc existing", map, size).c_str(),
+              [&] { doNotOptimizeAway(assoc(map, present, missing)); });
+        b.run(bench_name("get", map, size).c_str(), [&] { doNotOptimizeAway(get(map, present)); });
+        b.run(bench_name("get missing", map, size).c_str(),
+              [&] { doNotOptimizeAway(get(map, missing)); });
+        b.run(bench_name("reduce", map, size).c_str(),
+              [&] { doNotOptimizeAway(reduce(counter, zero, map)); });
+      }
+
+      auto const set{ make_set(size) };
+      b.run(bench_name("conj", set, size).c_str(),
+            [&] { doNotOptimizeAway(conj(set, missing)); });
+      b.run(bench_name("get", set, size).c_str(), [&] { doNotOptimizeAway(get(set, present)); });
+      b.run(bench_name("reduce", set, size).c_str(),
+            [&] { doNotOptimizeAway(reduce(counter, zero, set)); });
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/bench.hpp>
+
+namespace jank::bench
+{
+  using namespace jank::runtime;
+  using ankerl::nanobench::doNotOptimizeAway;
+
+  static object_ref make_vector(usize const size)
+  {
+    runtime::detail::native_transient_vector items;
+    for(usize i{}; i < size; ++i)
+    {
+      items.push_back(make_box(i));
+    }
+    return make_box<obj::persistent_vector>(items.persistent());
+  }
+
+  void core(ankerl::nanobench::Bench &b)
+  {
+    object_ref const integer{ make_box(1234567) };
+    object_ref const string{ make_box("some string which is long enough to not be small") };
+    object_ref const keyword{ __rt_ctx->intern_keyword("jank.bench", "hashed").expect_ok() };
+    /* Vectors cache their hash, so we hash fresh ones each time to see the real work. */
+    object_ref const vector{ make_vector(32) };
+
+    b.run("hash integer", [&] { doNotOptimizeAway(to_hash(integer)); });
+    b.run("hash string", [&] {
+      doNotOptimizeAway(to_hash(make_box<obj::persistent_string>(
+        expect_object<obj::persistent_string>(string)->data)));
+    });
+    b.run("hash keyword", [&] { doNotOptimizeAway(to_hash(keyword)); });
+    b.run("hash vector 32", [&] {
+      doNotOptimizeAway(to_hash(
+        make_box<obj::persistent_vector>(expect_object<obj::persistent_vector>(vector)->data)));
+    });
+
+    object_ref const other_integer{ make_box(1234567) };
+    object_ref const other_string{ make_box("some string which is long enough to not be small") };
+    object_ref const other_vector{ make_vector(32) };
+    b.run("equal integer", [&] { doNotOptimizeAway(equal(integer, other_integer)); });
+    b.run("equal string", [&] { doNotOptimizeAway(equal(string, other_string)); });
+    b.run("equal vector 32", [&] { doNotOptimizeAway(equal(vector, other_vector)); });
+    b.run("equal mixed types", [&] { doNotOptimizeAway(equal(integer, string)); });
+
+    b.run("to_string integer", [&] { doNotOptimizeAway(to_string(integer)); });
+    b.run("to_string keyword", [&] { doNotOptimizeAway(to_string(keyword)); });
+    b.run("to_string vector 32", [&] { doNotOptimizeAway(to_string(vector)); });
+  }
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <jank/c_api.h>
+#include <jank/runtime/context.hpp>
+#include <jank/util/fmt/print.hpp>
+#include <clojure/core_native.hpp>
+
+#include <jank/bench.hpp>
+
+#ifdef JANK_PHASE_2
+extern "C" void jank_load_clojure_core();
+#endif
+
+namespace
+{
+  struct suite
+  {
+    char const *name;
+    void (*run)(ankerl::nanobench::Bench &);
+  };
+
+  constexpr suite suites[]{
+    {        "box",        jank::bench::box },
+    {       "core",       jank::bench::core },
+    {       "call",       jank::bench::call },
+    { "collection", jank::bench::collection },
+    {       "read",       jank::bench::read },
+    {        "jit",        jank::bench::jit },
+  };
+
+  void show_help()
+  {
+    jank::util::println(R"(
+jank-bench [--json <path>] [suite...]
+
+Runs jank's C++ microbenchmarks, printing a table for each suite. Only the named suites
+are run, if any are given.
+
+OPTIONS
+  -h, --help                  Print this help message and exit.
+      --json <path>           Also write every result as nanobench JSON. Use - for stdout,
+                              which disables the tables.
+
+SUITES)");
+    for(auto const &s : suites)
+    {
+      jank::util::println("  {}", s.name);
+    }
+  }
+}
+
+/* NOLINTNEXTLINE(bugprone-exception-escape): println can throw. */
+int main(int const argc, char const **argv)
+try
+{
+  return jank_init(argc, argv, /*init_default_ctx=*/true, [](int const argc, char const **argv) {
+    char const *json_path{};
+    std::vector<std::string_view> selected;
+    for(int i{ 1 }; i < argc; ++i)
+    {
+      std::string_view const arg{ argv[i] };
+      if(arg == "-h" || arg == "--help")
+      {
+        show_help();
+        return 0;
+      }
+      else if(arg == "--json" && i + 1 < argc)
+      {
+        json_path = argv[++i];
+      }
+      else
+      {
+        selected.emplace_back(arg);
+      }
+    }
+
+    jank_load_clojure_core_native();
+
+#ifdef JANK_PHASE_2
+    jank_load_clojure_core();
+#else
+    jank::runtime::__rt_ctx->load_module("clojure.core", jank::runtime::module::origin::latest)
+      .expect_ok();
+#endif
+
+    bool const json_to_stdout{ json_path && std::strcmp(json_path, "-") == 0 };
+    std::vector<ankerl::nanobench::Result> results;
+    for(auto const &s : suites)
+    {
+      if(!selected.empty() && std::ranges::find(selected, s.name) == selected.end())
+      {
+        continue;
+      }
+
+      ankerl::nanobench::Bench b;
+      b.title(s.name).warmup(100);
+      if(json_to_stdout)
+      {
+        b.output(nullptr);
+      }
+      s.run(b);
+      std::ranges::copy(b.results(), std::back_inserter(results));
+    }
+
+    if(json_to_stdout)
+    {
+      ankerl::nanobench::render(ankerl::nanobench::templates::json(), results, std::cout);
+    }
+    else if(json_path)
+    {
+      std::ofstream out{ json_path };
+      if(!out)
+      {
+        jank::util::println(stderr, "Unable to open JSON output file: {}", json_path);
+        return 1;
+      }
+      ankerl::nanobench::render(ankerl::nanobench::templates::json(), results, out);
+    }
+
+    return 0;
+  });
+}
+/* Most exceptions are being caught in `jank_init`.
+ * This piece here catches rest of them. */
+catch(...)
+{
+  jank::util::println("Unknown exception thrown");
+  return 1;
+}
@@ -12,6 +12,11 @@ set(CMAKE_CXX_CLANG_TIDY_OLD ${CMAKE_CXX_CLANG_TIDY})
   set(build_cord OFF CACHE BOOL "Build cord")
   set(enable_docs OFF CACHE BOOL "Enable docs")
   set(enable_threads ON CACHE BOOL "Enable multi-threading support")
+  # These are the GC's defaults, but jank relies on them for pause times and allocation
+  # throughput, so we don't leave them to chance. Each registered thread allocates from
+  # its own free lists and marking is spread across --gc-markers threads.
+  set(enable_parallel_mark ON CACHE BOOL "Parallelize marking and free list construction")
+  set(enable_thread_local_alloc ON CACHE BOOL "Turn on thread-local allocation optimization")
   set(enable_large_config ON CACHE BOOL "Optimize for large heap or root set")
   set(enable_throw_bad_alloc_library ON CACHE BOOL "Enable C++ gctba library build")
   set(enable_gc_debug OFF CACHE BOOL "Support for pointer back-tracing")
@@ -33,6 +38,8 @@ set(CMAKE_CXX_CLANG_TIDY_OLD ${CMAKE_CXX_CLANG_TIDY})
   unset(build_cord)
   unset(enable_docs)
   unset(enable_threads)
+  unset(enable_parallel_mark)
+  unset(enable_thread_local_alloc)
   unset(enable_large_config)
   unset(enable_throw_bad_alloc_library)
   unset(enable_valgrind_tracking)
@@ -38,6 +38,7 @@ namespace clojure::core_native
                                                           object_ref const rename,
                                                           object_ref const existing);
   object_ref load_module(object_ref const path);
+  object_ref add_module_dependency(object_ref const module);
   object_ref compile(object_ref const path);
 
   object_ref not_(object_ref const o);
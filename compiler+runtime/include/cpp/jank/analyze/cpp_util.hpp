@@ -64,7 +64,11 @@ namespace jank::analyze::cpp_util
   jtl::ptr<void> untyped_object_ref_type();
   jtl::ptr<void> char_type();
   jtl::ptr<void> bool_type();
+  jtl::ptr<void> i64_type();
+  jtl::ptr<void> f64_type();
   jtl::ptr<void> var_type();
+  jtl::ptr<void> integer_ref_type();
+  jtl::ptr<void> real_ref_type();
   jtl::ptr<void> persistent_list_ref_type();
   jtl::ptr<void> persistent_vector_ref_type();
   jtl::ptr<void> persistent_array_map_ref_type();
@@ -37,6 +37,20 @@ namespace jank::analyze
     file
   };
 
+  /* A small fn which calls can be expanded into at analysis time, rather than calling
+   * through its var. Each arity's body only refers to vars by their qualified names and to
+   * uniquely named locals, so it can be analyzed within any caller. */
+  struct inline_fn
+  {
+    struct arity
+    {
+      runtime::obj::persistent_vector_ref params;
+      runtime::object_ref body;
+    };
+
+    native_unordered_map<usize, arity> arities;
+  };
+
   struct processor
   {
     using expression_result = jtl::result<expression_ref, error_ref>;
@@ -249,5 +263,30 @@ namespace jank::analyze
     local_frame_ptr root_frame;
     native_vector<runtime::object_ref> macro_expansions;
     jtl::option<expr::let_ptr> loop_details;
+    /* Loop bindings which start out as a long or a double are kept unboxed, so long as
+     * every recur into them provides the same kind of number. When one doesn't, the
+     * binding is marked as boxed and the loop is analyzed again. This is indexed by the
+     * loop's binding index. */
+    struct loop_unboxing
+    {
+      enum class binding_state : u8
+      {
+        none,
+        hinted,
+        inferred,
+        boxed
+      };
+
+      native_vector<binding_state> bindings;
+      bool needs_reanalysis{};
+      /* The bindings of the loops nested in this one, in the order they're analyzed. When
+       * this loop is analyzed again, each nested loop starts with the bindings it already
+       * boxed, rather than finding them again with passes of its own. */
+      native_vector<native_vector<binding_state>> nested_bindings;
+      usize next_nested{};
+    };
+    jtl::ptr<loop_unboxing> loop_unboxing_details;
+    /* The vars currently being inlined, so recursive fns don't get expanded forever. */
+    native_vector<runtime::var_ref> inlining_vars;
   };
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/type.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+
+namespace jank::aot
+{
+  /* A startup image holds the vars and keywords which each of the program's modules interns
+   * when it's loaded. Without it, a module's load function interns them one at a time, with
+   * a lock and a persistent insert for each var. With it, the load function hands its slots
+   * to restore_module instead, which fills them in one transient pass per namespace and one
+   * pass over the keyword table.
+   *
+   * Nothing is interned until the module is loaded, so a module which is linked in, but
+   * never required, doesn't show up in all-ns, find-ns, or resolve. Modules which aren't in
+   * the image, or which were compiled separately from it, fall back to interning one at a
+   * time. */
+  struct image_var
+  {
+    jtl::immutable_string ns;
+    jtl::immutable_string name;
+    bool owned{};
+  };
+
+  /* Called by codegen as each module is compiled for AOT. Returns the module's fingerprint,
+   * which its load function passes back to restore_module, so that an image only ever fills
+   * the slots of the same build of the module. */
+  u64 record_module(jtl::immutable_string const &module,
+                    native_vector<image_var> const &vars,
+                    native_vector<jtl::immutable_string> const &keywords);
+
+  /* Only the given modules, which were compiled by this process, are included. */
+  jtl::immutable_string build_startup_image(native_vector<jtl::immutable_string> const &modules);
+  /* The image needs to outlive the process, as embedded data does. */
+  jtl::string_result<void> load_startup_image(jtl::immutable_string_view const &image);
+
+  /* Fills the module's var and keyword slots from the image, in the order which they were
+   * recorded. Returns false, without touching anything, if the image doesn't have a
+   * matching entry for the module. */
+  bool restore_module(jtl::immutable_string const &module,
+                      u64 const fingerprint,
+                      runtime::var_ref * const * const vars,
+                      usize const var_count,
+                      runtime::obj::keyword_ref * const * const keywords,
+                      usize const keyword_count);
+}
@@ -327,6 +327,7 @@ extern "C"
   void jank_resource_register(char const *name, char const *data, jank_usize size);
   void jank_module_register(char const *module, void (*fn)());
   void jank_module_set_loaded(char const *module);
+  void jank_startup_image_load(char const *data, jank_usize size);
 
   int jank_init(int const argc,
                 char const ** const argv,
@@ -22,3 +22,9 @@ jank::runtime::obj::jit_function_ref _jank_fn(jank::runtime::callable_arity_flag
 jank::runtime::obj::jit_closure_ref
 _jank_closure(jank::runtime::callable_arity_flags const flags, void * const ctx);
 jank::runtime::object_ref _jank_read(char const *edn);
+bool _jank_image_restore(char const * const module,
+                         jtl::u64 const fingerprint,
+                         jank::runtime::var_ref * const * const vars,
+                         jtl::usize const var_count,
+                         jank::runtime::obj::keyword_ref * const * const keywords,
+                         jtl::usize const keyword_count);
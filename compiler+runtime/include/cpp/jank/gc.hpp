@@ -8,3 +8,13 @@
 
 #include <gc/gc_cpp.h>
 #include <gc/gc_allocator.h>
+
+/* gc_allocator only allocates pointer free storage for the builtin types which it knows
+ * about. Anything else is scanned conservatively, so we add the rest of the types which we
+ * keep in GC allocated containers, such as i64. */
+GC_DECLARE_PTRFREE(bool);
+GC_DECLARE_PTRFREE(signed long long);
+GC_DECLARE_PTRFREE(unsigned long long);
+GC_DECLARE_PTRFREE(char8_t);
+GC_DECLARE_PTRFREE(char16_t);
+GC_DECLARE_PTRFREE(char32_t);
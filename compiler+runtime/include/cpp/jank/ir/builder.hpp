@@ -95,6 +95,15 @@ namespace jank::ir
                                jtl::immutable_string const &fn_base_name,
                                native_vector<identifier> &&args,
                                bool const needs_dynamic_call);
+    identifier direct_call(analyze::expression_position const pos,
+                           identifier const &fn,
+                           jtl::immutable_string const &fn_base_name,
+                           native_vector<identifier> &&args);
+    identifier keyword_get(analyze::expression_position const pos,
+                           identifier const &source,
+                           identifier const &key,
+                           jtl::option<identifier> const &fallback,
+                           bool const source_is_callee);
     identifier recursion_reference(analyze::expression_position const pos);
     identifier truthy(identifier const &value);
     identifier jump(usize const index);
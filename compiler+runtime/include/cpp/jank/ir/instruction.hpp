@@ -50,6 +50,8 @@ namespace jank::ir
     type_erase,
     dynamic_call,
     named_recursion,
+    direct_call,
+    keyword_get,
     recursion_reference,
     truthy,
     jump,
@@ -281,6 +283,10 @@ namespace jank::ir
       void print(jtl::string_builder &sb, usize indent) const override;
 
       identifier var;
+      /* When a deref is hoisted out of a loop in checked mode, its value may be refreshed
+       * at the start of each iteration, so it needs to be mutable and needs to remember
+       * the var's root version. */
+      bool version_checked{};
     };
 
     using var_deref_ref = jtl::ref<var_deref>;
@@ -343,6 +349,48 @@ namespace jank::ir
 
     using named_recursion_ref = jtl::ref<named_recursion>;
 
+    /* A direct call skips the var deref and virtual dispatch by calling straight into the
+     * generated C++ fn for one arity of a known jank fn. The fn object is still passed
+     * along, since arity fns take it as their first parameter. */
+    struct direct_call : instruction
+    {
+      direct_call(identifier const &name,
+                  jtl::ptr<void> const type,
+                  identifier const &fn,
+                  jtl::immutable_string const &fn_base_name,
+                  native_vector<identifier> &&args);
+
+      void print(jtl::string_builder &sb, usize indent) const override;
+
+      identifier fn;
+      jtl::immutable_string fn_base_name;
+      native_vector<identifier> args;
+    };
+
+    using direct_call_ref = jtl::ref<direct_call>;
+
+    /* A keyword lookup, for calls like `(:k m)`, where the keyword is a literal. When the
+     * map is the callee instead, as in `(m :k)`, the source may not be a map at all, so
+     * `source_is_callee` means we need to fall back to a normal call. */
+    struct keyword_get : instruction
+    {
+      keyword_get(identifier const &name,
+                  jtl::ptr<void> const type,
+                  identifier const &source,
+                  identifier const &key,
+                  jtl::option<identifier> const &fallback,
+                  bool const source_is_callee);
+
+      void print(jtl::string_builder &sb, usize indent) const override;
+
+      identifier source;
+      identifier key;
+      jtl::option<identifier> fallback;
+      bool source_is_callee{};
+    };
+
+    using keyword_get_ref = jtl::ref<keyword_get>;
+
     struct recursion_reference : instruction
     {
       recursion_reference(identifier const &name, jtl::ptr<void> const type);
@@ -447,6 +495,10 @@ namespace jank::ir
       jtl::option<identifier> merge_block;
       jtl::option<detail::typed_identifier> shadow;
       native_vector<binding_shadow_details> binding_shadows;
+      /* Var derefs which were hoisted out of this loop's body and which need to be
+       * re-validated at the start of every iteration. Each pair is the deref's name and
+       * the lifted var. */
+      native_vector<std::pair<identifier, identifier>> checked_var_derefs;
     };
 
     using loop_ref = jtl::ref<loop>;
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <jank/ir/processor.hpp>
+
+namespace jank::ir::pass
+{
+  void hoist_var_derefs(module &mod);
+}
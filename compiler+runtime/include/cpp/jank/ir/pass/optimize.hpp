@@ -0,0 +1,8 @@
+#pragma once
+
+#include <jank/ir/processor.hpp>
+
+namespace jank::ir::pass
+{
+  void optimize(module &mod);
+}
@@ -43,6 +43,10 @@ namespace jank::ir
         return f(jtl::static_ref_cast<inst::dynamic_call>(i), std::forward<Args>(args)...);
       case instruction_kind::named_recursion:
         return f(jtl::static_ref_cast<inst::named_recursion>(i), std::forward<Args>(args)...);
+      case instruction_kind::direct_call:
+        return f(jtl::static_ref_cast<inst::direct_call>(i), std::forward<Args>(args)...);
+      case instruction_kind::keyword_get:
+        return f(jtl::static_ref_cast<inst::keyword_get>(i), std::forward<Args>(args)...);
       case instruction_kind::recursion_reference:
         return f(jtl::static_ref_cast<inst::recursion_reference>(i), std::forward<Args>(args)...);
       case instruction_kind::truthy:
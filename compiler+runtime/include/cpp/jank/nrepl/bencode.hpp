@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::nrepl::bencode
+{
+  /* Decodes a stream of bencoded values, which can arrive in any number of pieces. Integers
+   * become integers, byte strings become strings, lists become vectors, and dicts become
+   * hash maps. */
+  struct decoder
+  {
+    void feed(std::string_view const bytes);
+
+    /* Gives the next complete value, or none if more bytes are needed. After an error,
+     * the rest of the stream can't be trusted, so the decoder needs to be discarded. */
+    jtl::result<jtl::option<runtime::object_ref>, jtl::immutable_string> next();
+
+    /* The number of bytes which have been fed but not yet decoded. */
+    usize pending() const;
+
+  private:
+    std::string buffer;
+    usize offset{};
+    /* When the latest value was incomplete, this is how many pending bytes we need before
+     * it's worth trying again. Large strings arrive over many reads and we don't want to
+     * rescan them for every one. */
+    usize needed{};
+  };
+
+  /* Encodes values in chunks, handing each one to the flush fn once it reaches the chunk
+   * size. This allows large values to be written out while the rest is still being
+   * encoded. Map keys are sorted, as bencode requires. */
+  struct encoder
+  {
+    using flush_fn = std::function<void(std::string &&)>;
+
+    encoder(usize const chunk_size, flush_fn &&flush);
+
+    jtl::string_result<void> encode(runtime::object_ref const o);
+    /* Flushes whatever remains. */
+    void finish();
+
+  private:
+    void write(std::string_view const s);
+    void write_string(std::string_view const s);
+
+    usize chunk_size{};
+    flush_fn flush;
+    std::string chunk;
+  };
+
+  jtl::string_result<jtl::immutable_string> encode(runtime::object_ref const o);
+
+  /* These are for jank, so they throw on failure. Parsing gives a vector of the value and
+   * the remaining input, or nil if the input is incomplete. */
+  runtime::object_ref parse(runtime::object_ref const input);
+  runtime::object_ref write(runtime::object_ref const o);
+}
@@ -1,40 +1,35 @@
 #pragma once
 
-#include <string>
 #include <memory>
 
 #include <jtl/immutable_string.hpp>
 
+#include <jank/runtime/object.hpp>
+
 namespace jank::nrepl::server
 {
-  struct native_client
-  {
-    struct impl;
-
-    native_client(std::unique_ptr<impl> impl);
-
-    /* Indicates that reading and writing may be performed on this client. */
-    bool is_connected() const;
-
-    /* Block until one or more bytes of data is read from the client. */
-    std::string read_some() const;
-
-    /* Write some data to the client. */
-    void write_some(std::string const &data) const;
-
-    std::unique_ptr<impl> impl_;
-  };
-
+  /* An asynchronous nREPL server. Connections are served on a background IO thread, each
+   * with its own strand, and bencode is decoded natively as it arrives. Requests from all
+   * connections are queued up for jank to handle, tagged with the connection they came
+   * from, so responses can be sent back to it from any thread. */
   struct native_server
   {
     struct impl;
 
     native_server();
+    ~native_server();
 
     jtl::immutable_string get_endpoint() const;
     u16 get_port() const;
-    /* Block until a client connects. */
-    native_client *accept() const;
+
+    /* Block until any connection has a request. Returns a vector of the connection id and
+     * the request. Once a connection closes, a final nil request is returned for it. */
+    runtime::object_ref receive() const;
+
+    /* Encode a response and queue it for the connection. The response is fully encoded
+     * before any of it is queued, so one which fails to encode throws without writing
+     * anything. Returns false if the connection is gone. */
+    bool send(runtime::object_ref const connection, runtime::object_ref const message) const;
 
     std::shared_ptr<impl> impl_;
   };
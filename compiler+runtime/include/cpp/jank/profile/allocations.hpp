@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/option.hpp>
+#include <jtl/primitive.hpp>
+#include <jtl/result.hpp>
+
+namespace jank::runtime
+{
+  enum class object_type : u8;
+}
+
+/* The allocation profiler samples the boxes which make_box allocates, recording each
+ * sample's object type and the stack which allocated it. Only about one in every interval
+ * boxes is sampled, on each thread, at random, and each sample stands in for the interval
+ * boxes around it, so the counts and bytes are estimates.
+ *
+ * Only the box itself is counted. Anything which the object allocates on its own, such as
+ * the nodes of a persistent vector, isn't. */
+namespace jank::profile::allocations
+{
+  /* Only set while the profiler is running. This is checked inline, within make_box, so a
+   * stopped profiler costs a load and a branch per box. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern std::atomic_bool enabled;
+
+  /* Starts the profiler from the CLI, if it was requested, and writes the busiest sites to
+   * the requested file at exit. */
+  void configure();
+
+  inline bool is_enabled()
+  {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  jtl::string_result<void> start(u32 const interval);
+  void stop();
+  /* Drops every sample so far. */
+  void clear();
+
+  /* Called by make_box for each box while the profiler is running. */
+  void record(runtime::object_type const type, usize const bytes);
+
+  struct site
+  {
+    runtime::object_type type{};
+    /* The return address into the fn which called make_box. */
+    uptr address{};
+    /* The name of that fn. */
+    jtl::immutable_string caller;
+    /* The innermost jank fn on the stack, which may be the caller itself. Boxes allocated
+     * by the runtime, on behalf of a jank fn, are charged to that jank fn. */
+    jtl::option<jtl::immutable_string> jank_fn;
+    u64 count{};
+    u64 bytes{};
+  };
+
+  /* Every site sampled so far, most bytes first. */
+  std::vector<site> sites();
+  /* How long the profiler has been running, in total, since it was last cleared. */
+  f64 elapsed_seconds();
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+
+#include <jank/runtime/object.hpp>
+
+/* The compile report breaks down where compile time goes, by phase, for each top-level
+ * form and each namespace. Unlike the profiler, which records every region as it
+ * happens, this only keeps running totals, so it can stay on for a whole load.
+ *
+ * Phases are exclusive. When one phase starts within another, such as a macro being
+ * JIT compiled during analysis, the time is charged to the inner phase until it ends.
+ * That way, the phases of a form add up to the time spent compiling it. */
+namespace jank::profile::compile_report
+{
+  enum class phase : u8
+  {
+    /* Lexing and parsing. The parser pulls each token from the lexer as it needs it, so
+     * they're timed together, once per form, rather than once per token. */
+    read,
+    macroexpand,
+    analyze,
+    ir,
+    codegen,
+    /* Parsing the generated C++, generating its LLVM IR, and adding it to the JIT. */
+    clang,
+    /* Looking up JIT compiled symbols, which is when LLVM compiles and links them. */
+    link,
+    /* AOT compilation only, since the JIT optimizes as it compiles. */
+    optimize,
+    emit,
+    /* Running the compiled code. */
+    eval
+  };
+
+  constexpr usize phase_count{ static_cast<usize>(phase::eval) + 1 };
+
+  constexpr char const *phase_str(phase const p)
+  {
+    switch(p)
+    {
+      case phase::read:
+        return "read";
+      case phase::macroexpand:
+        return "macroexpand";
+      case phase::analyze:
+        return "analyze";
+      case phase::ir:
+        return "ir";
+      case phase::codegen:
+        return "codegen";
+      case phase::clang:
+        return "clang";
+      case phase::link:
+        return "link";
+      case phase::optimize:
+        return "optimize";
+      case phase::emit:
+        return "emit";
+      case phase::eval:
+        return "eval";
+      default:
+        return "unknown";
+    }
+  }
+
+  /* Only set once the report is configured. This is checked inline, so a disabled report
+   * costs a load and a branch per phase. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern std::atomic_bool enabled;
+
+  /* Enables the report, if it was requested, and writes it at exit. */
+  void configure();
+  void write();
+
+  inline bool is_enabled()
+  {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  void enter(phase const p);
+  void exit();
+
+  /* Frames collect the time of each phase on this thread until they're recorded. Anything
+   * compiled outside of a frame, such as a lazily compiled fn on its first call, is
+   * charged to the runtime. */
+  void push_frame();
+  void pop_frame();
+  /* Records the current frame as a top-level form of the namespace and resets it for
+   * the next one. */
+  void record_form(jtl::immutable_string const &ns, runtime::object_ref const form);
+  /* Records the current frame as part of the namespace, but not as any one form. */
+  void record_module(jtl::immutable_string const &ns);
+
+  void add_generated_cpp(usize const bytes);
+  void add_instructions(usize const count);
+
+  struct phase_timer
+  {
+    phase_timer() = delete;
+    phase_timer(phase_timer const &) = delete;
+    phase_timer(phase_timer &&) = delete;
+
+    phase_timer(phase const p)
+      : active{ is_enabled() }
+    {
+      if(active)
+      {
+        enter(p);
+      }
+    }
+
+    ~phase_timer()
+    {
+      if(active)
+      {
+        exit();
+      }
+    }
+
+    phase_timer &operator=(phase_timer const &) = delete;
+    phase_timer &operator=(phase_timer &&) = delete;
+
+    bool active{};
+  };
+
+  /* A frame which is dropped at the end of the scope. Given a namespace, whatever wasn't
+   * recorded within the scope is first recorded as part of that namespace. */
+  struct frame
+  {
+    frame(frame const &) = delete;
+    frame(frame &&) = delete;
+
+    frame()
+      : active{ is_enabled() }
+    {
+      if(active)
+      {
+        push_frame();
+      }
+    }
+
+    frame(jtl::immutable_string const &ns)
+      : ns{ ns }
+      , active{ is_enabled() }
+    {
+      if(active)
+      {
+        push_frame();
+      }
+    }
+
+    ~frame()
+    {
+      if(active)
+      {
+        if(!ns.empty())
+        {
+          record_module(ns);
+        }
+        pop_frame();
+      }
+    }
+
+    frame &operator=(frame const &) = delete;
+    frame &operator=(frame &&) = delete;
+
+    jtl::immutable_string ns;
+    bool active{};
+  };
+}
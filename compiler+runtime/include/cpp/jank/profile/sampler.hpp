@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/read/source.hpp>
+
+/* A sampling profiler which doesn't need any external tools. While it's running, the
+ * process gets a SIGPROF at the given rate, as it uses CPU time, and whichever thread
+ * receives it records its stack by following frame pointers. Stacks are symbolized only
+ * once they're requested, so JIT compiled fns are shown by their jank names and sources,
+ * while native fns are shown by their demangled names.
+ *
+ * Stacks are given as folded stacks, which flamegraph.pl, inferno, and speedscope can
+ * all read. */
+namespace jank::profile::sampler
+{
+  /* Starts the sampler from the CLI, if it was requested, and writes the folded stacks to
+   * the requested file at exit. */
+  void configure();
+
+  /* The sampler handles SIGPROF while it's running. Stopping puts back whatever handled it
+   * before. */
+  jtl::string_result<void> start(u32 const hz);
+  void stop();
+  bool is_running();
+  /* Drops every sample so far. */
+  void clear();
+
+  /* Each unique stack so far, one per line, from the outermost frame to the innermost,
+   * followed by the number of times it was sampled. */
+  jtl::immutable_string folded_stacks();
+
+  /* The name of the fn containing the address, as it's shown in folded stacks. */
+  jtl::immutable_string symbolize(uptr const address);
+  /* The qualified name and source of the jank fn containing the address, if it's within a
+   * JIT compiled jank fn. */
+  jtl::option<jtl::immutable_string> jank_fn_at(uptr const address);
+
+  /* The linker knows where each JIT compiled fn ends up, but not which jank fn it is,
+   * so the JIT registers its symbols as it links them. Every fn is registered, whether or
+   * not a profiler is running, so that a profiler which starts later can still name fns
+   * which were compiled before it. */
+  void register_jit_symbol(uptr const start, usize const size, std::string_view const name);
+  /* Maps a jank fn's munged unique name, which its linkage names start with, back to its
+   * qualified name and where it's defined. */
+  void register_jank_fn(jtl::immutable_string const &munged_name,
+                        jtl::immutable_string const &qualified_name,
+                        read::source const &source);
+}
@@ -1,23 +1,88 @@
 #pragma once
 
+#include <atomic>
+
 #include <jank/type.hpp>
+#include <jank/util/fmt.hpp>
 
 namespace jank::profile
 {
+  /* Only set once the profiler is configured and its output is open. This is checked
+   * inline, so disabled profiling costs a load and a branch per region. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern std::atomic_bool enabled;
+
   void configure();
-  bool is_enabled();
+  /* Stops the flushing thread and writes out every event which is still buffered. This
+   * happens at exit, but it may be called earlier. */
+  void shutdown();
+
+  inline bool is_enabled()
+  {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
   void enter(jtl::immutable_string_view const &region);
   void exit(jtl::immutable_string_view const &region);
   void report(jtl::immutable_string_view const &boundary);
+  /* Records the current value of a counter, which is shown as its own track. */
+  void counter(jtl::immutable_string_view const &name, i64 const value);
 
+  /* Flows link the region which starts some work to the region which later does it, such
+   * as a deferred fn being created and then compiled on its first call. Both ends need to
+   * be recorded within a region. Ids start from one, so zero can mean there's no flow. */
+  u64 next_flow_id();
+  void flow_start(jtl::immutable_string_view const &name, u64 const id);
+  void flow_end(jtl::immutable_string_view const &name, u64 const id);
+
+  /* Timers don't own their region name, so static regions, which are the vast majority,
+   * cost nothing when profiling is disabled. Regions which need formatting take the format
+   * string and args separately and are only formatted when profiling is enabled. */
   struct timer
   {
     timer() = delete;
-    timer(jtl::immutable_string_view const &region);
-    ~timer();
+    timer(timer const &) = delete;
+    timer(timer &&) = delete;
+
+    timer(char const * const region)
+      : region{ region }
+      , active{ is_enabled() }
+    {
+      if(active)
+      {
+        enter(this->region);
+      }
+    }
+
+    template <typename... Args>
+    requires(sizeof...(Args) > 0)
+    timer(char const * const fmt, Args &&...args)
+      : region{ fmt }
+      , active{ is_enabled() }
+    {
+      if(active)
+      {
+        formatted = util::format(fmt, std::forward<Args>(args)...);
+        region = formatted;
+        enter(region);
+      }
+    }
+
+    ~timer()
+    {
+      if(active)
+      {
+        exit(region);
+      }
+    }
+
+    timer &operator=(timer const &) = delete;
+    timer &operator=(timer &&) = delete;
 
     void report(jtl::immutable_string_view const &boundary) const;
 
-    jtl::immutable_string region;
+    jtl::immutable_string_view region;
+    bool active{};
+    jtl::immutable_string formatted;
   };
 }
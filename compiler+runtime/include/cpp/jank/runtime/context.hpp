@@ -1,6 +1,8 @@
 #pragma once
 
 #include <list>
+#include <memory>
+#include <unordered_map>
 
 #include <folly/Synchronized.h>
 
@@ -11,6 +13,7 @@
 #include <jank/runtime/var.hpp>
 #include <jank/jit/processor.hpp>
 #include <jank/util/cli.hpp>
+#include <jank/util/thread_pool.hpp>
 
 namespace jank
 {
@@ -112,6 +115,10 @@ namespace jank::runtime
      */
     jtl::result<void, error_ref>
     load_module(jtl::immutable_string const &module, module::origin ori);
+    /* Records that the module currently being loaded depends on the given module, so its
+     * compiled form is stale once the dependency changes. This is needed even when the
+     * dependency was already loaded by another module. */
+    void add_module_dependency(jtl::immutable_string const &module);
 
     /* Does all the same work as load_module, but also writes compiled files to the file system. */
     jtl::result<void, error_ref> compile_module(jtl::immutable_string const &module);
@@ -119,9 +126,16 @@ namespace jank::runtime
     object_ref eval(object_ref const o);
 
     jtl::immutable_string get_output_module_name(jtl::immutable_string const &module_name) const;
+    /* Object files are emitted on a worker pool, so independent modules can be compiled in
+     * parallel. Use wait_for_module_writes to know they're all done. If optimize is set,
+     * the module is optimized before it's written. */
     jtl::string_result<void> write_module(jtl::immutable_string const &module_name,
                                           jtl::immutable_string const &cpp_code,
-                                          jtl::ref<llvm::Module> const &module) const;
+                                          jtl::ref<llvm::Module> const &module,
+                                          bool optimize) const;
+    /* Blocks until every queued module write is done. If any failed, the first failure
+     * is returned. */
+    jtl::string_result<void> wait_for_module_writes() const;
 
     /* Generates a unique name for use with anything from codgen structs,
      * lifted vars, to shadowed locals. Prefixes with current namespace. */
@@ -147,9 +161,6 @@ namespace jank::runtime
 
     /*** XXX: Everything here is immutable after initialization. ***/
     jtl::immutable_string binary_version;
-    /* TODO: This needs to be a dynamic var. */
-    native_unordered_map<jtl::immutable_string, native_vector<jtl::immutable_string>>
-      module_dependencies;
 
     module::loader module_loader;
 
@@ -168,6 +179,28 @@ namespace jank::runtime
     folly::Synchronized<native_unordered_map<jtl::immutable_string, obj::keyword_ref>> keywords;
     folly::Synchronized<native_unordered_map<std::thread::id, native_list<thread_binding_frame>>>
       thread_binding_frames;
+    /* Fns which the analyzer may inline at call sites. These are registered, or cleared,
+     * each time a var is defined. */
+    folly::Synchronized<native_unordered_map<var_ref, analyze::inline_fn>> inline_fns;
+    /* Module to the modules it requires or inlines from. It's written whenever a module is
+     * loaded, or an inline call is analyzed, which can happen on any thread that requires
+     * or evals, such as within a future. It's read by the module loader and by AOT builds.
+     * The lock only protects the map itself. Analysis still happens one form at a time. */
+    folly::Synchronized<
+      native_unordered_map<jtl::immutable_string, native_vector<jtl::immutable_string>>>
+      module_dependencies;
+
+    struct module_writes
+    {
+      /* This is created the first time a module is written. */
+      std::unique_ptr<util::thread_pool> pool;
+      /* The same module may be written more than once. The latest write needs to win, even
+       * though they can finish in any order. */
+      std::unordered_map<std::string, u64> latest_generations;
+      u64 next_generation{};
+      jtl::option<jtl::immutable_string> first_error;
+    };
+    mutable folly::Synchronized<module_writes, std::mutex> pending_module_writes;
 
     /* This must go last, since it'll try to access other bits in the runtime context during
      * its initialization and we need them to be ready. */
@@ -37,6 +37,28 @@ namespace jank::runtime
   object_ref pr(object_ref const args);
   object_ref prn(object_ref const args);
 
+  /* While one of these is alive, print and friends write to it, rather than stdout, and
+   * warnings go to it, rather than stderr. This only applies to the thread which created
+   * it, so concurrent evals can each capture their own output. Output which is written to
+   * the streams directly, such as from C++, isn't captured. */
+  struct output_capture
+  {
+    output_capture();
+    output_capture(output_capture const &) = delete;
+    output_capture(output_capture &&) = delete;
+    ~output_capture();
+
+    output_capture &operator=(output_capture const &) = delete;
+    output_capture &operator=(output_capture &&) = delete;
+
+    /* Returns null when this thread isn't capturing. */
+    static output_capture *current();
+
+    jtl::string_builder out;
+    jtl::string_builder err;
+    output_capture *previous{};
+  };
+
   obj::persistent_string_ref subs(object_ref const s, object_ref const start);
   obj::persistent_string_ref subs(object_ref const s, object_ref const start, object_ref const end);
   i64 first_index_of(object_ref const s, object_ref const m);
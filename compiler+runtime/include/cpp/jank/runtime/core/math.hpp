@@ -34,6 +34,75 @@ namespace jank::runtime
                                                     obj::ratio_ref>);
   }
 
+  /* Kept out of line, so the overflow checks below are only a branch. */
+  [[noreturn]]
+  void throw_integer_overflow(char const * const op, i64 const l);
+  [[noreturn]]
+  void throw_integer_overflow(char const * const op, i64 const l, i64 const r);
+
+  namespace detail
+  {
+    template <typename L, typename R>
+    concept checked_integers = (std::is_integral_v<L> && !std::same_as<L, bool>
+                                && std::is_integral_v<R> && !std::same_as<R, bool>);
+
+    /* An unboxed integer can't be promoted, so these throw on overflow, rather than
+     * wrapping, which would be UB. Anything else uses the usual operator. */
+    template <typename L, typename R>
+    auto checked_add(L const l, R const r)
+    {
+      if constexpr(checked_integers<L, R>)
+      {
+        decltype(l + r) res{};
+        if(__builtin_add_overflow(l, r, &res)) [[unlikely]]
+        {
+          throw_integer_overflow("+", static_cast<i64>(l), static_cast<i64>(r));
+        }
+        return res;
+      }
+      else
+      {
+        return l + r;
+      }
+    }
+
+    template <typename L, typename R>
+    auto checked_sub(L const l, R const r)
+    {
+      if constexpr(checked_integers<L, R>)
+      {
+        decltype(l - r) res{};
+        if(__builtin_sub_overflow(l, r, &res)) [[unlikely]]
+        {
+          throw_integer_overflow("-", static_cast<i64>(l), static_cast<i64>(r));
+        }
+        return res;
+      }
+      else
+      {
+        return l - r;
+      }
+    }
+
+    template <typename L, typename R>
+    auto checked_mul(L const l, R const r)
+    {
+      if constexpr(checked_integers<L, R>)
+      {
+        decltype(l * r) res{};
+        if(__builtin_mul_overflow(l, r, &res)) [[unlikely]]
+        {
+          throw_integer_overflow("*", static_cast<i64>(l), static_cast<i64>(r));
+        }
+        return res;
+      }
+      else
+      {
+        return l * r;
+      }
+    }
+  }
+
   template <typename L, typename R>
   requires(!detail::primitive_number<L> && !detail::primitive_number<R>)
   auto add(L const l, R const r)
@@ -93,17 +162,19 @@ namespace jank::runtime
     else if constexpr(jtl::is_same<R, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_r, L const l) { return make_box(l + typed_r->data).erase(); },
+        [](auto const typed_r, L const l) {
+          return make_box(detail::checked_add(l, typed_r->data)).erase();
+        },
         r,
         l);
     }
     else if constexpr(detail::typed_object<R>)
     {
-      return l + r->data;
+      return detail::checked_add(l, r->data);
     }
     else
     {
-      return l + r;
+      return detail::checked_add(l, r);
     }
   }
 
@@ -121,17 +192,19 @@ namespace jank::runtime
     else if constexpr(jtl::is_same<L, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_l, R const r) { return make_box(typed_l->data + r).erase(); },
+        [](auto const typed_l, R const r) {
+          return make_box(detail::checked_add(typed_l->data, r)).erase();
+        },
         l,
         r);
     }
     else if constexpr(detail::typed_object<L>)
     {
-      return l->data + r;
+      return detail::checked_add(l->data, r);
     }
     else
     {
-      return l + r;
+      return detail::checked_add(l, r);
     }
   }
 
@@ -139,7 +212,7 @@ namespace jank::runtime
   requires(detail::primitive_number<L> && detail::primitive_number<R>)
   auto add(L const l, R const r)
   {
-    return l + r;
+    return detail::checked_add(l, r);
   }
 
   object_ref promoting_add(object_ref const l, object_ref const r);
@@ -203,17 +276,19 @@ namespace jank::runtime
     else if constexpr(jtl::is_same<R, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_r, L const l) { return make_box(l - typed_r->data).erase(); },
+        [](auto const typed_r, L const l) {
+          return make_box(detail::checked_sub(l, typed_r->data)).erase();
+        },
         r,
         l);
     }
     else if constexpr(detail::typed_object<R>)
     {
-      return l - r->data;
+      return detail::checked_sub(l, r->data);
     }
     else
     {
-      return l - r;
+      return detail::checked_sub(l, r);
     }
   }
 
@@ -231,17 +306,19 @@ namespace jank::runtime
     else if constexpr(jtl::is_same<L, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_l, R const r) { return make_box(typed_l->data - r).erase(); },
+        [](auto const typed_l, R const r) {
+          return make_box(detail::checked_sub(typed_l->data, r)).erase();
+        },
         l,
         r);
     }
     else if constexpr(detail::typed_object<L>)
     {
-      return l->data - r;
+      return detail::checked_sub(l->data, r);
     }
     else
     {
-      return l - r;
+      return detail::checked_sub(l, r);
     }
   }
 
@@ -249,7 +326,7 @@ namespace jank::runtime
   requires(detail::primitive_number<L> && detail::primitive_number<R>)
   auto sub(L const l, R const r)
   {
-    return l - r;
+    return detail::checked_sub(l, r);
   }
 
   object_ref promoting_sub(object_ref const l, object_ref const r);
@@ -421,17 +498,19 @@ namespace jank::runtime
     else if constexpr(jtl::is_same<R, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_r, L const l) { return make_box(l * typed_r->data).erase(); },
+        [](auto const typed_r, L const l) {
+          return make_box(detail::checked_mul(l, typed_r->data)).erase();
+        },
         r,
         l);
     }
     else if constexpr(detail::typed_object<R>)
     {
-      return l * r->data;
+      return detail::checked_mul(l, r->data);
     }
     else
     {
-      return l * r;
+      return detail::checked_mul(l, r);
     }
   }
 
@@ -449,17 +528,19 @@ namespace jank::runtime
     if constexpr(jtl::is_same<L, object_ref>)
     {
       return visit_number_like(
-        [](auto const typed_l, R const r) { return make_box(typed_l->data * r).erase(); },
+        [](auto const typed_l, R const r) {
+          return make_box(detail::checked_mul(typed_l->data, r)).erase();
+        },
         l,
         r);
     }
     else if constexpr(detail::typed_object<L>)
     {
-      return l->data * r;
+      return detail::checked_mul(l->data, r);
     }
     else
     {
-      return l * r;
+      return detail::checked_mul(l, r);
     }
   }
 
@@ -467,7 +548,7 @@ namespace jank::runtime
   requires(detail::primitive_number<L> && detail::primitive_number<R>)
   auto mul(L const l, R const r)
   {
-    return l * r;
+    return detail::checked_mul(l, r);
   }
 
   object_ref promoting_mul(object_ref const l, object_ref const r);
@@ -970,6 +1051,46 @@ namespace jank::runtime
   object_ref dec(object_ref const l);
   object_ref promoting_dec(object_ref const l);
 
+  /* These keep unboxed numbers, such as unboxed loop locals, unboxed. An unboxed integer
+   * can't be promoted, so these throw on overflow, as inc and dec are documented to. */
+  template <typename T>
+  requires detail::primitive_number<T>
+  T inc(T const l)
+  {
+    if constexpr(std::is_integral_v<T> && !std::same_as<T, bool>)
+    {
+      T res{};
+      if(__builtin_add_overflow(l, T{ 1 }, &res)) [[unlikely]]
+      {
+        throw_integer_overflow("inc", static_cast<i64>(l));
+      }
+      return res;
+    }
+    else
+    {
+      return static_cast<T>(l + 1);
+    }
+  }
+
+  template <typename T>
+  requires detail::primitive_number<T>
+  T dec(T const l)
+  {
+    if constexpr(std::is_integral_v<T> && !std::same_as<T, bool>)
+    {
+      T res{};
+      if(__builtin_sub_overflow(l, T{ 1 }, &res)) [[unlikely]]
+      {
+        throw_integer_overflow("dec", static_cast<i64>(l));
+      }
+      return res;
+    }
+    else
+    {
+      return static_cast<T>(l - 1);
+    }
+  }
+
   bool is_zero(object_ref const l);
   bool is_pos(object_ref const l);
   bool is_neg(object_ref const l);
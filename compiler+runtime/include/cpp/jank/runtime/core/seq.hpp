@@ -10,6 +10,7 @@ namespace jank::runtime
   {
     using persistent_list_ref = oref<struct persistent_list>;
     using persistent_vector_ref = oref<struct persistent_vector>;
+    using keyword_ref = oref<struct keyword>;
   }
 
   template <typename T>
@@ -122,6 +123,15 @@ namespace jank::runtime
   object_ref dissoc(object_ref const m, object_ref const k);
   object_ref get(object_ref const m, object_ref const key);
   object_ref get(object_ref const m, object_ref const key, object_ref const fallback);
+  /* Specialized lookups for `(:k m)`, used by codegen when the keyword is known. Array
+   * and hash maps are checked directly before falling back to `get`. */
+  object_ref keyword_get(object_ref const m, obj::keyword_ref const key);
+  object_ref keyword_get(object_ref const m, obj::keyword_ref const key, object_ref const fallback);
+  /* The same, but for `(m :k)`, where the source may not be a map at all. Anything which
+   * isn't a map is called normally. */
+  object_ref keyword_call(object_ref const source, obj::keyword_ref const key);
+  object_ref
+  keyword_call(object_ref const source, obj::keyword_ref const key, object_ref const fallback);
   object_ref get_in(object_ref const m, object_ref const keys);
   object_ref get_in(object_ref const m, object_ref const keys, object_ref const fallback);
   object_ref find(object_ref const s, object_ref const key);
@@ -129,6 +129,7 @@ namespace jank::runtime::module
   };
 
   jtl::immutable_string path_to_module(std::filesystem::path const &path);
+  jtl::immutable_string hash_record_path(jtl::immutable_string const &compiled_path);
   jtl::immutable_string module_to_path(jtl::immutable_string const &module);
   jtl::immutable_string module_to_load_function(jtl::immutable_string const &module);
   jtl::immutable_string
@@ -201,11 +202,41 @@ namespace jank::runtime::module
     void add_path(jtl::immutable_string const &path);
     void add_load_fn(jtl::immutable_string const &module, jtl::ref<void()> const fn);
 
+    /* The SHA-256 of a module's source. This is cached until the source's path, size, or
+     * modification time change. */
+    jtl::option<jtl::immutable_string> source_hash(jtl::immutable_string const &module);
+    /* Compiled modules are written alongside a hash record, which has the hash of the
+     * module's source and the hashes of its transitive dependencies' sources. This allows
+     * us to know if a compiled module is stale without trusting file modification times,
+     * which don't survive things like git checkouts and CI cache restores. */
+    jtl::immutable_string build_hash_record(jtl::immutable_string const &module);
+    /* Returns none when the compiled module has no hash record, in which case modification
+     * times need to be compared instead. */
+    jtl::option<bool>
+    matches_hash_record(jtl::immutable_string const &module, file_entry const &compiled);
+
+    /* Builds an index of every JAR on the module path, which can be embedded in AOT
+     * executables as the `module-index` resource. With that, the JARs don't need to be
+     * opened just to list them at startup. */
+    jtl::immutable_string build_jar_index();
+
     object_ref to_runtime_data() const;
 
+    struct source_stamp
+    {
+      bool operator==(source_stamp const &) const = default;
+
+      jtl::immutable_string archive_path;
+      jtl::immutable_string path;
+      std::filesystem::file_time_type modified_at;
+      uintmax_t size{};
+    };
+
     struct mutable_state
     {
       jtl::immutable_string paths;
+      /* The module path is registered lazily, when the first module is found. */
+      bool indexed{};
       /* This maps module strings to entries. Module strings are like fully qualified namespace
        * names. For example, `clojure.core`, `jank.compiler`, etc. */
       native_unordered_map<jtl::immutable_string, entry> entries;
@@ -215,9 +246,15 @@ namespace jank::runtime::module
        *
        * This map is from module to load function. */
       native_unordered_map<jtl::immutable_string, jtl::ref<void()>> managed_load_fns;
+      /* Module to the SHA-256 of its source, along with the version of the source which
+       * was hashed. */
+      native_unordered_map<jtl::immutable_string,
+                           std::pair<source_stamp, jtl::immutable_string>>
+        source_hashes;
     };
 
     /*** XXX: Everything here is thread-safe. ***/
-    folly::Synchronized<mutable_state, std::recursive_mutex> state;
+    /* This is mutable so that const accessors can still index the module path lazily. */
+    mutable folly::Synchronized<mutable_state, std::recursive_mutex> state;
   };
 }
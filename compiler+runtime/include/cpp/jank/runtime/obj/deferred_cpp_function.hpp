@@ -50,9 +50,15 @@ namespace jank::runtime::obj
     object_ref call(object_ref const) const override;
     callable_arity_flags get_arity_flags() const override;
 
+    /* JIT compiles the C++ code, if it hasn't been already, and rebinds the var to the
+     * compiled fn. */
+    jit_function_ref compile() const;
+
     /*** XXX: Everything here is immutable after initialization. ***/
     object_ref meta;
     var_ref var;
+    /* When profiling, this links the fn's creation to its compilation. */
+    u64 flow_id{};
 
     /*** XXX: Everything here is thread-safe. ***/
     mutable std::recursive_mutex compilation_mutex;
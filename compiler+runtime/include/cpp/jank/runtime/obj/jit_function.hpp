@@ -135,5 +135,8 @@ namespace jank::runtime::obj
                            object_ref){};
     object_ref meta;
     callable_arity_flags arity_flags{};
+    /* The symbol prefix for each arity, which are named `{base_name}_{arity}`. This allows
+     * direct linking to call the arity symbols without going through this object. */
+    jtl::immutable_string base_name;
   };
 }
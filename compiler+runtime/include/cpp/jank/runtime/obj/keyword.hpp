@@ -47,6 +47,9 @@ namespace jank::runtime::obj
 
     /*** XXX: Everything here is immutable after initialization. ***/
     symbol_ref sym;
+    /* Keywords are interned and commonly used as map keys, so their hash is computed
+     * once, when they're interned. */
+    uhash hash{};
   };
 
   using keyword_ref = oref<keyword>;
@@ -8,6 +8,7 @@
 #include <jtl/assert.hpp>
 
 #include <jank/runtime/object.hpp>
+#include <jank/profile/allocations.hpp>
 
 /* During AOT codegen, we need to initialize a bunch of lifted constants and globals, but
  * the jank_nil global may not yet be initialized, since the order of initialization of globals
@@ -572,6 +573,10 @@ namespace jank::runtime
     {
       ret = new(UseGC) T{ std::forward<Args>(args)... };
     }
+    if(profile::allocations::is_enabled()) [[unlikely]]
+    {
+      profile::allocations::record(T::obj_type, sizeof(T));
+    }
     return ret;
   }
 
@@ -5,4 +5,16 @@
 namespace jank::runtime::perf
 {
   object_ref benchmark(object_ref const opts, object_ref const f);
+
+  object_ref start_sampling(object_ref const opts);
+  object_ref stop_sampling();
+  object_ref is_sampling();
+  object_ref folded_stacks();
+  object_ref clear_samples();
+
+  object_ref start_allocation_profile(object_ref const opts);
+  object_ref stop_allocation_profile();
+  object_ref allocation_sites(object_ref const opts);
+  object_ref allocation_types();
+  object_ref clear_allocations();
 }
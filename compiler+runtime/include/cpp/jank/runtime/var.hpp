@@ -86,6 +86,9 @@ namespace jank::runtime
   public:
     std::atomic_bool dynamic{ false };
     std::atomic_bool thread_bound{ false };
+    /* Bumped whenever the root or dynamic flag changes. Generated code which caches a
+     * deref, such as hoisted loop derefs, can compare this to know when to deref again. */
+    std::atomic<u64> root_version{};
   };
 
   struct var_thread_binding : object
@@ -116,7 +119,7 @@ namespace jank::runtime
   {
     static constexpr object_type obj_type{ object_type::var_unbound_root };
     static constexpr object_behavior obj_behaviors{ object_behavior::none };
-    static constexpr bool pointer_free{ true };
+    static constexpr bool pointer_free{ false };
 
     var_unbound_root(var_ref const var);
 
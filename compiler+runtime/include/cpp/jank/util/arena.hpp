@@ -0,0 +1,61 @@
+#pragma once
+
+#include <new>
+
+#include <jtl/ref.hpp>
+#include <jtl/primitive.hpp>
+
+namespace jank::util
+{
+  /* A bump allocator for compiler data, such as analyzed expressions, local frames, and IR
+   * instructions, which is only needed while a single top level form is being compiled.
+   * Allocating them one by one leaves the GC with many small objects to trace and sweep,
+   * so instead they're packed into a few large chunks, which become garbage together.
+   *
+   * Creating an arena makes it the current arena for this thread until it's destroyed, so
+   * arenas need to live on the stack. Nested arenas are fine; the innermost one is used.
+   *
+   * The chunks are regular GC allocations, so they're still scanned and nothing needs to be
+   * freed explicitly. Anything which outlives the arena is promoted just by being
+   * referenced, since that keeps its whole chunk alive. This relies on interior pointers
+   * keeping allocations alive, so arenas do nothing when the GC doesn't recognize them. */
+  struct arena
+  {
+    static constexpr usize chunk_size{ 64 * 1024 };
+    /* Anything larger gets its own GC allocation, so chunks aren't left mostly empty. */
+    static constexpr usize max_inline_size{ chunk_size / 8 };
+
+    arena();
+    arena(arena const &) = delete;
+    arena(arena &&) = delete;
+    ~arena();
+
+    arena &operator=(arena const &) = delete;
+    arena &operator=(arena &&) = delete;
+
+    /* Returns null when there's no current arena for this thread. */
+    static arena *current();
+
+    void *allocate(usize const size, usize const alignment);
+
+    /* The chunk being filled, which this keeps alive until it's replaced. */
+    void *chunk{};
+    char *pos{};
+    char *end{};
+    arena *previous{};
+    bool active{};
+  };
+
+  /* Like `jtl::make_ref`, but allocates from the current arena, if there is one. This is
+   * only for compiler data. Runtime values can outlive the form which created them, so
+   * they'd keep a whole chunk alive. */
+  template <typename T, typename... Args>
+  jtl::ref<T> make_arena_ref(Args &&...args)
+  {
+    if(auto * const a{ arena::current() })
+    {
+      return new(a->allocate(sizeof(T), alignof(T))) T{ jtl::forward<Args>(args)... };
+    }
+    return jtl::make_ref<T>(jtl::forward<Args>(args)...);
+  }
+}
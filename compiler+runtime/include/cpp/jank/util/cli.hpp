@@ -65,14 +65,111 @@ namespace jank::util::cli
     }
   }
 
+  /* Non-dynamic var derefs within a loop body can be hoisted into the loop's preheader,
+   * since their roots don't normally change while the loop is running. The checked mode
+   * keeps REPL redefinitions working by comparing the var's root version once per
+   * iteration, rather than taking the var's lock on every deref. */
+  enum class var_hoisting : u8
+  {
+    none,
+    checked,
+    unchecked
+  };
+
+  constexpr char const *var_hoisting_str(var_hoisting const hoisting)
+  {
+    switch(hoisting)
+    {
+      case var_hoisting::none:
+        return "none";
+      case var_hoisting::checked:
+        return "checked";
+      case var_hoisting::unchecked:
+        return "unchecked";
+      default:
+        return "unknown";
+    }
+  }
+
+  enum class lto_mode : u8
+  {
+    none,
+    thin,
+    full
+  };
+
+  constexpr char const *lto_mode_str(lto_mode const mode)
+  {
+    switch(mode)
+    {
+      case lto_mode::none:
+        return "none";
+      case lto_mode::thin:
+        return "thin";
+      case lto_mode::full:
+        return "full";
+      default:
+        return "unknown";
+    }
+  }
+
+  enum class profiler_format : u8
+  {
+    /* Lines of `jank::profile <ns> <kind> <region>`. */
+    text,
+    /* Chrome Trace Event JSON, which can be opened in Perfetto or chrome://tracing. */
+    chrome_trace
+  };
+
+  constexpr char const *profiler_format_str(profiler_format const format)
+  {
+    switch(format)
+    {
+      case profiler_format::text:
+        return "text";
+      case profiler_format::chrome_trace:
+        return "chrome-trace";
+      default:
+        return "unknown";
+    }
+  }
+
   struct options
   {
     /* Runtime. */
     jtl::immutable_string module_path;
     jtl::immutable_string profiler_file{ "jank.profile" };
+    profiler_format profiler_format{ profiler_format::chrome_trace };
     bool profiler_enabled{};
+    /* Where to write the compile report. A path of "-" prints it as a table instead of
+     * writing JSON, while an empty path disables it. */
+    jtl::immutable_string compile_report_file;
+    /* The number of forms which the compile report lists as the slowest. */
+    u32 compile_report_slowest{ 10 };
+    /* Where to write the sampling profiler's folded stacks at exit. Empty means it's not
+     * started until it's asked to be, from jank. */
+    jtl::immutable_string sample_profile_file;
+    u32 sample_rate{ 99 };
+    /* Where to write the busiest allocation sites at exit. A path of "-" prints them. Empty
+     * means the allocation profiler isn't started until it's asked to be, from jank. */
+    jtl::immutable_string alloc_profile_file;
+    /* On average, one box out of this many is sampled. */
+    u32 alloc_sample_interval{ 1024 };
     bool perf_profiling_enabled{};
     bool gc_incremental{};
+    /* The number of threads, including the collecting one, which mark in parallel. Zero
+     * leaves it to the GC, which uses one per hardware thread. */
+    u32 gc_markers{};
+    /* Without this, only pointers to the start of an allocation keep it alive. That makes
+     * marking faster and retains less, but anything which only holds an interior pointer,
+     * such as a view into a GC allocated string, won't keep its allocation alive. */
+    bool gc_all_interior_pointers{ true };
+    /* Sizes are in bytes and zero leaves the GC's default. */
+    usize gc_initial_heap_size{};
+    usize gc_max_heap_size{};
+    /* Higher values collect more often, but with a smaller heap. Zero leaves the GC's
+     * default, which is 3. */
+    u32 gc_free_space_divisor{};
 
     /* Native dependencies. */
     native_vector<jtl::immutable_string> include_dirs;
@@ -86,6 +183,20 @@ namespace jank::util::cli
     u8 codegen_optimization_level{ 0 };
     bool direct_call{};
     compilation_eagerness eagerness{ compilation_eagerness::lazy };
+    var_hoisting hoist_var_derefs{ var_hoisting::checked };
+    /* The max number of analyzed nodes in a fn body for it to be inlined. Zero disables
+     * automatic inlining. */
+    u32 inline_threshold{};
+    /* The number of threads used to emit compiled modules. Zero uses one per hardware
+     * thread. */
+    u32 jobs{};
+    /* With LTO, compiled modules are written as bitcode and optimized across modules
+     * when the executable is linked. */
+    lto_mode lto{ lto_mode::none };
+    /* Instruments AOT compiled code so running it writes a raw profile. */
+    bool profile_generate{};
+    /* An indexed profile, from llvm-profdata, to optimize both JIT and AOT compiled code. */
+    jtl::immutable_string profile_use;
 
     /* Run command. */
     jtl::immutable_string target_file;
@@ -96,6 +207,9 @@ namespace jank::util::cli
     jtl::immutable_string output_filename{ "a.out" };
     /* TODO: Add automatic cleaning when hash changes. */
     jtl::immutable_string output_dir{ "target" };
+    /* Only link the namespaces reachable from the entrypoint and drop whatever each compiled
+     * module's load function doesn't use. */
+    bool tree_shake{};
 
     /* Compile-module command. */
     jtl::immutable_string output_module_filename;
@@ -113,6 +227,16 @@ namespace jank::util::cli
   /* Affects the global opts. */
   jtl::result<void, int> parse_opts(int const argc, char const **argv);
 
+  /* Some GC options need to be set before the GC is initialized, but parsing the opts
+   * allocates with the GC. This picks out only those options, without allocating, and
+   * ignores anything invalid, which `parse_opts` will later report. */
+  void parse_gc_init_opts(int const argc, char const **argv);
+
+  /* Where compiled modules are written. This is the output dir, except with
+   * --profile-generate. Instrumented modules need the profile runtime, which the JIT
+   * doesn't have, so they're kept in a sibling dir which isn't on the module path. */
+  jtl::immutable_string module_output_dir();
+
   /* Takes the CLI args and puts 'em in a vector. */
   native_vector<jtl::immutable_string> parse_into_vector(int const argc, char const **argv);
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <iosfwd>
+#include <string_view>
+
 #include <jtl/immutable_string.hpp>
 #include <jtl/result.hpp>
 
@@ -13,4 +16,8 @@ namespace jank::util
   /* These provide normal escaping/unescaping, with no quoting. */
   jtl::result<jtl::immutable_string, unescape_error> unescape(jtl::immutable_string const &input);
   jtl::immutable_string escape(jtl::immutable_string const &input);
+
+  /* Writes the string as a quoted JSON string, escaping quotes, backslashes, and control
+   * characters. Anything else, including UTF-8, is written as is. */
+  void write_json_string(std::ostream &out, std::string_view const s);
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <jtl/primitive.hpp>
+
+namespace jank::util
+{
+  /* A fixed size pool of worker threads, which run tasks in the order they're submitted.
+   * Workers are registered with the GC, so tasks are free to allocate. Tasks must not
+   * throw; they're expected to report their own failures. */
+  struct thread_pool
+  {
+    using task_type = std::function<void()>;
+
+    /* A thread count of zero uses one thread per hardware thread. */
+    thread_pool(usize thread_count);
+    thread_pool(thread_pool const &) = delete;
+    thread_pool(thread_pool &&) = delete;
+    ~thread_pool();
+
+    thread_pool &operator=(thread_pool const &) = delete;
+    thread_pool &operator=(thread_pool &&) = delete;
+
+    void submit(task_type &&task);
+    /* Blocks until every submitted task has finished. */
+    void wait();
+
+  private:
+    void work();
+
+    std::mutex mutex;
+    std::condition_variable task_ready;
+    std::condition_variable tasks_done;
+    std::deque<task_type> tasks;
+    usize running{};
+    bool stopping{};
+    std::vector<std::thread> threads;
+  };
+}
@@ -142,7 +142,22 @@ namespace jtl
   constexpr ref<T> make_ref(Args &&...args)
   {
     static_assert(sizeof(ref<T>) == sizeof(T *));
-    T *ret{ new(UseGC) T{ jtl::forward<Args>(args)... } };
+    T *ret{};
+    if constexpr(requires { T::pointer_free; })
+    {
+      if constexpr(T::pointer_free)
+      {
+        ret = new(PointerFreeGC) T{ jtl::forward<Args>(args)... };
+      }
+      else
+      {
+        ret = new(UseGC) T{ jtl::forward<Args>(args)... };
+      }
+    }
+    else
+    {
+      ret = new(UseGC) T{ jtl::forward<Args>(args)... };
+    }
     jank_debug_assert(ret);
     return ret;
   }
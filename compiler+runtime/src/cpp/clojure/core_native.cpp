@@ -301,6 +301,12 @@ namespace clojure::core_native
     return {};
   }
 
+  object_ref add_module_dependency(object_ref const module)
+  {
+    __rt_ctx->add_module_dependency(runtime::to_string(module));
+    return {};
+  }
+
   object_ref compile(object_ref const path)
   {
     __rt_ctx->compile_module(runtime::to_string(path)).expect_ok();
@@ -524,6 +530,7 @@ extern "C" void jank_load_clojure_core_native()
   intern_fn("ns-unmap", &core_native::ns_unmap);
   intern_fn("refer", &core_native::refer);
   intern_fn("load-module", &core_native::load_module);
+  intern_fn("add-module-dependency", &core_native::add_module_dependency);
   intern_fn("compile", &core_native::compile);
   intern_fn("eval", &core_native::eval);
   intern_fn("hash-unordered-coll", &core_native::hash_unordered);
@@ -418,6 +418,18 @@ namespace jank::analyze::cpp_util
     return type;
   }
 
+  jtl::ptr<void> i64_type()
+  {
+    static auto const type{ Cpp::GetType("long long") };
+    return type;
+  }
+
+  jtl::ptr<void> f64_type()
+  {
+    static auto const type{ Cpp::GetType("double") };
+    return type;
+  }
+
   jtl::ptr<void> var_type()
   {
     static auto const type{ Cpp::GetTypeFromScope(
@@ -425,6 +437,20 @@ namespace jank::analyze::cpp_util
     return type;
   }
 
+  jtl::ptr<void> integer_ref_type()
+  {
+    static auto const type{ Cpp::GetTypeFromScope(
+      resolve_scope("jank.runtime.obj.integer_ref").expect_ok()) };
+    return type;
+  }
+
+  jtl::ptr<void> real_ref_type()
+  {
+    static auto const type{ Cpp::GetTypeFromScope(
+      resolve_scope("jank.runtime.obj.real_ref").expect_ok()) };
+    return type;
+  }
+
   jtl::ptr<void> persistent_list_ref_type()
   {
     static auto const type{ Cpp::GetTypeFromScope(
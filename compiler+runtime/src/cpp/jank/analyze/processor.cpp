@@ -17,6 +17,7 @@
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/core/munge.hpp>
+#include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/sequence_range.hpp>
 #include <jank/analyze/processor.hpp>
 #include <jank/analyze/step/force_boxed.hpp>
@@ -27,6 +28,8 @@
 #include <jank/util/try.hpp>
 #include <jank/util/string.hpp>
 #include <jank/util/escape.hpp>
+#include <jank/util/arena.hpp>
+#include <jank/profile/sampler.hpp>
 #include <jank/error/analyze.hpp>
 #include <jank/analyze/expr/def.hpp>
 #include <jank/analyze/expr/var_deref.hpp>
@@ -69,6 +72,7 @@
 namespace jank::analyze
 {
   using namespace jank::runtime;
+  using util::make_arena_ref;
 
   /* For every form we analyze, we keep track of its macro-expansion meta. This allows
    * us to keep a stack of macro expansions, which we can then use for error reporting.
@@ -533,12 +537,12 @@ namespace jank::analyze
         }
       }
 
-      return jtl::make_ref<expr::cpp_builtin_operator_call>(position,
-                                                            current_frame,
-                                                            needs_box,
-                                                            op,
-                                                            jtl::move(arg_exprs),
-                                                            found->second.type(arg_types));
+      return make_arena_ref<expr::cpp_builtin_operator_call>(position,
+                                                             current_frame,
+                                                             needs_box,
+                                                             op,
+                                                             jtl::move(arg_exprs),
+                                                             found->second.type(arg_types));
     }
 
     return invalid(arg_types, op_name, val, macro_expansions);
@@ -588,13 +592,13 @@ namespace jank::analyze
           latest_expansion(macro_expansions));
       }
 
-      return jtl::make_ref<expr::cpp_constructor_call>(position,
-                                                       current_frame,
-                                                       needs_box,
-                                                       val->type,
-                                                       nullptr,
-                                                       false,
-                                                       jtl::move(arg_exprs));
+      return make_arena_ref<expr::cpp_constructor_call>(position,
+                                                        current_frame,
+                                                        needs_box,
+                                                        val->type,
+                                                        nullptr,
+                                                        false,
+                                                        jtl::move(arg_exprs));
     }
 
     /* We may set this later, if the operator we choose ends up being a member function. */
@@ -821,40 +825,40 @@ namespace jank::analyze
       }
       if(is_ctor)
       {
-        return jtl::make_ref<expr::cpp_constructor_call>(position,
-                                                         current_frame,
-                                                         needs_box,
-                                                         val->type,
-                                                         match,
-                                                         false,
-                                                         jtl::move(arg_exprs));
+        return make_arena_ref<expr::cpp_constructor_call>(position,
+                                                          current_frame,
+                                                          needs_box,
+                                                          val->type,
+                                                          match,
+                                                          false,
+                                                          jtl::move(arg_exprs));
       }
       else if(is_member_call)
       {
-        return jtl::make_ref<expr::cpp_member_call>(position,
-                                                    current_frame,
-                                                    needs_box,
-                                                    Cpp::GetFunctionReturnType(match),
-                                                    match,
-                                                    jtl::move(arg_exprs));
+        return make_arena_ref<expr::cpp_member_call>(position,
+                                                     current_frame,
+                                                     needs_box,
+                                                     Cpp::GetFunctionReturnType(match),
+                                                     match,
+                                                     jtl::move(arg_exprs));
       }
       else
       {
         auto const return_type{ Cpp::GetFunctionReturnType(match) };
-        auto const source{ jtl::make_ref<expr::cpp_value>(expression_position::value,
-                                                          current_frame,
-                                                          needs_box,
-                                                          /* TODO: Is symbol needed? */
-                                                          try_object<obj::symbol>(val->form),
-                                                          Cpp::GetTypeFromScope(match),
-                                                          match,
-                                                          expr::cpp_value::value_kind::function) };
-        return jtl::make_ref<expr::cpp_call>(position,
-                                             current_frame,
-                                             needs_box,
-                                             return_type,
-                                             source,
-                                             jtl::move(arg_exprs));
+        auto const source{ make_arena_ref<expr::cpp_value>(expression_position::value,
+                                                           current_frame,
+                                                           needs_box,
+                                                           /* TODO: Is symbol needed? */
+                                                           try_object<obj::symbol>(val->form),
+                                                           Cpp::GetTypeFromScope(match),
+                                                           match,
+                                                           expr::cpp_value::value_kind::function) };
+        return make_arena_ref<expr::cpp_call>(position,
+                                              current_frame,
+                                              needs_box,
+                                              return_type,
+                                              source,
+                                              jtl::move(arg_exprs));
       }
     }
 
@@ -909,40 +913,40 @@ namespace jank::analyze
       }
       if(is_ctor)
       {
-        return jtl::make_ref<expr::cpp_constructor_call>(position,
-                                                         current_frame,
-                                                         needs_box,
-                                                         val->type,
-                                                         match,
-                                                         false,
-                                                         jtl::move(arg_exprs));
+        return make_arena_ref<expr::cpp_constructor_call>(position,
+                                                          current_frame,
+                                                          needs_box,
+                                                          val->type,
+                                                          match,
+                                                          false,
+                                                          jtl::move(arg_exprs));
       }
       else if(is_member_call)
       {
-        return jtl::make_ref<expr::cpp_member_call>(position,
-                                                    current_frame,
-                                                    needs_box,
-                                                    Cpp::GetFunctionReturnType(match),
-                                                    match,
-                                                    jtl::move(arg_exprs));
+        return make_arena_ref<expr::cpp_member_call>(position,
+                                                     current_frame,
+                                                     needs_box,
+                                                     Cpp::GetFunctionReturnType(match),
+                                                     match,
+                                                     jtl::move(arg_exprs));
       }
       else
       {
         auto const return_type{ Cpp::GetFunctionReturnType(match) };
-        auto const source{ jtl::make_ref<expr::cpp_value>(expression_position::value,
-                                                          current_frame,
-                                                          needs_box,
-                                                          /* TODO: Is symbol needed? */
-                                                          try_object<obj::symbol>(val->form),
-                                                          Cpp::GetTypeFromScope(match),
-                                                          match,
-                                                          expr::cpp_value::value_kind::function) };
-        return jtl::make_ref<expr::cpp_call>(position,
-                                             current_frame,
-                                             needs_box,
-                                             return_type,
-                                             source,
-                                             jtl::move(arg_exprs));
+        auto const source{ make_arena_ref<expr::cpp_value>(expression_position::value,
+                                                           current_frame,
+                                                           needs_box,
+                                                           /* TODO: Is symbol needed? */
+                                                           try_object<obj::symbol>(val->form),
+                                                           Cpp::GetTypeFromScope(match),
+                                                           match,
+                                                           expr::cpp_value::value_kind::function) };
+        return make_arena_ref<expr::cpp_call>(position,
+                                              current_frame,
+                                              needs_box,
+                                              return_type,
+                                              source,
+                                              jtl::move(arg_exprs));
       }
     }
 
@@ -960,13 +964,13 @@ namespace jank::analyze
                                         runtime::munge(__rt_ctx->unique_namespaced_string())))
     {
       //util::println("using aggregate initialization");
-      return jtl::make_ref<expr::cpp_constructor_call>(position,
-                                                       current_frame,
-                                                       needs_box,
-                                                       val->type,
-                                                       nullptr,
-                                                       true,
-                                                       jtl::move(arg_exprs));
+      return make_arena_ref<expr::cpp_constructor_call>(position,
+                                                        current_frame,
+                                                        needs_box,
+                                                        val->type,
+                                                        nullptr,
+                                                        true,
+                                                        jtl::move(arg_exprs));
     }
 
     /* TODO: Find a better way to render this. */
@@ -1059,7 +1063,7 @@ namespace jank::analyze
       auto const scope{ Cpp::GetScopeFromType(source_type) };
       if(scope)
       {
-        auto const value{ jtl::make_ref<expr::cpp_value>(
+        auto const value{ make_arena_ref<expr::cpp_value>(
           position,
           current_frame,
           needs_box,
@@ -1119,12 +1123,12 @@ namespace jank::analyze
       }
     }
 
-    return jtl::make_ref<expr::cpp_call>(position,
-                                         current_frame,
-                                         needs_box,
-                                         Cpp::GetFunctionReturnTypeFromType(source_type),
-                                         source,
-                                         jtl::move(arg_exprs));
+    return make_arena_ref<expr::cpp_call>(position,
+                                          current_frame,
+                                          needs_box,
+                                          Cpp::GetFunctionReturnTypeFromType(source_type),
+                                          source,
+                                          jtl::move(arg_exprs));
   }
 
   static jtl::result<expression_ref, error_ref>
@@ -1144,26 +1148,26 @@ namespace jank::analyze
         {
           auto const cast_position{ expr->position };
           expr->propagate_position(expression_position::value);
-          return jtl::make_ref<expr::cpp_conversion>(cast_position,
-                                                     expr->frame,
-                                                     expr->needs_box,
-                                                     expected_type,
-                                                     expr_type,
-                                                     conversion_policy::into_object,
-                                                     expr);
+          return make_arena_ref<expr::cpp_conversion>(cast_position,
+                                                      expr->frame,
+                                                      expr->needs_box,
+                                                      expected_type,
+                                                      expr_type,
+                                                      conversion_policy::into_object,
+                                                      expr);
         }
 
       case cpp_util::implicit_conversion_action::from_object:
         {
           auto const cast_position{ expr->position };
           expr->propagate_position(expression_position::value);
-          return jtl::make_ref<expr::cpp_conversion>(cast_position,
-                                                     expr->frame,
-                                                     expr->needs_box,
-                                                     Cpp::GetNonReferenceType(expected_type),
-                                                     expected_type,
-                                                     conversion_policy::from_object,
-                                                     expr);
+          return make_arena_ref<expr::cpp_conversion>(cast_position,
+                                                      expr->frame,
+                                                      expr->needs_box,
+                                                      Cpp::GetNonReferenceType(expected_type),
+                                                      expected_type,
+                                                      conversion_policy::from_object,
+                                                      expr);
         }
       case cpp_util::implicit_conversion_action::cast:
         {
@@ -1171,7 +1175,7 @@ namespace jank::analyze
           expr->propagate_position(expression_position::value);
           auto const bare_param_type{ Cpp::GetNonReferenceType(
             Cpp::GetTypeWithoutCv(expected_type)) };
-          auto const cpp_value{ jtl::make_ref<expr::cpp_value>(
+          auto const cpp_value{ make_arena_ref<expr::cpp_value>(
             cast_position,
             expr->frame,
             false,
@@ -1273,7 +1277,7 @@ namespace jank::analyze
   }
 
   processor::processor()
-    : root_frame{ jtl::make_ref<local_frame>(local_frame::frame_type::root, none) }
+    : root_frame{ make_arena_ref<local_frame>(local_frame::frame_type::root, none) }
   {
   }
 
@@ -1304,6 +1308,294 @@ namespace jank::analyze
     return analyze(fn_list, expression_position::value);
   }
 
+  static obj::persistent_list_ref make_list(native_vector<object_ref> const &forms)
+  {
+    return make_box<obj::persistent_list>(std::in_place, forms.rbegin(), forms.rend());
+  }
+
+  /* Turns an analyzed expression back into a form which can be analyzed within any caller.
+   * Vars are referenced by their qualified names and locals are renamed to unique symbols,
+   * so nothing in the body can be captured by the caller's own locals. Only the handful of
+   * expressions which show up in small helper fns are supported. */
+  static jtl::option<object_ref>
+  inline_form(expression_ref const expr,
+              native_unordered_map<jtl::immutable_string, obj::symbol_ref> const &locals,
+              usize &size)
+  {
+    if(util::cli::opts.inline_threshold < ++size)
+    {
+      return none;
+    }
+
+    static auto const quote_sym{ make_box<obj::symbol>("quote") };
+    static auto const var_sym{ make_box<obj::symbol>("var") };
+    static auto const if_sym{ make_box<obj::symbol>("if") };
+    static auto const do_sym{ make_box<obj::symbol>("do") };
+    static auto const let_sym{ make_box<obj::symbol>("let*") };
+
+    switch(expr->kind)
+    {
+      case expression_kind::primitive_literal:
+        return make_list(
+          { quote_sym, static_ref_cast<expr::primitive_literal>(expr)->data });
+      case expression_kind::var_deref:
+        {
+          auto const var{ static_ref_cast<expr::var_deref>(expr)->var };
+          return make_box<obj::symbol>(var->n->name->name, var->name->name);
+        }
+      case expression_kind::var_ref:
+        {
+          auto const var{ static_ref_cast<expr::var_ref>(expr)->var };
+          return make_list({ var_sym, make_box<obj::symbol>(var->n->name->name, var->name->name) });
+        }
+      case expression_kind::local_reference:
+        {
+          auto const found{ locals.find(static_ref_cast<expr::local_reference>(expr)->name->name) };
+          if(found == locals.end())
+          {
+            return none;
+          }
+          return found->second;
+        }
+      case expression_kind::call:
+        {
+          auto const typed{ static_ref_cast<expr::call>(expr) };
+          /* Packed args would need to be unpacked again. */
+          if(runtime::max_params < typed->arg_exprs.size())
+          {
+            return none;
+          }
+
+          native_vector<object_ref> forms;
+          auto const source{ inline_form(typed->source_expr, locals, size) };
+          if(source.is_none())
+          {
+            return none;
+          }
+          forms.emplace_back(source.unwrap());
+          for(auto const &arg : typed->arg_exprs)
+          {
+            auto const arg_form{ inline_form(arg, locals, size) };
+            if(arg_form.is_none())
+            {
+              return none;
+            }
+            forms.emplace_back(arg_form.unwrap());
+          }
+          return make_list(forms);
+        }
+      case expression_kind::vector:
+        {
+          runtime::detail::native_transient_vector values;
+          for(auto const &value : static_ref_cast<expr::vector>(expr)->data_exprs)
+          {
+            auto const value_form{ inline_form(value, locals, size) };
+            if(value_form.is_none())
+            {
+              return none;
+            }
+            values.push_back(value_form.unwrap());
+          }
+          return make_box<obj::persistent_vector>(values.persistent());
+        }
+      case expression_kind::if_:
+        {
+          auto const typed{ static_ref_cast<expr::if_>(expr) };
+          native_vector<object_ref> forms{ if_sym };
+          auto const condition{ inline_form(typed->condition, locals, size) };
+          auto const then{ inline_form(typed->then, locals, size) };
+          if(condition.is_none() || then.is_none())
+          {
+            return none;
+          }
+          forms.emplace_back(condition.unwrap());
+          forms.emplace_back(then.unwrap());
+          if(typed->else_.is_some())
+          {
+            auto const else_{ inline_form(typed->else_.unwrap(), locals, size) };
+            if(else_.is_none())
+            {
+              return none;
+            }
+            forms.emplace_back(else_.unwrap());
+          }
+          return make_list(forms);
+        }
+      case expression_kind::do_:
+        {
+          native_vector<object_ref> forms{ do_sym };
+          for(auto const &value : static_ref_cast<expr::do_>(expr)->values)
+          {
+            auto const value_form{ inline_form(value, locals, size) };
+            if(value_form.is_none())
+            {
+              return none;
+            }
+            forms.emplace_back(value_form.unwrap());
+          }
+          return make_list(forms);
+        }
+      case expression_kind::let:
+        {
+          auto const typed{ static_ref_cast<expr::let>(expr) };
+          if(typed->loop_kind != expr::let::loop_kind::none)
+          {
+            return none;
+          }
+
+          /* Each binding can see the ones before it, but none of them leak out of the let. */
+          auto scoped_locals{ locals };
+          runtime::detail::native_transient_vector bindings;
+          for(auto const &pair : typed->pairs)
+          {
+            auto const value_form{ inline_form(pair.second, scoped_locals, size) };
+            if(value_form.is_none())
+            {
+              return none;
+            }
+            auto const unique{ make_box<obj::symbol>(
+              __rt_ctx->unique_string(pair.first->name->name)) };
+            scoped_locals.insert_or_assign(pair.first->name->name, unique);
+            bindings.push_back(unique);
+            bindings.push_back(value_form.unwrap());
+          }
+
+          auto const body{ inline_form(typed->body, scoped_locals, size) };
+          if(body.is_none())
+          {
+            return none;
+          }
+          return make_list(
+            { let_sym, make_box<obj::persistent_vector>(bindings.persistent()), body.unwrap() });
+        }
+      default:
+        return none;
+    }
+  }
+
+  static jtl::option<inline_fn>
+  build_inline_fn(obj::symbol_ref const qualified_sym, expression_ref const value)
+  {
+    if(value->kind != expression_kind::function)
+    {
+      return none;
+    }
+
+    static auto const dynamic_kw{ __rt_ctx->intern_keyword("dynamic").expect_ok() };
+    static auto const redef_kw{ __rt_ctx->intern_keyword("redef").expect_ok() };
+    static auto const no_inline_kw{ __rt_ctx->intern_keyword("no-inline").expect_ok() };
+    for(auto const kw : { dynamic_kw, redef_kw, no_inline_kw })
+    {
+      if(truthy(get(qualified_sym->meta, kw)))
+      {
+        return none;
+      }
+    }
+
+    auto const fn{ static_ref_cast<expr::function>(value) };
+    if(!fn->captures().empty())
+    {
+      return none;
+    }
+
+    inline_fn ret;
+    for(auto const &arity : fn->arities)
+    {
+      if(arity.fn_ctx->is_variadic || arity.fn_ctx->is_recur_recursive
+         || arity.fn_ctx->is_named_recursive)
+      {
+        return none;
+      }
+
+      native_unordered_map<jtl::immutable_string, obj::symbol_ref> locals;
+      runtime::detail::native_transient_vector params;
+      for(auto const &param : arity.params)
+      {
+        auto const unique{ make_box<obj::symbol>(__rt_ctx->unique_string(param->name)) };
+        locals.insert_or_assign(param->name, unique);
+        params.push_back(unique);
+      }
+
+      usize size{};
+      auto const body{ inline_form(arity.body, locals, size) };
+      if(body.is_none())
+      {
+        return none;
+      }
+      ret.arities.emplace(
+        arity.params.size(),
+        inline_fn::arity{ make_box<obj::persistent_vector>(params.persistent()), body.unwrap() });
+    }
+
+    return ret;
+  }
+
+  /* With --inline-threshold, small fns which don't close over anything are inlined into
+   * their callers, unless they're marked ^:no-inline, ^:redef, or ^:dynamic. Every def
+   * replaces what we knew about the var, so redefining a fn only affects later callers. */
+  static void register_inline_fn(var_ref const var,
+                                 obj::symbol_ref const qualified_sym,
+                                 expression_ref const value)
+  {
+    jtl::option<inline_fn> inlined;
+    if(util::cli::opts.inline_threshold != 0)
+    {
+      inlined = build_inline_fn(qualified_sym, value);
+    }
+
+    auto const locked_inline_fns{ __rt_ctx->inline_fns.wlock() };
+    if(inlined.is_some())
+    {
+      locked_inline_fns->insert_or_assign(var, jtl::move(inlined.unwrap()));
+    }
+    else
+    {
+      locked_inline_fns->erase(var);
+    }
+  }
+
+  /* Builds `(let* [p1 a1 ... pn an] body)` for a call to an inlinable fn. Callers which
+   * inline a fn from another module now depend on that module, since changing the fn
+   * means the caller must be compiled again. */
+  static jtl::option<object_ref>
+  inline_call_form(var_ref const var, obj::persistent_list_ref const o, usize const arg_count)
+  {
+    if(util::cli::opts.inline_threshold == 0 || var->dynamic.load())
+    {
+      return none;
+    }
+
+    static auto const let_sym{ make_box<obj::symbol>("let*") };
+    runtime::detail::native_transient_vector bindings;
+    object_ref body;
+    {
+      auto const locked_inline_fns{ __rt_ctx->inline_fns.rlock() };
+      auto const found{ locked_inline_fns->find(var) };
+      if(found == locked_inline_fns->end())
+      {
+        return none;
+      }
+      auto const arity{ found->second.arities.find(arg_count) };
+      if(arity == found->second.arities.end())
+      {
+        return none;
+      }
+
+      auto it(o->data.rest());
+      for(auto const param : arity->second.params->data)
+      {
+        bindings.push_back(param);
+        bindings.push_back(it.first().unwrap());
+        it = it.rest();
+      }
+      body = arity->second.body;
+    }
+
+    __rt_ctx->add_module_dependency(var->n->name->name);
+
+    return make_list({ let_sym, make_box<obj::persistent_vector>(bindings.persistent()), body });
+  }
+
   processor::expression_result
   processor::analyze_def(runtime::obj::persistent_list_ref const l,
                          local_frame_ptr const current_frame,
@@ -1381,6 +1673,7 @@ namespace jank::analyze
       value_expr = some(value_result.expect_ok());
 
       vars.insert_or_assign(var_res.expect_ok(), value_expr.unwrap());
+      register_inline_fn(var_res.expect_ok(), qualified_sym, value_expr.unwrap());
     }
 
     if(has_docstring)
@@ -1399,7 +1692,7 @@ namespace jank::analyze
       qualified_sym = qualified_sym->with_meta(meta_with_doc);
     }
 
-    return jtl::make_ref<expr::def>(position, current_frame, true, qualified_sym, value_expr);
+    return make_arena_ref<expr::def>(position, current_frame, true, qualified_sym, value_expr);
   }
 
   processor::expression_result
@@ -1539,15 +1832,15 @@ namespace jank::analyze
 
     auto pairs{ keys_exprs.expect_ok() };
 
-    return jtl::make_ref<expr::case_>(position,
-                                      current_frame,
-                                      needs_box,
-                                      value_expr.expect_ok(),
-                                      shift->data,
-                                      mask->data,
-                                      default_expr.expect_ok(),
-                                      std::move(pairs.keys),
-                                      std::move(pairs.exprs));
+    return make_arena_ref<expr::case_>(position,
+                                       current_frame,
+                                       needs_box,
+                                       value_expr.expect_ok(),
+                                       shift->data,
+                                       mask->data,
+                                       default_expr.expect_ok(),
+                                       std::move(pairs.keys),
+                                       std::move(pairs.exprs));
   }
 
   processor::expression_result
@@ -1618,11 +1911,11 @@ namespace jank::analyze
         unwrapped_local.binding->has_unboxed_usage = true;
       }
 
-      return jtl::make_ref<expr::local_reference>(position,
-                                                  current_frame,
-                                                  needs_box,
-                                                  sym,
-                                                  unwrapped_local.binding);
+      return make_arena_ref<expr::local_reference>(position,
+                                                   current_frame,
+                                                   needs_box,
+                                                   sym,
+                                                   unwrapped_local.binding);
     }
 
     /* If it's not a local and it matches a fn's name, we're dealing with a
@@ -1635,7 +1928,7 @@ namespace jank::analyze
 
       unwrapped_named_recursion.fn_frame->fn_ctx->is_named_recursive = true;
 
-      return jtl::make_ref<expr::recursion_reference>(
+      return make_arena_ref<expr::recursion_reference>(
         position,
         current_frame,
         needs_box,
@@ -1663,7 +1956,7 @@ namespace jank::analyze
         latest_expansion(macro_expansions));
     }
 
-    return jtl::make_ref<expr::var_deref>(position, current_frame, true, qualified_sym, var);
+    return make_arena_ref<expr::var_deref>(position, current_frame, true, qualified_sym, var);
   }
 
   jtl::result<expr::function_arity, error_ref>
@@ -1694,7 +1987,7 @@ namespace jank::analyze
     context::binding_scope const _{ runtime::obj::persistent_hash_map::create_unique(
       std::make_pair(__rt_ctx->no_recur_var, runtime::jank_false)) };
 
-    auto frame{ jtl::make_ref<local_frame>(local_frame::frame_type::fn, current_frame) };
+    auto frame{ make_arena_ref<local_frame>(local_frame::frame_type::fn, current_frame) };
 
     native_vector<runtime::obj::symbol_ref> param_symbols;
     param_symbols.reserve(params->data.size());
@@ -1776,12 +2069,12 @@ namespace jank::analyze
         latest_expansion(macro_expansions));
     }
 
-    auto fn_ctx(jtl::make_ref<expr::function_context>());
+    auto fn_ctx(make_arena_ref<expr::function_context>());
     fn_ctx->name = name;
     fn_ctx->is_variadic = is_variadic;
     fn_ctx->param_count = param_symbols.size();
     frame->fn_ctx = fn_ctx;
-    auto body_do{ jtl::make_ref<expr::do_>(expression_position::tail, frame, true) };
+    auto body_do{ make_arena_ref<expr::do_>(expression_position::tail, frame, true) };
     usize const form_count{ list->count() - 1 };
     usize i{};
     for(auto const &item : list->data.rest())
@@ -1969,18 +2262,26 @@ namespace jank::analyze
       }
     }
 
-    auto const meta(runtime::obj::persistent_hash_map::create_unique(std::make_pair(
-      __rt_ctx->intern_keyword("name").expect_ok(),
-      make_box(
-        runtime::obj::symbol{ runtime::__rt_ctx->current_ns()->to_string(), name }.to_string()))));
+    auto const qualified_name{
+      runtime::obj::symbol{ runtime::__rt_ctx->current_ns()->to_string(), name }.to_string()
+    };
+    auto const meta(runtime::obj::persistent_hash_map::create_unique(
+      std::make_pair(__rt_ctx->intern_keyword("name").expect_ok(), make_box(qualified_name))));
 
-    auto ret(jtl::make_ref<expr::function>(position,
-                                           current_frame,
-                                           true,
-                                           name,
-                                           unique_name,
-                                           native_vector<expr::function_arity>{},
-                                           meta));
+    /* The sampling profiler only sees the linkage names of compiled fns, so we tell it
+     * which fn each one is. This happens whether or not a profiler is running, so fns
+     * compiled before one starts still get their names. */
+    profile::sampler::register_jank_fn(runtime::munge(unique_name),
+                                       qualified_name,
+                                       meta_source(full_list->meta));
+
+    auto ret(make_arena_ref<expr::function>(position,
+                                            current_frame,
+                                            true,
+                                            name,
+                                            unique_name,
+                                            native_vector<expr::function_arity>{},
+                                            meta));
 
     /* Assert that arities are unique. Lazy implementation, but N is small anyway. */
     for(auto base(arities.begin()); base != arities.end(); ++base)
@@ -2013,6 +2314,61 @@ namespace jank::analyze
     return ret;
   }
 
+  /* A loop binding can be unboxed into a long or a double by hinting its symbol with
+   * `^long` or `^double`. */
+  static jtl::ptr<void> loop_binding_hint(obj::symbol_ref const sym)
+  {
+    static auto const tag_kw{ __rt_ctx->intern_keyword("tag").expect_ok() };
+    static auto const long_sym{ make_box<obj::symbol>("long") };
+    static auto const double_sym{ make_box<obj::symbol>("double") };
+
+    auto const tag{ get(sym->meta, tag_kw) };
+    if(equal(tag, long_sym))
+    {
+      return cpp_util::i64_type();
+    }
+    else if(equal(tag, double_sym))
+    {
+      return cpp_util::f64_type();
+    }
+    return nullptr;
+  }
+
+  static jtl::ptr<void> bare_canonical_type(jtl::ptr<void> const type)
+  {
+    return Cpp::GetCanonicalType(Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(type)));
+  }
+
+  /* Without a hint, a loop binding which starts out as a boxed integer or real is
+   * inferred to be an unboxed long or double. */
+  static jtl::ptr<void> inferred_loop_binding_type(jtl::ptr<void> const type)
+  {
+    auto const bare{ bare_canonical_type(type) };
+    if(bare == bare_canonical_type(cpp_util::integer_ref_type()))
+    {
+      return cpp_util::i64_type();
+    }
+    else if(bare == bare_canonical_type(cpp_util::real_ref_type()))
+    {
+      return cpp_util::f64_type();
+    }
+    return nullptr;
+  }
+
+  /* Whether a recur arg of the specified type keeps an inferred binding of the same kind
+   * of number. If not, the binding needs to be boxed. */
+  static bool is_unboxable_into(jtl::ptr<void> const arg_type, jtl::ptr<void> const binding_type)
+  {
+    auto const bare{ bare_canonical_type(arg_type) };
+    if(binding_type == cpp_util::i64_type())
+    {
+      return (Cpp::IsIntegral(bare) && bare != bare_canonical_type(cpp_util::bool_type()))
+        || bare == bare_canonical_type(cpp_util::integer_ref_type());
+    }
+    return bare == bare_canonical_type(cpp_util::f64_type())
+      || bare == bare_canonical_type(cpp_util::real_ref_type());
+  }
+
   processor::expression_result
   processor::analyze_recur(runtime::obj::persistent_list_ref const list,
                            local_frame_ptr const current_frame,
@@ -2087,13 +2443,32 @@ namespace jank::analyze
       }
 
       jtl::ptr<void> expected_type{ cpp_util::untyped_object_ref_type() };
+      using binding_state = loop_unboxing::binding_state;
+      auto const unboxing_state{ (is_loop && loop_unboxing_details
+                                  && arg_index < loop_unboxing_details->bindings.size())
+                                   ? loop_unboxing_details->bindings[arg_index]
+                                   : binding_state::none };
       if(is_loop)
       {
         /* Loop bindings are mutable. If they start as typed objects, we have no idea what
          * kind of object they'll end up as, so we need to type erase. */
         expected_type
           = cpp_util::mutable_type(loop_details.unwrap()->pairs[arg_index].second->get_type());
+      }
 
+      if(unboxing_state == binding_state::inferred
+         && !is_unboxable_into(cpp_util::expression_type(arg_expr.expect_ok()), expected_type))
+      {
+        /* This recur doesn't keep the binding's number type, so the binding needs to be
+         * boxed after all. The loop will be analyzed again, so what we build here is only
+         * enough to finish this pass. */
+        loop_unboxing_details->bindings[arg_index] = binding_state::boxed;
+        loop_unboxing_details->needs_reanalysis = true;
+        expected_type = cpp_util::untyped_object_ref_type();
+      }
+      else if(is_loop && unboxing_state != binding_state::hinted
+              && unboxing_state != binding_state::inferred)
+      {
         /* Check if op = can be used, since we'll be using it to update the loop values. */
         auto const op_equal_sym{ make_box<obj::symbol>("cpp", "=") };
         auto const op_equal_call{ analyze_call(
@@ -2137,13 +2512,13 @@ namespace jank::analyze
       fn_ctx.unwrap()->is_recur_recursive = true;
     }
 
-    return jtl::make_ref<expr::recur>(position,
-                                      current_frame,
-                                      true,
-                                      make_box<runtime::obj::persistent_list>(list->data.rest()),
-                                      std::move(arg_exprs),
-                                      std::move(op_equal_exprs),
-                                      is_loop ? some(loop_details.unwrap()) : none);
+    return make_arena_ref<expr::recur>(position,
+                                       current_frame,
+                                       true,
+                                       make_box<runtime::obj::persistent_list>(list->data.rest()),
+                                       std::move(arg_exprs),
+                                       std::move(op_equal_exprs),
+                                       is_loop ? some(loop_details.unwrap()) : none);
   }
 
   processor::expression_result
@@ -2190,7 +2565,7 @@ namespace jank::analyze
       ret.values.emplace_back(nil.expect_ok());
     }
 
-    return jtl::make_ref<expr::do_>(std::move(ret));
+    return make_arena_ref<expr::do_>(std::move(ret));
   }
 
   processor::expression_result
@@ -2230,12 +2605,12 @@ namespace jank::analyze
         ->add_usage(read::parse::reparse_nth(o, 1));
     }
 
-    auto frame{ jtl::make_ref<local_frame>(local_frame::frame_type::let, current_frame) };
-    auto ret{ jtl::make_ref<expr::let>(
+    auto frame{ make_arena_ref<local_frame>(local_frame::frame_type::let, current_frame) };
+    auto ret{ make_arena_ref<expr::let>(
       position,
       frame,
       needs_box,
-      jtl::make_ref<expr::do_>(position, frame, needs_box, native_vector<expression_ref>{})) };
+      make_arena_ref<expr::do_>(position, frame, needs_box, native_vector<expression_ref>{})) };
 
     static auto const loop_kw{ make_box<obj::symbol>("loop*") };
     if(loop_details.is_some() && runtime::equal(o->first(), loop_kw))
@@ -2274,16 +2649,53 @@ namespace jank::analyze
       /* We need to have a value for every binding, so convert void to nil. */
       if(Cpp::IsVoid(expr_type))
       {
-        value_expr = jtl::make_ref<expr::cpp_conversion>(value_expr->position,
-                                                         value_expr->frame,
-                                                         value_expr->needs_box,
-                                                         cpp_util::untyped_object_ref_type(),
-                                                         expr_type,
-                                                         conversion_policy::into_object,
-                                                         value_expr);
+        value_expr = make_arena_ref<expr::cpp_conversion>(value_expr->position,
+                                                          value_expr->frame,
+                                                          value_expr->needs_box,
+                                                          cpp_util::untyped_object_ref_type(),
+                                                          expr_type,
+                                                          conversion_policy::into_object,
+                                                          value_expr);
         expr_type = cpp_util::untyped_object_ref_type();
       }
 
+      /* The loop's own bindings may be unboxed. */
+      if(loop_unboxing_details && loop_details.is_some() && loop_details.unwrap().data == ret.data)
+      {
+        using binding_state = loop_unboxing::binding_state;
+        auto &bindings{ loop_unboxing_details->bindings };
+        if(bindings.size() < binding_parts / 2)
+        {
+          bindings.resize(binding_parts / 2, binding_state::none);
+        }
+
+        auto &state{ bindings[i / 2] };
+        jtl::ptr<void> unboxed_type{};
+        if(state != binding_state::boxed)
+        {
+          unboxed_type = loop_binding_hint(sym);
+          state = binding_state::hinted;
+          if(!unboxed_type)
+          {
+            unboxed_type = inferred_loop_binding_type(expr_type);
+            state = unboxed_type ? binding_state::inferred : binding_state::none;
+          }
+        }
+
+        if(unboxed_type)
+        {
+          auto const converted{
+            apply_implicit_conversion(value_expr, expr_type, unboxed_type, macro_expansions)
+          };
+          if(converted.is_err())
+          {
+            return converted.expect_err();
+          }
+          value_expr = converted.expect_ok();
+          expr_type = unboxed_type;
+        }
+      }
+
       /* Loop bindings are mutable, so if we have a typed object, force it to be untyped since
        * we have no idea what type it'll be assigned to later on. For example, you might start
        * with an empty array map, but then assoc some stuff on and get a hash map afterward. */
@@ -2477,8 +2889,33 @@ namespace jank::analyze
     /* When we analyze a loop, we actually just set a flag and then analyze a let.
      * The flag is setting `loop_details` to `some`, which conveys that we're in a loop. */
     auto const old_loop_details{ loop_details };
+    auto const old_loop_unboxing_details{ loop_unboxing_details };
+    loop_unboxing unboxing;
+
+    /* Without this, every pass over an outer loop would redo every pass over the loops
+     * within it, so the passes would multiply with each level of nesting. */
+    jtl::option<usize> nested_index;
+    if(old_loop_unboxing_details)
+    {
+      auto &parent{ *old_loop_unboxing_details };
+      if(parent.next_nested == parent.nested_bindings.size())
+      {
+        parent.nested_bindings.emplace_back();
+      }
+      nested_index = parent.next_nested++;
+      unboxing.bindings = parent.nested_bindings[nested_index.unwrap()];
+    }
+
     loop_details = some(nullptr);
-    util::scope_exit const finally{ [&]() { loop_details = old_loop_details; } };
+    loop_unboxing_details = &unboxing;
+    util::scope_exit const finally{ [&]() {
+      loop_details = old_loop_details;
+      loop_unboxing_details = old_loop_unboxing_details;
+      if(nested_index.is_some())
+      {
+        old_loop_unboxing_details->nested_bindings[nested_index.unwrap()] = unboxing.bindings;
+      }
+    } };
 
     /* Using recur from this loop is fine, even if we're in a try, since the jump target
      * is this loop. */
@@ -2489,6 +2926,16 @@ namespace jank::analyze
      * tail position, and it can be used within a loop. We then later reset the position
      * of this expression back to what it should be. */
     auto let_res{ analyze_let(list, current_frame, expression_position::tail, fn_ctx, true) };
+
+    /* Each pass which needs reanalysis boxes at least one more binding, so this ends. */
+    while(unboxing.needs_reanalysis)
+    {
+      loop_details = some(nullptr);
+      unboxing.needs_reanalysis = false;
+      unboxing.next_nested = 0;
+      let_res = analyze_let(list, current_frame, expression_position::tail, fn_ctx, true);
+    }
+
     if(let_res.is_err())
     {
       return let_res;
@@ -2619,12 +3066,12 @@ namespace jank::analyze
       else_expr_opt = else_expr.expect_ok();
     }
 
-    return jtl::make_ref<expr::if_>(position,
-                                    current_frame,
-                                    needs_box,
-                                    condition_expr.expect_ok(),
-                                    then_expr.expect_ok(),
-                                    else_expr_opt);
+    return make_arena_ref<expr::if_>(position,
+                                     current_frame,
+                                     needs_box,
+                                     condition_expr.expect_ok(),
+                                     then_expr.expect_ok(),
+                                     else_expr_opt);
   }
 
   processor::expression_result
@@ -2687,11 +3134,11 @@ namespace jank::analyze
         latest_expansion(macro_expansions));
     }
 
-    return jtl::make_ref<expr::var_ref>(position,
-                                        current_frame,
-                                        true,
-                                        found_var->to_qualified_symbol(),
-                                        found_var);
+    return make_arena_ref<expr::var_ref>(position,
+                                         current_frame,
+                                         true,
+                                         found_var->to_qualified_symbol(),
+                                         found_var);
   }
 
   processor::expression_result
@@ -2704,7 +3151,7 @@ namespace jank::analyze
     auto const pop_macro_expansions{ push_macro_expansions(*this, o) };
 
     auto const qualified_sym(__rt_ctx->qualify_symbol(o->to_qualified_symbol()));
-    return jtl::make_ref<expr::var_ref>(position, current_frame, true, qualified_sym, o);
+    return make_arena_ref<expr::var_ref>(position, current_frame, true, qualified_sym, o);
   }
 
   processor::expression_result
@@ -2737,7 +3184,7 @@ namespace jank::analyze
       return arg_expr.expect_err();
     }
 
-    return jtl::make_ref<expr::throw_>(position, current_frame, true, arg_expr.unwrap_move());
+    return make_arena_ref<expr::throw_>(position, current_frame, true, arg_expr.unwrap_move());
   }
 
   processor::expression_result
@@ -2749,11 +3196,12 @@ namespace jank::analyze
   {
     auto const pop_macro_expansions{ push_macro_expansions(*this, list) };
 
-    auto try_frame(jtl::make_ref<local_frame>(local_frame::frame_type::try_, current_frame));
+    auto try_frame(make_arena_ref<local_frame>(local_frame::frame_type::try_, current_frame));
     /* We introduce a new frame so that we can register the sym as a local.
      * It holds the exception value which was caught. */
-    auto finally_frame(jtl::make_ref<local_frame>(local_frame::frame_type::finally, current_frame));
-    auto ret{ jtl::make_ref<expr::try_>(position, try_frame, true, jtl::make_ref<expr::do_>()) };
+    auto finally_frame(
+      make_arena_ref<local_frame>(local_frame::frame_type::finally, current_frame));
+    auto ret{ make_arena_ref<expr::try_>(position, try_frame, true, make_arena_ref<expr::do_>()) };
 
     /* Clojure JVM doesn't support recur across try/catch/finally, so we don't either. */
     context::binding_scope const _(runtime::obj::persistent_hash_map::create_unique(
@@ -2909,7 +3357,7 @@ namespace jank::analyze
 
             bool const is_object{ cpp_util::is_any_object(catch_type) };
             auto catch_frame(
-              jtl::make_ref<local_frame>(local_frame::frame_type::catch_, current_frame));
+              make_arena_ref<local_frame>(local_frame::frame_type::catch_, current_frame));
             catch_frame->locals[catch_sym].emplace_back(catch_sym,
                                                         catch_sym->name,
                                                         none,
@@ -3019,7 +3467,7 @@ namespace jank::analyze
                                        bool const needs_box)
   {
     auto const pop_macro_expansions{ push_macro_expansions(*this, o) };
-    return jtl::make_ref<expr::primitive_literal>(position, current_frame, needs_box, o);
+    return make_arena_ref<expr::primitive_literal>(position, current_frame, needs_box, o);
   }
 
   /* TODO: Test for this. */
@@ -3060,12 +3508,12 @@ namespace jank::analyze
     {
       /* Eval the literal to resolve exprs such as quotes. */
       auto const pre_eval_expr(
-        jtl::make_ref<expr::vector>(position, current_frame, true, std::move(exprs), o->meta));
+        make_arena_ref<expr::vector>(position, current_frame, true, std::move(exprs), o->meta));
       auto const oref(evaluate::eval(pre_eval_expr));
-      return jtl::make_ref<expr::primitive_literal>(position, current_frame, true, oref);
+      return make_arena_ref<expr::primitive_literal>(position, current_frame, true, oref);
     }
 
-    return jtl::make_ref<expr::vector>(position, current_frame, true, std::move(exprs), o->meta);
+    return make_arena_ref<expr::vector>(position, current_frame, true, std::move(exprs), o->meta);
   }
 
   processor::expression_result
@@ -3116,11 +3564,11 @@ namespace jank::analyze
           exprs.emplace_back(k_expr.expect_ok(), v_expr.expect_ok());
         }
 
-        return jtl::make_ref<expr::map>(position,
-                                        current_frame,
-                                        true,
-                                        std::move(exprs),
-                                        typed_o->meta);
+        return make_arena_ref<expr::map>(position,
+                                         current_frame,
+                                         true,
+                                         std::move(exprs),
+                                         typed_o->meta);
       },
       o);
   }
@@ -3163,21 +3611,21 @@ namespace jank::analyze
         if(literal)
         {
           /* Eval the literal to resolve exprs such as quotes. */
-          auto const pre_eval_expr(jtl::make_ref<expr::set>(position,
-                                                            current_frame,
-                                                            true,
-                                                            std::move(exprs),
-                                                            typed_o->meta));
+          auto const pre_eval_expr(make_arena_ref<expr::set>(position,
+                                                             current_frame,
+                                                             true,
+                                                             std::move(exprs),
+                                                             typed_o->meta));
           auto const constant(evaluate::eval(pre_eval_expr));
 
-          return jtl::make_ref<expr::primitive_literal>(position, current_frame, true, constant);
+          return make_arena_ref<expr::primitive_literal>(position, current_frame, true, constant);
         }
 
-        return jtl::make_ref<expr::set>(position,
-                                        current_frame,
-                                        true,
-                                        std::move(exprs),
-                                        typed_o->meta);
+        return make_arena_ref<expr::set>(position,
+                                         current_frame,
+                                         true,
+                                         std::move(exprs),
+                                         typed_o->meta);
       },
       o);
   }
@@ -3228,7 +3676,7 @@ namespace jank::analyze
       if(source->kind == expression_kind::cpp_type)
       {
         auto const type{ llvm::cast<expr::cpp_type>(source.data) };
-        auto const value{ jtl::make_ref<expr::cpp_value>(
+        auto const value{ make_arena_ref<expr::cpp_value>(
           position,
           current_frame,
           needs_box,
@@ -3289,6 +3737,17 @@ namespace jank::analyze
           auto const expanded{ apply_to(actual_fn, o->next()) };
           return analyze(expanded, current_frame, position, fn_ctx, needs_box);
         }
+
+        if(std::ranges::find(inlining_vars, var_deref->var) == inlining_vars.end())
+        {
+          auto const inlined{ inline_call_form(var_deref->var, o, arg_count) };
+          if(inlined.is_some())
+          {
+            inlining_vars.emplace_back(var_deref->var);
+            util::scope_exit const finally{ [&] { inlining_vars.pop_back(); } };
+            return analyze(inlined.unwrap(), current_frame, position, fn_ctx, needs_box);
+          }
+        }
       }
     }
     else
@@ -3306,7 +3765,7 @@ namespace jank::analyze
       if(source->kind == expression_kind::cpp_type)
       {
         auto const type{ llvm::cast<expr::cpp_type>(source.data) };
-        auto const value{ jtl::make_ref<expr::cpp_value>(
+        auto const value{ make_arena_ref<expr::cpp_value>(
           position,
           current_frame,
           needs_box,
@@ -3372,17 +3831,17 @@ namespace jank::analyze
         }
         packed_arg_exprs.emplace_back(arg_expr.expect_ok());
       }
-      arg_exprs.emplace_back(jtl::make_ref<expr::list>(expression_position::value,
-                                                       current_frame,
-                                                       needs_arg_box,
-                                                       std::move(packed_arg_exprs),
-                                                       jank_nil));
+      arg_exprs.emplace_back(make_arena_ref<expr::list>(expression_position::value,
+                                                        current_frame,
+                                                        needs_arg_box,
+                                                        std::move(packed_arg_exprs),
+                                                        jank_nil));
     }
 
     auto const recursion_ref(llvm::dyn_cast<expr::recursion_reference>(source.data));
     if(recursion_ref)
     {
-      return jtl::make_ref<expr::named_recursion>(
+      return make_arena_ref<expr::named_recursion>(
         position,
         current_frame,
         needs_ret_box,
@@ -3392,12 +3851,12 @@ namespace jank::analyze
     }
     else
     {
-      return jtl::make_ref<expr::call>(position,
-                                       current_frame,
-                                       needs_ret_box,
-                                       source.as_ref(),
-                                       std::move(arg_exprs),
-                                       o);
+      return make_arena_ref<expr::call>(position,
+                                        current_frame,
+                                        needs_ret_box,
+                                        source.as_ref(),
+                                        std::move(arg_exprs),
+                                        o);
     }
   }
 
@@ -3421,22 +3880,22 @@ namespace jank::analyze
     {
       if(is_ctor)
       {
-        return jtl::make_ref<expr::cpp_value>(position,
-                                              current_frame,
-                                              needs_box,
-                                              sym,
-                                              Cpp::GetFunctionReturnType(scope),
-                                              scope,
-                                              expr::cpp_value::value_kind::constructor);
+        return make_arena_ref<expr::cpp_value>(position,
+                                               current_frame,
+                                               needs_box,
+                                               sym,
+                                               Cpp::GetFunctionReturnType(scope),
+                                               scope,
+                                               expr::cpp_value::value_kind::constructor);
       }
 
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            Cpp::GetTypeFromScope(scope),
-                                            scope,
-                                            expr::cpp_value::value_kind::function);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             Cpp::GetTypeFromScope(scope),
+                                             scope,
+                                             expr::cpp_value::value_kind::function);
     }
 
     auto type{ Cpp::GetTypeFromScope(scope) };
@@ -3445,13 +3904,13 @@ namespace jank::analyze
      * we can figure out that we're working with a primitive type. */
     if(cpp_util::is_primitive(Cpp::GetCanonicalType(type)) && is_ctor)
     {
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            type,
-                                            scope,
-                                            expr::cpp_value::value_kind::constructor);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             type,
+                                             scope,
+                                             expr::cpp_value::value_kind::constructor);
     }
 
     if(Cpp::IsClass(scope) || Cpp::IsTemplateSpecialization(scope)
@@ -3460,16 +3919,16 @@ namespace jank::analyze
     {
       if(is_ctor)
       {
-        return jtl::make_ref<expr::cpp_value>(position,
-                                              current_frame,
-                                              needs_box,
-                                              sym,
-                                              type,
-                                              scope,
-                                              expr::cpp_value::value_kind::constructor);
+        return make_arena_ref<expr::cpp_value>(position,
+                                               current_frame,
+                                               needs_box,
+                                               sym,
+                                               type,
+                                               scope,
+                                               expr::cpp_value::value_kind::constructor);
       }
 
-      return jtl::make_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
+      return make_arena_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
     }
 
     if(Cpp::IsClassTemplate(scope) && is_ctor)
@@ -3516,18 +3975,18 @@ namespace jank::analyze
 
     if(vk.is_some())
     {
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            type,
-                                            scope,
-                                            vk.unwrap());
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             type,
+                                             scope,
+                                             vk.unwrap());
     }
 
     if(position == expression_position::type || position == expression_position::call)
     {
-      return jtl::make_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
+      return make_arena_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
     }
 
     return error::analyze_invalid_cpp_value(
@@ -3570,26 +4029,26 @@ namespace jank::analyze
       static auto const scope_res{ cpp_util::resolve_scope("std.nullptr_t") };
       auto const scope{ Cpp::GetUnderlyingScope(scope_res.expect_ok()) };
       auto const type{ Cpp::GetTypeFromScope(scope) };
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            type,
-                                            scope,
-                                            expr::cpp_value::value_kind::null);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             type,
+                                             scope,
+                                             expr::cpp_value::value_kind::null);
     }
     else if(name == "true" || name == "false")
     {
       static auto const type{ Cpp::GetType("bool") };
       auto const kind{ (name == "true") ? expr::cpp_value::value_kind::bool_true
                                         : expr::cpp_value::value_kind::bool_false };
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            type,
-                                            nullptr,
-                                            kind);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             type,
+                                             nullptr,
+                                             kind);
     }
 
     auto const op{ cpp_util::match_operator(name) };
@@ -3602,13 +4061,13 @@ namespace jank::analyze
                                                    latest_expansion(macro_expansions));
       }
 
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            nullptr,
-                                            nullptr,
-                                            expr::cpp_value::value_kind::operator_call);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             nullptr,
+                                             nullptr,
+                                             expr::cpp_value::value_kind::operator_call);
     }
 
     if(name.starts_with(".-"))
@@ -3620,13 +4079,13 @@ namespace jank::analyze
                                                    latest_expansion(macro_expansions));
       }
 
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            nullptr,
-                                            nullptr,
-                                            expr::cpp_value::value_kind::member_access);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             nullptr,
+                                             nullptr,
+                                             expr::cpp_value::value_kind::member_access);
     }
     else if(name.starts_with('.'))
     {
@@ -3637,19 +4096,19 @@ namespace jank::analyze
                                                    latest_expansion(macro_expansions));
       }
 
-      return jtl::make_ref<expr::cpp_value>(position,
-                                            current_frame,
-                                            needs_box,
-                                            sym,
-                                            nullptr,
-                                            nullptr,
-                                            expr::cpp_value::value_kind::member_call);
+      return make_arena_ref<expr::cpp_value>(position,
+                                             current_frame,
+                                             needs_box,
+                                             sym,
+                                             nullptr,
+                                             nullptr,
+                                             expr::cpp_value::value_kind::member_call);
     }
 
     if(name == "void")
     {
       auto const type{ Cpp::GetVoidType() };
-      return jtl::make_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
+      return make_arena_ref<expr::cpp_type>(position, current_frame, needs_box, sym, type);
     }
 
     auto const global_type{ cpp_util::resolve_type(name) };
@@ -3659,13 +4118,13 @@ namespace jank::analyze
     {
       if(is_ctor)
       {
-        return jtl::make_ref<expr::cpp_value>(position,
-                                              current_frame,
-                                              needs_box,
-                                              sym,
-                                              global_type,
-                                              nullptr,
-                                              expr::cpp_value::value_kind::constructor);
+        return make_arena_ref<expr::cpp_value>(position,
+                                               current_frame,
+                                               needs_box,
+                                               sym,
+                                               global_type,
+                                               nullptr,
+                                               expr::cpp_value::value_kind::constructor);
       }
 
       if(position != expression_position::type && position != expression_position::call)
@@ -3674,7 +4133,7 @@ namespace jank::analyze
                                                         latest_expansion(macro_expansions));
       }
 
-      return jtl::make_ref<expr::cpp_type>(position, current_frame, needs_box, sym, global_type);
+      return make_arena_ref<expr::cpp_type>(position, current_frame, needs_box, sym, global_type);
     }
 
     auto const scope_res{ cpp_util::resolve_scope(name) };
@@ -3697,13 +4156,13 @@ namespace jank::analyze
       if(literal_value.is_ok())
       {
         auto const &result{ literal_value.expect_ok() };
-        auto const source{ jtl::make_ref<expr::cpp_value>(expression_position::value,
-                                                          current_frame,
-                                                          needs_box,
-                                                          sym,
-                                                          Cpp::GetTypeFromScope(result.fn_scope),
-                                                          result.fn_scope,
-                                                          expr::cpp_value::value_kind::function) };
+        auto const source{ make_arena_ref<expr::cpp_value>(expression_position::value,
+                                                           current_frame,
+                                                           needs_box,
+                                                           sym,
+                                                           Cpp::GetTypeFromScope(result.fn_scope),
+                                                           result.fn_scope,
+                                                           expr::cpp_value::value_kind::function) };
         auto const res{
           build_cpp_call(source, {}, {}, {}, current_frame, position, needs_box, macro_expansions)
         };
@@ -3864,7 +4323,7 @@ namespace jank::analyze
                                           guard_name,
                                           raw_string) };
 
-    return jtl::make_ref<expr::cpp_raw>(position, current_frame, needs_box, guarded_code);
+    return make_arena_ref<expr::cpp_raw>(position, current_frame, needs_box, guarded_code);
   }
 
   processor::expression_result
@@ -3889,11 +4348,11 @@ namespace jank::analyze
       return type_res.expect_err();
     }
 
-    return jtl::make_ref<expr::cpp_type>(expression_position::type,
-                                         current_frame,
-                                         needs_box,
-                                         try_object<obj::symbol>(l->first()),
-                                         type_res.expect_ok());
+    return make_arena_ref<expr::cpp_type>(expression_position::type,
+                                          current_frame,
+                                          needs_box,
+                                          try_object<obj::symbol>(l->first()),
+                                          type_res.expect_ok());
   }
 
   processor::expression_result
@@ -3956,14 +4415,14 @@ namespace jank::analyze
     }
 
     auto const &result{ literal_res.expect_ok() };
-    auto const source{ jtl::make_ref<expr::cpp_value>(expression_position::value,
-                                                      current_frame,
-                                                      false,
-                                                      /* TODO: Is symbol needed? */
-                                                      try_object<obj::symbol>(l->first()),
-                                                      Cpp::GetTypeFromScope(result.fn_scope),
-                                                      result.fn_scope,
-                                                      expr::cpp_value::value_kind::function) };
+    auto const source{ make_arena_ref<expr::cpp_value>(expression_position::value,
+                                                       current_frame,
+                                                       false,
+                                                       /* TODO: Is symbol needed? */
+                                                       try_object<obj::symbol>(l->first()),
+                                                       Cpp::GetTypeFromScope(result.fn_scope),
+                                                       result.fn_scope,
+                                                       expr::cpp_value::value_kind::function) };
     auto const res{
       build_cpp_call(source, {}, {}, {}, current_frame, position, false, macro_expansions)
     };
@@ -4037,7 +4496,7 @@ namespace jank::analyze
             || Cpp::IsImplicitlyConvertible(value_type, type)
             || cpp_util::is_pointer_to_void_conversion(value_type, type))
     {
-      auto const cpp_value{ jtl::make_ref<expr::cpp_value>(
+      auto const cpp_value{ make_arena_ref<expr::cpp_value>(
         position,
         current_frame,
         needs_box,
@@ -4054,23 +4513,23 @@ namespace jank::analyze
     }
     if(cpp_util::is_any_object(type) && cpp_util::is_trait_convertible(value_type))
     {
-      return jtl::make_ref<expr::cpp_conversion>(position,
-                                                 current_frame,
-                                                 needs_box,
-                                                 type,
-                                                 value_type,
-                                                 conversion_policy::into_object,
-                                                 value_expr);
+      return make_arena_ref<expr::cpp_conversion>(position,
+                                                  current_frame,
+                                                  needs_box,
+                                                  type,
+                                                  value_type,
+                                                  conversion_policy::into_object,
+                                                  value_expr);
     }
     if(cpp_util::is_any_object(value_type) && cpp_util::is_trait_convertible(type))
     {
-      return jtl::make_ref<expr::cpp_conversion>(position,
-                                                 current_frame,
-                                                 needs_box,
-                                                 type,
-                                                 type,
-                                                 conversion_policy::from_object,
-                                                 value_expr);
+      return make_arena_ref<expr::cpp_conversion>(position,
+                                                  current_frame,
+                                                  needs_box,
+                                                  type,
+                                                  type,
+                                                  conversion_policy::from_object,
+                                                  value_expr);
     }
 
     return error::analyze_invalid_cpp_cast(
@@ -4148,7 +4607,7 @@ namespace jank::analyze
     /* TODO: Share this with cpp/cast more cleanly? */
     else if(cpp_util::is_constructible(type, value_type))
     {
-      auto const cpp_value{ jtl::make_ref<expr::cpp_value>(
+      auto const cpp_value{ make_arena_ref<expr::cpp_value>(
         position,
         current_frame,
         needs_box,
@@ -4165,11 +4624,11 @@ namespace jank::analyze
     }
     else if(Cpp::IsCStyleConvertible(value_type, type))
     {
-      return jtl::make_ref<expr::cpp_unsafe_cast>(position,
-                                                  current_frame,
-                                                  needs_box,
-                                                  type,
-                                                  value_expr);
+      return make_arena_ref<expr::cpp_unsafe_cast>(position,
+                                                   current_frame,
+                                                   needs_box,
+                                                   type,
+                                                   value_expr);
     }
 
     return error::analyze_invalid_cpp_unsafe_cast(
@@ -4241,11 +4700,11 @@ namespace jank::analyze
         ->add_usage(read::parse::reparse_nth(l, 1));
     }
 
-    return jtl::make_ref<expr::cpp_box>(position,
-                                        current_frame,
-                                        needs_box,
-                                        value_expr,
-                                        object_source(l->first()));
+    return make_arena_ref<expr::cpp_box>(position,
+                                         current_frame,
+                                         needs_box,
+                                         value_expr,
+                                         object_source(l->first()));
   }
 
   processor::expression_result
@@ -4324,12 +4783,12 @@ namespace jank::analyze
         ->add_usage(read::parse::reparse_nth(l, 2));
     }
 
-    return jtl::make_ref<expr::cpp_unbox>(position,
-                                          current_frame,
-                                          needs_box,
-                                          type,
-                                          value_expr,
-                                          object_source(l->first()));
+    return make_arena_ref<expr::cpp_unbox>(position,
+                                           current_frame,
+                                           needs_box,
+                                           type,
+                                           value_expr,
+                                           object_source(l->first()));
   }
 
   processor::expression_result
@@ -4356,7 +4815,7 @@ namespace jank::analyze
     }
 
     auto const type{ type_expr_res.expect_ok() };
-    auto const cpp_value_expr{ jtl::make_ref<expr::cpp_value>(
+    auto const cpp_value_expr{ make_arena_ref<expr::cpp_value>(
       position,
       current_frame,
       needs_box,
@@ -4379,11 +4838,11 @@ namespace jank::analyze
       return value_expr_res.expect_err();
     }
 
-    return jtl::make_ref<expr::cpp_new>(position,
-                                        current_frame,
-                                        needs_box,
-                                        type,
-                                        value_expr_res.expect_ok());
+    return make_arena_ref<expr::cpp_new>(position,
+                                         current_frame,
+                                         needs_box,
+                                         type,
+                                         value_expr_res.expect_ok());
   }
 
   processor::expression_result
@@ -4431,7 +4890,7 @@ namespace jank::analyze
         ->add_usage(read::parse::reparse_nth(l, 1));
     }
 
-    return jtl::make_ref<expr::cpp_delete>(position, current_frame, needs_box, value_expr);
+    return make_arena_ref<expr::cpp_delete>(position, current_frame, needs_box, value_expr);
   }
 
   processor::expression_result
@@ -4540,13 +4999,13 @@ namespace jank::analyze
     }
 
     auto const member_type{ Cpp::GetLValueReferenceType(Cpp::GetTypeFromScope(member_scope)) };
-    return jtl::make_ref<expr::cpp_member_access>(position,
-                                                  current_frame,
-                                                  needs_box,
-                                                  member_type,
-                                                  member_scope,
-                                                  name,
-                                                  obj_expr);
+    return make_arena_ref<expr::cpp_member_access>(position,
+                                                   current_frame,
+                                                   needs_box,
+                                                   member_type,
+                                                   member_scope,
+                                                   name,
+                                                   obj_expr);
   }
 
   processor::expression_result
@@ -4704,12 +5163,12 @@ namespace jank::analyze
         return res.expect_err();
       }
 
-      return jtl::make_ref<expr::cpp_type>(expression_position::type,
-                                           current_frame,
-                                           false,
-                                           /* TODO: Use something better. */
-                                           make_box<obj::symbol>("cpp/dsl"),
-                                           res.expect_ok());
+      return make_arena_ref<expr::cpp_type>(expression_position::type,
+                                            current_frame,
+                                            false,
+                                            /* TODO: Use something better. */
+                                            make_box<obj::symbol>("cpp/dsl"),
+                                            res.expect_ok());
     } };
 
     return runtime::visit_seqable(
@@ -5125,7 +5584,7 @@ namespace jank::analyze
                   object_source(runtime::second(runtime::next(seq))),
                   latest_expansion(macro_expansions));
               }
-              return jtl::make_ref<expr::cpp_type>(
+              return make_arena_ref<expr::cpp_type>(
                 expression_position::type,
                 current_frame,
                 false,
@@ -5156,7 +5615,7 @@ namespace jank::analyze
 
             if(vk.is_some())
             {
-              return jtl::make_ref<expr::cpp_value>(
+              return make_arena_ref<expr::cpp_value>(
                 position,
                 current_frame,
                 false,
@@ -5175,7 +5634,7 @@ namespace jank::analyze
                   object_source(runtime::second(runtime::next(seq))),
                   latest_expansion(macro_expansions));
               }
-              return jtl::make_ref<expr::cpp_type>(
+              return make_arena_ref<expr::cpp_type>(
                 expression_position::type,
                 current_frame,
                 false,
@@ -5257,7 +5716,7 @@ namespace jank::analyze
 
             if(kw == member_ptr)
             {
-              return jtl::make_ref<expr::cpp_type>(
+              return make_arena_ref<expr::cpp_type>(
                 expression_position::type,
                 current_frame,
                 false,
@@ -5265,7 +5724,7 @@ namespace jank::analyze
                 Cpp::GetPointerToMemberType(member_scope));
             }
 
-            return jtl::make_ref<expr::cpp_value>(
+            return make_arena_ref<expr::cpp_value>(
               position,
               current_frame,
               false,
@@ -5352,11 +5811,11 @@ namespace jank::analyze
 
           if(position == expression_position::type)
           {
-            return jtl::make_ref<expr::cpp_type>(expression_position::type,
-                                                 current_frame,
-                                                 false,
-                                                 sym,
-                                                 Cpp::GetTypeFromScope(inst_scope));
+            return make_arena_ref<expr::cpp_type>(expression_position::type,
+                                                  current_frame,
+                                                  false,
+                                                  sym,
+                                                  Cpp::GetTypeFromScope(inst_scope));
           }
 
 
@@ -5382,22 +5841,22 @@ namespace jank::analyze
 
           if(vk.is_some())
           {
-            return jtl::make_ref<expr::cpp_value>(position,
-                                                  current_frame,
-                                                  false,
-                                                  sym,
-                                                  inst_type,
-                                                  inst_scope,
-                                                  vk.unwrap());
+            return make_arena_ref<expr::cpp_value>(position,
+                                                   current_frame,
+                                                   false,
+                                                   sym,
+                                                   inst_type,
+                                                   inst_scope,
+                                                   vk.unwrap());
           }
 
           if(position == expression_position::call)
           {
-            return jtl::make_ref<expr::cpp_type>(expression_position::type,
-                                                 current_frame,
-                                                 false,
-                                                 sym,
-                                                 inst_type);
+            return make_arena_ref<expr::cpp_type>(expression_position::type,
+                                                  current_frame,
+                                                  false,
+                                                  sym,
+                                                  inst_type);
           }
 
           return error::analyze_invalid_cpp_dsl(
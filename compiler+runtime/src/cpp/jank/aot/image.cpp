@@ -0,0 +1,330 @@
+#include <charconv>
+#include <mutex>
+#include <string_view>
+
+#include <jank/aot/image.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/environment.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::aot
+{
+  using namespace jank::runtime;
+
+  /* The image is line based, to match the module index. It looks like this:
+   *
+   *   jank-image 2 <binary version>
+   *   module <name> <fingerprint>
+   *   var <owned> <ns> <name>
+   *   keyword <name>
+   *
+   * Each var and keyword belongs to the module before it, in the order of its slots.
+   * Keywords are given as they're interned, with their ns, if they have one. */
+  static constexpr char const *image_header{ "jank-image 2 " };
+
+  /* FNV-1a, which only needs to be stable within a build. */
+  static u64 fingerprint_of(std::string_view const entries)
+  {
+    u64 hash{ 0xcbf29ce484222325 };
+    for(auto const c : entries)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001b3;
+    }
+    return hash;
+  }
+
+  struct recorded_module
+  {
+    u64 fingerprint{};
+    /* The var and keyword lines of the module, as they're written to the image. */
+    jtl::immutable_string entries;
+  };
+
+  struct loaded_module
+  {
+    u64 fingerprint{};
+    std::string_view entries;
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    std::mutex mutex;
+    native_unordered_map<jtl::immutable_string, recorded_module> recorded;
+    native_unordered_map<jtl::immutable_string, loaded_module> loaded;
+  } images;
+
+  u64 record_module(jtl::immutable_string const &module,
+                    native_vector<image_var> const &vars,
+                    native_vector<jtl::immutable_string> const &keywords)
+  {
+    /* Names are written one per line, so a name with a newline in it can't be in the
+     * image. Its module falls back to interning each var and keyword. */
+    auto const has_newline{ [](jtl::immutable_string const &s) { return s.contains('\n'); } };
+    for(auto const &v : vars)
+    {
+      if(has_newline(v.name))
+      {
+        return 0;
+      }
+    }
+    for(auto const &kw : keywords)
+    {
+      if(has_newline(kw))
+      {
+        return 0;
+      }
+    }
+
+    jtl::string_builder sb;
+    for(auto const &v : vars)
+    {
+      util::format_to(sb, "var {} {} {}\n", v.owned ? 1 : 0, v.ns, v.name);
+    }
+    for(auto const &kw : keywords)
+    {
+      util::format_to(sb, "keyword {}\n", kw);
+    }
+
+    recorded_module rec;
+    rec.entries = sb.release();
+    rec.fingerprint = fingerprint_of({ rec.entries.data(), rec.entries.size() });
+
+    auto const fingerprint{ rec.fingerprint };
+    std::lock_guard const lock{ images.mutex };
+    images.recorded.insert_or_assign(module, std::move(rec));
+    return fingerprint;
+  }
+
+  jtl::immutable_string build_startup_image(native_vector<jtl::immutable_string> const &modules)
+  {
+    jtl::string_builder sb;
+    util::format_to(sb, "{}{}\n", image_header, util::binary_version());
+
+    std::lock_guard const lock{ images.mutex };
+    for(auto const &module : modules)
+    {
+      auto const found{ images.recorded.find(module) };
+      if(found == images.recorded.end())
+      {
+        continue;
+      }
+      util::format_to(sb, "module {} {}\n", module, found->second.fingerprint);
+      sb(found->second.entries);
+    }
+
+    return sb.release();
+  }
+
+  static std::string_view next_line(std::string_view &remaining)
+  {
+    auto const end{ remaining.find('\n') };
+    auto const line{ remaining.substr(0, end) };
+    remaining.remove_prefix(end == std::string_view::npos ? remaining.size() : end + 1);
+    return line;
+  }
+
+  /* Splits off everything up to the next space. */
+  static std::string_view next_word(std::string_view &remaining)
+  {
+    auto const end{ remaining.find(' ') };
+    auto const word{ remaining.substr(0, end) };
+    remaining.remove_prefix(end == std::string_view::npos ? remaining.size() : end + 1);
+    return word;
+  }
+
+  jtl::string_result<void> load_startup_image(jtl::immutable_string_view const &image)
+  {
+    std::string_view remaining{ image };
+    auto const header{ next_line(remaining) };
+    std::string_view const expected_header{ image_header };
+    auto const &version{ util::binary_version() };
+    if(!header.starts_with(expected_header)
+       || header.substr(expected_header.size())
+         != std::string_view{ version.data(), version.size() })
+    {
+      return err("Startup image was built by a different version of jank.");
+    }
+
+    /* Only the modules are indexed here. Their entries are parsed as each one is loaded. */
+    native_unordered_map<jtl::immutable_string, loaded_module> loaded;
+    jtl::immutable_string current;
+    char const *entries_start{};
+    auto const finish_module{ [&](char const * const entries_end) {
+      if(!current.empty())
+      {
+        loaded[current].entries = { entries_start,
+                                    static_cast<usize>(entries_end - entries_start) };
+      }
+    } };
+    while(!remaining.empty())
+    {
+      auto const line_start{ remaining.data() };
+      auto line{ next_line(remaining) };
+      if(!line.starts_with("module "))
+      {
+        continue;
+      }
+      finish_module(line_start);
+
+      line.remove_prefix(std::string_view{ "module " }.size());
+      auto const name{ next_word(line) };
+      u64 fingerprint{};
+      auto const res{ std::from_chars(line.data(), line.data() + line.size(), fingerprint) };
+      if(res.ec != std::errc{})
+      {
+        return err(util::format("Invalid startup image fingerprint for module '{}'.",
+                                jtl::immutable_string{ name.data(), name.size() }));
+      }
+      current = { name.data(), name.size() };
+      loaded[current].fingerprint = fingerprint;
+      entries_start = remaining.data();
+    }
+    finish_module(remaining.data());
+
+    std::lock_guard const lock{ images.mutex };
+    images.loaded = std::move(loaded);
+    return ok();
+  }
+
+  struct parsed_var
+  {
+    std::string_view ns;
+    std::string_view name;
+    bool owned{};
+  };
+
+  /* Interns the given vars, which all belong to the same ns, in a single transient pass
+   * over the ns's var map. */
+  static void restore_ns_vars(native_vector<parsed_var> const &parsed,
+                              native_vector<usize> const &indices,
+                              runtime::var_ref * const * const vars)
+  {
+    auto const &first{ parsed[indices.front()] };
+    auto const n{ __rt_ctx->intern_ns(jtl::immutable_string{ first.ns.data(), first.ns.size() }) };
+
+    /* An owned var which would replace a referred var needs the usual warning, so those
+     * are left for intern_owned_var, once we're done with the lock. */
+    native_vector<usize> replacing;
+    {
+      auto locked_vars{ n->vars.wlock() };
+      auto transient_vars{ (*locked_vars)->data.transient() };
+      for(auto const i : indices)
+      {
+        auto const &v{ parsed[i] };
+        auto const sym{ make_box<obj::symbol>(
+          jtl::immutable_string{ v.name.data(), v.name.size() }) };
+        auto const found{ transient_vars.find(sym) };
+        if(found && found->is_some())
+        {
+          auto const existing{ expect_object<var>(*found) };
+          if(!v.owned || existing->n == n)
+          {
+            new(vars[i]) var_ref{ existing };
+            continue;
+          }
+          replacing.emplace_back(i);
+          continue;
+        }
+
+        auto const created{ make_box<var>(n, sym) };
+        transient_vars.set(sym, created);
+        new(vars[i]) var_ref{ created };
+      }
+      *locked_vars = make_box<obj::persistent_hash_map>(transient_vars.persistent());
+    }
+
+    for(auto const i : replacing)
+    {
+      auto const &v{ parsed[i] };
+      new(vars[i]) var_ref{ n->intern_owned_var(
+        make_box<obj::symbol>(jtl::immutable_string{ v.name.data(), v.name.size() })) };
+    }
+  }
+
+  bool restore_module(jtl::immutable_string const &module,
+                      u64 const fingerprint,
+                      runtime::var_ref * const * const vars,
+                      usize const var_count,
+                      runtime::obj::keyword_ref * const * const keywords,
+                      usize const keyword_count)
+  {
+    std::string_view entries;
+    {
+      std::lock_guard const lock{ images.mutex };
+      auto const found{ images.loaded.find(module) };
+      if(found == images.loaded.end() || found->second.fingerprint != fingerprint)
+      {
+        return false;
+      }
+      entries = found->second.entries;
+    }
+
+    native_vector<parsed_var> parsed_vars;
+    native_vector<std::string_view> parsed_keywords;
+    parsed_vars.reserve(var_count);
+    parsed_keywords.reserve(keyword_count);
+    while(!entries.empty())
+    {
+      auto line{ next_line(entries) };
+      auto const kind{ next_word(line) };
+      if(kind == "var")
+      {
+        auto const owned{ next_word(line) == "1" };
+        auto const ns{ next_word(line) };
+        parsed_vars.push_back({ ns, line, owned });
+      }
+      else if(kind == "keyword")
+      {
+        parsed_keywords.emplace_back(line);
+      }
+    }
+    if(parsed_vars.size() != var_count || parsed_keywords.size() != keyword_count)
+    {
+      return false;
+    }
+
+    /* Vars are grouped by ns, keeping their slot order within each. */
+    native_unordered_map<std::string_view, native_vector<usize>> by_ns;
+    native_vector<std::string_view> ns_order;
+    for(usize i{}; i < parsed_vars.size(); ++i)
+    {
+      auto &indices{ by_ns[parsed_vars[i].ns] };
+      if(indices.empty())
+      {
+        ns_order.emplace_back(parsed_vars[i].ns);
+      }
+      indices.emplace_back(i);
+    }
+    for(auto const &ns : ns_order)
+    {
+      restore_ns_vars(parsed_vars, by_ns[ns], vars);
+    }
+
+    if(keyword_count != 0)
+    {
+      auto locked_keywords{ __rt_ctx->keywords.wlock() };
+      locked_keywords->reserve(locked_keywords->size() + keyword_count);
+      for(usize i{}; i < keyword_count; ++i)
+      {
+        jtl::immutable_string const name{ parsed_keywords[i].data(),
+                                          parsed_keywords[i].size() };
+        auto found{ locked_keywords->find(name) };
+        if(found == locked_keywords->end())
+        {
+          found = locked_keywords
+                    ->emplace(name,
+                              make_box<obj::keyword>(runtime::detail::must_be_interned{}, name))
+                    .first;
+        }
+        new(keywords[i]) obj::keyword_ref{ found->second };
+      }
+    }
+
+    return true;
+  }
+}
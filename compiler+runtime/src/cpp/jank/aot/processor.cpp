@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <fstream>
 #include <vector>
 #include <cstdlib>
@@ -8,7 +9,10 @@
 #include <jank/error/aot.hpp>
 #include <jank/error/system.hpp>
 #include <jank/aot/processor.hpp>
+#include <jank/aot/image.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/truthy.hpp>
 #include <jank/runtime/module/loader.hpp>
 #include <jank/util/cli.hpp>
 #include <jank/util/fmt.hpp>
@@ -27,6 +31,68 @@ namespace jank::aot
     return util::format("{}/{}", util::cli::opts.output_dir, file_path);
   }
 
+  static bool has_keep_meta(object_ref const meta)
+  {
+    static auto const keep_kw{ __rt_ctx->intern_keyword("keep").expect_ok() };
+    return meta.is_some() && truthy(get(meta, keep_kw));
+  }
+
+  static bool has_kept_var(ns_ref const n)
+  {
+    auto const locked_vars{ n->vars.rlock() };
+    for(auto const &entry : (*locked_vars)->data)
+    {
+      auto const v{ expect_object<var>(entry.second) };
+      if(v->n == n && has_keep_meta(v->get_meta()))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* With tree shaking, only the namespaces which the entrypoint module transitively requires
+   * are linked into the executable. Namespaces which are only reached dynamically, such as
+   * through `resolve` or `requiring-resolve`, need ^:keep on either the ns or one of its vars. */
+  static native_vector<ns_ref> program_namespaces(jtl::immutable_string const &module)
+  {
+    auto namespaces{ __rt_ctx->all_ns() };
+    if(!util::cli::opts.tree_shake)
+    {
+      return namespaces;
+    }
+
+    native_vector<jtl::immutable_string> pending{ module };
+    for(auto const n : namespaces)
+    {
+      if(has_keep_meta(n->get_meta()) || has_kept_var(n))
+      {
+        pending.emplace_back(n->name->name);
+      }
+    }
+
+    native_set<jtl::immutable_string> reachable;
+    while(!pending.empty())
+    {
+      auto const current{ pending.back() };
+      pending.pop_back();
+      if(!reachable.emplace(current).second)
+      {
+        continue;
+      }
+
+      auto const locked_dependencies{ __rt_ctx->module_dependencies.rlock() };
+      auto const deps{ locked_dependencies->find(current) };
+      if(deps != locked_dependencies->end())
+      {
+        pending.insert(pending.end(), deps->second.begin(), deps->second.end());
+      }
+    }
+
+    std::erase_if(namespaces, [&](ns_ref const n) { return !reachable.contains(n->name->name); });
+    return namespaces;
+  }
+
   // TODO: Generate an object file instead of a cpp
   static jtl::immutable_string gen_entrypoint(jtl::immutable_string const &module)
   {
@@ -49,12 +115,14 @@ extern "C" void jank_load_jank_compiler_native();
 extern "C" jank_object_ref jank_var_intern_c(char const *, char const *);
 extern "C" jank_object_ref jank_deref(jank_object_ref);
 extern "C" jank_object_ref jank_call2(jank_object_ref, jank_object_ref, jank_object_ref);
+extern "C" void jank_resource_register(char const *name, char const *data, jank_usize size);
 extern "C" void jank_module_register(char const *module, void (*fn)());
 extern "C" void jank_module_set_loaded(char const *module);
+extern "C" void jank_startup_image_load(char const *data, jank_usize size);
 extern "C" jank_object_ref jank_parse_command_line_args(int, char const **);
 )");
 
-    auto const namespaces{ __rt_ctx->all_ns() };
+    auto const namespaces{ program_namespaces(module) };
     for(auto const n : namespaces)
     {
       util::format_to(sb,
@@ -76,11 +144,58 @@ namespace
         )",
                     pch_path.unwrap()));
 
+    /* The JARs on the module path are indexed ahead of time, so the executable doesn't need
+     * to open them all at startup. */
+    auto const module_index_path{ relative_to_cache_dir("module-index") };
+    {
+      std::filesystem::create_directories(util::cli::opts.output_dir.c_str());
+      auto const module_index{ __rt_ctx->module_loader.build_jar_index() };
+      std::ofstream ofs{ module_index_path.c_str(), std::ios::binary | std::ios::trunc };
+      ofs.write(module_index.data(), static_cast<std::streamsize>(module_index.size()));
+    }
+    sb(util::format(R"(
+namespace
+{
+  char const module_index[]
+  {
+    #embed "{}"
+  };
+}
+        )",
+                    std::filesystem::absolute(module_index_path.c_str()).string()));
+
+    /* The image only covers the program's modules. Their load functions use it to fill
+     * their var and keyword slots, rather than interning each one. */
+    auto const startup_image_path{ relative_to_cache_dir("startup-image") };
+    {
+      native_vector<jtl::immutable_string> modules;
+      modules.reserve(namespaces.size());
+      for(auto const n : namespaces)
+      {
+        modules.emplace_back(n->name->name);
+      }
+      auto const startup_image{ aot::build_startup_image(modules) };
+      std::ofstream ofs{ startup_image_path.c_str(), std::ios::binary | std::ios::trunc };
+      ofs.write(startup_image.data(), static_cast<std::streamsize>(startup_image.size()));
+    }
+    sb(util::format(R"(
+namespace
+{
+  char const startup_image[]
+  {
+    #embed "{}"
+  };
+}
+        )",
+                    std::filesystem::absolute(startup_image_path.c_str()).string()));
+
     sb(R"(
 
 int main(int argc, const char** argv)
 {
   auto const fn{ [](int const argc, char const **argv) {
+    jank_resource_register("module-index", module_index, sizeof(module_index));
+    jank_startup_image_load(startup_image, sizeof(startup_image));
     jank_load_clojure_core_native();
     jank_load_clojure_core();
 
@@ -214,6 +329,30 @@ int main(int argc, const char** argv)
       compiler_args.push_back(strdup(util::format("-D{}", define).c_str()));
     }
 
+    switch(util::cli::opts.lto)
+    {
+      case util::cli::lto_mode::none:
+        break;
+      case util::cli::lto_mode::thin:
+        compiler_args.push_back(strdup("-flto=thin"));
+        compiler_args.push_back(strdup("-fuse-ld=lld"));
+        break;
+      case util::cli::lto_mode::full:
+        compiler_args.push_back(strdup("-flto=full"));
+        compiler_args.push_back(strdup("-fuse-ld=lld"));
+        break;
+    }
+
+    if(util::cli::opts.profile_generate)
+    {
+      compiler_args.push_back(strdup("-fprofile-generate"));
+    }
+    if(!util::cli::opts.profile_use.empty())
+    {
+      compiler_args.push_back(
+        strdup(util::format("-fprofile-use={}", util::cli::opts.profile_use).c_str()));
+    }
+
     compiler_args.push_back(strdup("-std=c++20"));
     compiler_args.push_back(strdup("-Wno-c23-extensions"));
     if constexpr(jtl::current_platform == jtl::platform::linux_like)
@@ -265,7 +404,7 @@ int main(int argc, const char** argv)
     }
     std::vector<char const *> compiler_args{ jtl::move(compiler_args_res.expect_ok()) };
 
-    auto const namespaces{ __rt_ctx->all_ns() };
+    auto const namespaces{ program_namespaces(module) };
     for(auto const n : namespaces)
     {
       auto const &mod{ n->name->name };
@@ -276,8 +415,9 @@ int main(int argc, const char** argv)
         continue;
       }
 
-      auto const &module_path{ util::format("{}.o",
-                                            relative_to_cache_dir(module::module_to_path(mod))) };
+      auto const &module_path{ util::format("{}/{}.o",
+                                            util::cli::module_output_dir(),
+                                            module::module_to_path(mod)) };
 
       if(std::filesystem::exists(module_path.c_str()))
       {
@@ -340,6 +480,18 @@ int main(int argc, const char** argv)
       }
     } };
 
+    if(util::cli::opts.tree_shake)
+    {
+      if constexpr(jtl::current_platform == jtl::platform::macos_like)
+      {
+        compiler_args.push_back(strdup("-Wl,-dead_strip"));
+      }
+      else
+      {
+        compiler_args.push_back(strdup("-Wl,--gc-sections"));
+      }
+    }
+
     compiler_args.push_back(strdup("-o"));
     compiler_args.push_back(strdup(util::cli::opts.output_filename.c_str()));
 
@@ -368,7 +520,9 @@ int main(int argc, const char** argv)
     /* TODO: Use runtime::context::get_output_module_name. */
     std::filesystem::path const module_path{
       util::cli::opts.output_module_filename.empty()
-        ? util::format("{}/{}.o", util::cli::opts.output_dir, module::module_to_path(module_name))
+        ? util::format("{}/{}.o",
+                       util::cli::module_output_dir(),
+                       module::module_to_path(module_name))
             .c_str()
         : jtl::immutable_string{ util::cli::opts.output_module_filename }.c_str()
     };
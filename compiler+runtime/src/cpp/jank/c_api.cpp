@@ -24,10 +24,13 @@
 #include <jank/runtime/core/meta.hpp>
 #include <jank/runtime/core/call.hpp>
 #include <jank/aot/resource.hpp>
+#include <jank/aot/image.hpp>
 #include <jank/error/runtime.hpp>
+#include <jank/error/report.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/try.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/fmt/print.hpp>
 
 using namespace jank;
@@ -1020,6 +1023,16 @@ extern "C"
     runtime::__rt_ctx->module_loader.set_is_loaded(module);
   }
 
+  void jank_startup_image_load(char const * const data, jank_usize const size)
+  {
+    /* The image only saves work at startup, so the program can still run without it. */
+    auto const res{ aot::load_startup_image({ data, size }) };
+    if(res.is_err())
+    {
+      error::warn(res.expect_err());
+    }
+  }
+
   int jank_init(int const argc,
                 char const ** const argv,
                 jank_bool const init_default_ctx,
@@ -1050,10 +1063,19 @@ extern "C"
 #endif
 
       /* The GC needs to initialized even before arg parsing, since our native types,
-       * like strings, use the GC for allocations. It can still be configured later. */
-      GC_set_all_interior_pointers(1);
+       * like strings, use the GC for allocations. It can still be configured later, aside
+       * from these options, which are picked out by `parse_gc_init_opts` beforehand. The
+       * GC also reads its GC_* environment variables here, such as GC_MARKERS. */
+      GC_set_all_interior_pointers(util::cli::opts.gc_all_interior_pointers ? 1 : 0);
+      if(util::cli::opts.gc_markers != 0)
+      {
+        GC_set_markers_count(util::cli::opts.gc_markers);
+      }
       GC_init();
       GC_allow_register_threads();
+      /* This only costs a clock read per collection and it lets us report GC pause times,
+       * both in jank.gc and in profiles. */
+      GC_start_performance_measurement();
 
       llvm::llvm_shutdown_obj const Y{};
 
@@ -1,4 +1,5 @@
 #include <jank/codegen/api.hpp>
+#include <jank/aot/image.hpp>
 #include <jank/runtime/context.hpp>
 
 jank::runtime::var_ref _jank_var(char const * const sym)
@@ -60,3 +61,13 @@ jank::runtime::object_ref _jank_read(char const *edn)
 {
   return jank::runtime::__rt_ctx->forcefully_read_string(edn);
 }
+
+bool _jank_image_restore(char const * const module,
+                         jtl::u64 const fingerprint,
+                         jank::runtime::var_ref * const * const vars,
+                         jtl::usize const var_count,
+                         jank::runtime::obj::keyword_ref * const * const keywords,
+                         jtl::usize const keyword_count)
+{
+  return jank::aot::restore_module(module, fingerprint, vars, var_count, keywords, keyword_count);
+}
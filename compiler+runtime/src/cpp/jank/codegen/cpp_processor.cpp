@@ -1,11 +1,13 @@
 #include <CppInterOp/Compatibility.h>
 #include <CppInterOp/CppInterOp.h>
 
+#include <jank/aot/image.hpp>
 #include <jank/analyze/visit.hpp>
 #include <jank/analyze/cpp_util.hpp>
 #include <jank/ir/processor.hpp>
 #include <jank/ir/visit.hpp>
 #include <jank/codegen/cpp_processor.hpp>
+#include <jank/profile/compile_report.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/seq.hpp>
@@ -117,6 +119,8 @@ namespace jank::codegen
     usize block_index{}, instruction_index{};
     native_vector<std::pair<jtl::immutable_string, jtl::immutable_string>> deferred_bindings;
     native_set<ir::identifier> seen_blocks;
+    /* The range of module constants which are registered as GC roots. */
+    ir::identifier first_rooted_constant, last_rooted_constant;
   };
 
   using identifier = ir::identifier;
@@ -194,6 +198,69 @@ namespace jank::codegen
       return meta.is_some() && !is_empty(meta);
     }
 
+    static void gen_real(f64 const r, jtl::string_builder &buffer)
+    {
+      if(std::isinf(r))
+      {
+        util::format_to(buffer, "{}INFINITY", r < 0 ? "-" : "");
+      }
+      else if(std::isnan(r))
+      {
+        util::format_to(buffer, "NAN");
+      }
+      else
+      {
+        util::format_to(buffer, "{}", r);
+      }
+    }
+
+    /* Numbers are pointer free, so module constants for them can be constructed into static
+     * storage within the module instead of on the GC heap. They're never collected and
+     * there's nothing in them for the GC to mark. They're still constructed when the module
+     * is loaded, since objects have vtables. Collections and other composite constants
+     * point into the GC heap, so they're allocated there and rooted as usual. */
+    static bool is_static_constant(object_ref const o)
+    {
+      return o->type == object_type::integer || o->type == object_type::real;
+    }
+
+    /* Module constants need to be GC roots only if nothing else keeps them alive. Nil and
+     * booleans are globals, keywords are held by the context's intern table, and static
+     * constants aren't on the GC heap at all. */
+    static bool needs_gc_root(object_ref const o)
+    {
+      switch(o->type)
+      {
+        case object_type::nil:
+        case object_type::boolean:
+        case object_type::keyword:
+          return false;
+        default:
+          return !is_static_constant(o);
+      }
+    }
+
+    static void gen_static_constant(object_ref const o,
+                                    jtl::immutable_string const &storage,
+                                    jtl::string_builder &buffer)
+    {
+      if(o->type == object_type::integer)
+      {
+        util::format_to(buffer,
+                        "jank::runtime::obj::integer_ref{ new (&{}) jank::runtime::obj::integer{ {} } }",
+                        storage,
+                        expect_object<obj::integer>(o)->data);
+      }
+      else
+      {
+        util::format_to(buffer,
+                        "jank::runtime::obj::real_ref{ new (&{}) jank::runtime::obj::real{ ",
+                        storage);
+        gen_real(expect_object<obj::real>(o)->data, buffer);
+        util::format_to(buffer, " } }");
+      }
+    }
+
     static void gen_constant(object_ref const o, jtl::string_builder &buffer)
     {
       visit_object(
@@ -222,20 +289,7 @@ namespace jank::codegen
           else if constexpr(std::same_as<T, obj::real>)
           {
             util::format_to(buffer, "_jank_real(");
-
-            if(std::isinf(typed_o->data))
-            {
-              util::format_to(buffer, "INFINITY");
-            }
-            else if(std::isnan(typed_o->data))
-            {
-              util::format_to(buffer, "NAN");
-            }
-            else
-            {
-              util::format_to(buffer, "{}", typed_o->data);
-            }
-
+            gen_real(typed_o->data, buffer);
             util::format_to(buffer, ")");
           }
           else if constexpr(std::same_as<T, obj::big_integer>)
@@ -565,6 +619,19 @@ namespace jank::codegen
   {
     b.next_instruction();
     auto const lifted{ lift_var(inst->var, b) };
+    if(inst->version_checked)
+    {
+      /* The version is read before the deref so that a concurrent redefinition will
+       * always be picked up by the next check. */
+      util::format_to(b.body_buffer,
+                      "auto {}_version({}->root_version.load());"
+                      "jank::runtime::object_ref {}({}->deref());",
+                      inst->name,
+                      lifted,
+                      inst->name,
+                      lifted);
+      return inst->name;
+    }
     util::format_to(b.body_buffer, "auto const {}({}->deref());", inst->name, lifted);
     return inst->name;
   }
@@ -882,6 +949,47 @@ namespace jank::codegen
     return inst->name;
   }
 
+  jtl::option<identifier> gen(ir::inst::direct_call_ref const &inst, builder &b)
+  {
+    b.next_instruction();
+
+    auto const fn_name{ util::format("{}_{}", inst->fn_base_name, inst->args.size()) };
+    util::format_to(b.deps_buffer,
+                    "extern \"C\" jank::runtime::object_ref {}(jank::runtime::object_ref const",
+                    fn_name);
+    for(auto const &_ : inst->args)
+    {
+      util::format_to(b.deps_buffer, ", jank::runtime::object_ref");
+    }
+    util::format_to(b.deps_buffer, ");");
+
+    util::format_to(b.body_buffer, "auto const {}({}({}", inst->name, fn_name, inst->fn);
+    for(auto const &arg : inst->args)
+    {
+      util::format_to(b.body_buffer, ", {}", arg);
+    }
+    util::format_to(b.body_buffer, "));");
+    return inst->name;
+  }
+
+  jtl::option<identifier> gen(ir::inst::keyword_get_ref const &inst, builder &b)
+  {
+    b.next_instruction();
+
+    util::format_to(b.body_buffer,
+                    "auto const {}(jank::runtime::{}({}, {}",
+                    inst->name,
+                    (inst->source_is_callee ? "keyword_call" : "keyword_get"),
+                    inst->source,
+                    inst->key);
+    if(inst->fallback.is_some())
+    {
+      util::format_to(b.body_buffer, ", {}", inst->fallback.unwrap());
+    }
+    util::format_to(b.body_buffer, "));");
+    return inst->name;
+  }
+
   jtl::option<identifier> gen(ir::inst::letfn_ref const &inst, builder &b)
   {
     b.next_instruction();
@@ -1000,6 +1108,25 @@ namespace jank::codegen
     }
 
     util::format_to(b.body_buffer, "while(true){");
+
+    /* Hoisted var derefs are refreshed at the start of each iteration if their var has
+     * been redefined or if it has become thread bound. */
+    for(auto const &deref : inst->checked_var_derefs)
+    {
+      auto const lifted{ lift_var(deref.second, b) };
+      util::format_to(b.body_buffer,
+                      "if({}->root_version.load() != {}_version || {}->thread_bound.load()){"
+                      "{}_version = {}->root_version.load();"
+                      "{} = {}->deref(); }",
+                      lifted,
+                      deref.first,
+                      lifted,
+                      deref.first,
+                      lifted,
+                      deref.first,
+                      lifted);
+    }
+
     b.enter_block(inst->loop_block);
     gen_until_jump(inst->merge_block, b);
     util::format_to(b.body_buffer, " break; }");
@@ -1859,6 +1986,9 @@ namespace jank::codegen
 
   generated_cpp gen_cpp(ir::module const &mod)
   {
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::codegen
+    };
     builder b{ &mod, mod.entry_points[0] };
 
     for(auto const &fn_name : mod.entry_points)
@@ -1886,13 +2016,46 @@ namespace jank::codegen
        * a nullptr within them. This isn't normally allowed, but we can't assume we have
        * access to jank_nil when these are initialized because initialization order across
        * C++ translation units is undefined. */
+      /* The constants which need to be GC roots are declared last, so they're contiguous. */
       for(auto const &v : b.module->lifted_constants)
       {
+        if(detail::needs_gc_root(v.second))
+        {
+          continue;
+        }
+
+        if(detail::is_static_constant(v.second))
+        {
+          auto const type{ v.second->type == object_type::integer ? "jank::runtime::obj::integer"
+                                                                  : "jank::runtime::obj::real" };
+          util::format_to(b.module_header_buffer,
+                          "alignas({}) char {}_storage[sizeof({})];",
+                          type,
+                          v.first,
+                          type);
+        }
         util::format_to(b.module_header_buffer,
                         "{} {}{ _jank_null{ } };",
                         get_qualified_type_name(literal_type(v.second)),
                         v.first);
       }
+      for(auto const &v : b.module->lifted_constants)
+      {
+        if(!detail::needs_gc_root(v.second))
+        {
+          continue;
+        }
+
+        util::format_to(b.module_header_buffer,
+                        "{} {}{ _jank_null{ } };",
+                        get_qualified_type_name(literal_type(v.second)),
+                        v.first);
+        if(b.first_rooted_constant.empty())
+        {
+          b.first_rooted_constant = v.first;
+        }
+        b.last_rooted_constant = v.first;
+      }
       for(auto const &v : b.module->lifted_vars)
       {
         util::format_to(b.module_header_buffer,
@@ -1946,6 +2109,60 @@ namespace jank::codegen
                         last->first);
       }
 
+      /* The vars and keywords of the module are recorded for the startup image, in the
+       * order of their slots. When an AOT executable has this same build of the module in
+       * its image, it fills all of the slots at once, rather than interning each one. */
+      native_vector<aot::image_var> image_vars;
+      native_vector<jtl::immutable_string> image_keywords;
+      native_vector<jtl::immutable_string> keyword_slots;
+      for(auto const &v : b.module->lifted_vars)
+      {
+        auto const &qualified{ v.second.qualified_var };
+        auto const slash{ qualified.find('/') };
+        image_vars.push_back({ qualified.substr(0, slash),
+                               qualified.substr(slash + 1),
+                               v.second.owned });
+      }
+      for(auto const &v : b.module->lifted_constants)
+      {
+        if(v.second->type != object_type::keyword)
+        {
+          continue;
+        }
+        auto const kw{ expect_object<obj::keyword>(v.second) };
+        image_keywords.emplace_back(
+          kw->sym->ns.empty() ? kw->sym->name : util::format("{}/{}", kw->sym->ns, kw->sym->name));
+        keyword_slots.emplace_back(v.first);
+      }
+      auto const fingerprint{ aot::record_module(mod.name, image_vars, image_keywords) };
+
+      if(!image_vars.empty())
+      {
+        util::format_to(b.footer_buffer, "jank::runtime::var_ref * const image_vars[]{ ");
+        for(auto const &v : b.module->lifted_vars)
+        {
+          util::format_to(b.footer_buffer, "&{}::{}, ", native_ns, v.first);
+        }
+        util::format_to(b.footer_buffer, "};");
+      }
+      if(!keyword_slots.empty())
+      {
+        util::format_to(b.footer_buffer,
+                        "jank::runtime::obj::keyword_ref * const image_keywords[]{ ");
+        for(auto const &slot : keyword_slots)
+        {
+          util::format_to(b.footer_buffer, "&{}::{}, ", native_ns, slot);
+        }
+        util::format_to(b.footer_buffer, "};");
+      }
+      util::format_to(b.footer_buffer,
+                      R"(if(!_jank_image_restore("{}", {}ull, {}, {}, {}, {})){)",
+                      mod.name,
+                      fingerprint,
+                      image_vars.empty() ? "nullptr" : "image_vars",
+                      image_vars.size(),
+                      keyword_slots.empty() ? "nullptr" : "image_keywords",
+                      keyword_slots.size());
       for(auto const &v : b.module->lifted_vars)
       {
         /* Since global ctors don't run when loading object files, we
@@ -1969,25 +2186,46 @@ namespace jank::codegen
         }
       }
 
-      if(!b.module->lifted_constants.empty())
+      for(auto const &slot : keyword_slots)
+      {
+        auto const kw{ expect_object<obj::keyword>(b.module->lifted_constants.at(slot)) };
+        util::format_to(b.footer_buffer, "new (&{}::{}) auto(", native_ns, slot);
+        detail::gen_constant(kw, b.footer_buffer);
+        util::format_to(b.footer_buffer, ");");
+      }
+
+      /* Image fallback. */
+      util::format_to(b.footer_buffer, "}");
+
+      if(!b.first_rooted_constant.empty())
       {
-        auto const &first{ *b.module->lifted_constants.begin() };
-        auto last{ b.module->lifted_constants.begin() };
-        std::advance(last, b.module->lifted_constants.size() - 1);
         util::format_to(b.footer_buffer,
                         R"(GC_add_roots(&{}::{}, (&{}::{} + 1));)",
                         native_ns,
-                        first.first,
-                        native_ns,
-                        last->first,
+                        b.first_rooted_constant,
                         native_ns,
-                        last->first);
+                        b.last_rooted_constant);
       }
 
       for(auto const &v : b.module->lifted_constants)
       {
+        /* Keywords were filled in along with the vars. */
+        if(v.second->type == object_type::keyword)
+        {
+          continue;
+        }
+
         util::format_to(b.footer_buffer, "new (&{}::{}) auto(", native_ns, v.first);
-        detail::gen_constant(v.second, b.footer_buffer);
+        if(detail::is_static_constant(v.second))
+        {
+          detail::gen_static_constant(v.second,
+                                      util::format("{}::{}_storage", native_ns, v.first),
+                                      b.footer_buffer);
+        }
+        else
+        {
+          detail::gen_constant(v.second, b.footer_buffer);
+        }
         util::format_to(b.footer_buffer, ");");
       }
 
@@ -2002,6 +2240,7 @@ namespace jank::codegen
     }
 
     generated_cpp ret{ b.declaration_str(), b.expression_str() };
+    profile::compile_report::add_generated_cpp(ret.declaration.size());
     //util::println("\n\n{}", util::format_cpp_source(ret.declaration).expect_ok());
     return ret;
   }
@@ -2,6 +2,8 @@
 #include <llvm/Analysis/LoopAnalysisManager.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Passes/StandardInstrumentations.h>
+#include <llvm/Support/PGOOptions.h>
+#include <llvm/Support/VirtualFileSystem.h>
 #include <llvm/Transforms/IPO/Internalize.h>
 #include <llvm/Transforms/IPO/GlobalDCE.h>
 #include <llvm/Transforms/Scalar/GVN.h>
@@ -12,7 +14,7 @@
 
 namespace jank::codegen
 {
-  void optimize(jtl::ref<llvm::Module> const module, jtl::immutable_string const &)
+  void optimize(jtl::ref<llvm::Module> const module, jtl::immutable_string const &module_name)
   {
     llvm::LoopAnalysisManager lam;
     llvm::FunctionAnalysisManager fam;
@@ -26,7 +28,27 @@ namespace jank::codegen
 
     si.registerCallbacks(pic, &mam);
 
-    llvm::PassBuilder pb;
+    /* Only modules being written as objects are instrumented, since the JIT doesn't have
+     * the profile runtime. Their code is a copy of what the JIT runs. */
+    bool const emitting_object{ util::cli::opts.output_target
+                                == util::cli::compilation_target::object };
+    std::optional<llvm::PGOOptions> pgo;
+    if(emitting_object && util::cli::opts.profile_generate)
+    {
+      pgo = llvm::PGOOptions{ "", "", "", "", llvm::vfs::getRealFileSystem(),
+                              llvm::PGOOptions::IRInstr };
+    }
+    else if(!util::cli::opts.profile_use.empty())
+    {
+      pgo = llvm::PGOOptions{ util::cli::opts.profile_use.c_str(),
+                              "",
+                              "",
+                              "",
+                              llvm::vfs::getRealFileSystem(),
+                              llvm::PGOOptions::IRUse };
+    }
+
+    llvm::PassBuilder pb{ nullptr, llvm::PipelineTuningOptions{}, pgo };
     pb.registerModuleAnalyses(mam);
     pb.registerCGSCCAnalyses(cgam);
     pb.registerFunctionAnalyses(fam);
@@ -52,13 +74,41 @@ namespace jank::codegen
         break;
     }
 
-    mpm = pb.buildPerModuleDefaultPipeline(level);
+    /* With LTO, most of the work happens at link time, so we only run the pre-link
+     * pipeline here. */
+    if(!emitting_object || level == llvm::OptimizationLevel::O0)
+    {
+      mpm = pb.buildPerModuleDefaultPipeline(level);
+    }
+    else
+    {
+      switch(util::cli::opts.lto)
+      {
+        case util::cli::lto_mode::thin:
+          mpm = pb.buildThinLTOPreLinkDefaultPipeline(level);
+          break;
+        case util::cli::lto_mode::full:
+          mpm = pb.buildLTOPreLinkDefaultPipeline(level);
+          break;
+        case util::cli::lto_mode::none:
+        default:
+          mpm = pb.buildPerModuleDefaultPipeline(level);
+          break;
+      }
+    }
 
-    //std::string const load_fn{ runtime::module::module_to_load_function(module_name) };
-    //auto const preserve{ [&](llvm::GlobalValue const &GV) { return GV.getName() == load_fn; } };
+    /* When tree shaking, a module's load function is the only way into it, so everything
+     * else can be internalized and whatever the load function doesn't reach gets dropped.
+     * This is only done for object files, since other targets optimize the module which
+     * the JIT is still using. */
+    if(util::cli::opts.tree_shake && emitting_object)
+    {
+      std::string const load_fn{ runtime::module::module_to_load_function(module_name) };
+      auto const preserve{ [&](llvm::GlobalValue const &gv) { return gv.getName() == load_fn; } };
 
-    //mpm.addPass(llvm::InternalizePass(preserve));
-    //mpm.addPass(llvm::GlobalDCEPass());
+      mpm.addPass(llvm::InternalizePass(preserve));
+      mpm.addPass(llvm::GlobalDCEPass());
+    }
 
     mpm.run(*module, mam);
   }
@@ -12,6 +12,7 @@
 #include <jank/error/report.hpp>
 #include <jank/ui/highlight.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/core/meta.hpp>
 #include <jank/runtime/obj/nil.hpp>
@@ -597,6 +598,12 @@ namespace jank::error
 
   void warn(jtl::immutable_string const &msg)
   {
+    if(auto * const capture{ runtime::output_capture::current() })
+    {
+      util::format_to(capture->err, "warning: {}\n", msg);
+      return;
+    }
+
     util::println(stderr,
                   "{}warning:{} {}",
                   jtl::terminal_style::yellow,
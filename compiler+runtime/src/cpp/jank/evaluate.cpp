@@ -16,6 +16,7 @@
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/clang_format.hpp>
+#include <jank/util/arena.hpp>
 #include <jank/analyze/visit.hpp>
 #include <jank/analyze/cpp_util.hpp>
 #include <jank/error/analyze.hpp>
@@ -26,6 +27,7 @@ namespace jank::evaluate
 {
   using namespace jank::runtime;
   using namespace jank::analyze;
+  using util::make_arena_ref;
 
   /* TODO: Move postwalk into the nodes. */
   template <typename T, typename F>
@@ -139,18 +141,18 @@ namespace jank::evaluate
                                             jtl::immutable_string const &name,
                                             native_vector<obj::symbol_ref> params)
   {
-    auto ret{ jtl::make_ref<expr::function>() };
-    auto expr{ make_ref<E>(orig_expr) };
+    auto ret{ make_arena_ref<expr::function>() };
+    auto expr{ make_arena_ref<E>(orig_expr) };
     ret->kind = analyze::expression_kind::function;
     ret->name = name;
     ret->unique_name = __rt_ctx->unique_namespaced_string(ret->name);
     ret->meta = obj::persistent_hash_map::empty();
 
-    auto const frame{ jtl::make_ref<local_frame>(local_frame::frame_type::fn,
-                                                 expr->frame->parent) };
-    auto const fn_ctx{ jtl::make_ref<expr::function_context>() };
+    auto const frame{ make_arena_ref<local_frame>(local_frame::frame_type::fn,
+                                                  expr->frame->parent) };
+    auto const fn_ctx{ make_arena_ref<expr::function_context>() };
     expr::function_arity arity{ jtl::move(params),
-                                jtl::make_ref<expr::do_>(expression_position::tail, frame, true),
+                                make_arena_ref<expr::do_>(expression_position::tail, frame, true),
                                 frame,
                                 fn_ctx };
     expr->frame->parent = arity.frame;
@@ -172,13 +174,13 @@ namespace jank::evaluate
     if(!cpp_util::is_any_object(expr_type))
     {
       jank_debug_assert(cpp_util::is_trait_convertible(expr_type));
-      expr_to_add = jtl::make_ref<expr::cpp_conversion>(expr->position,
-                                                        expr->frame,
-                                                        expr->needs_box,
-                                                        cpp_util::untyped_object_ref_type(),
-                                                        expr_type,
-                                                        conversion_policy::into_object,
-                                                        expr);
+      expr_to_add = make_arena_ref<expr::cpp_conversion>(expr->position,
+                                                         expr->frame,
+                                                         expr->needs_box,
+                                                         cpp_util::untyped_object_ref_type(),
+                                                         expr_type,
+                                                         conversion_policy::into_object,
+                                                         expr);
       expr->propagate_position(expression_position::value);
     }
     arity.body->values.push_back(expr_to_add);
@@ -217,10 +219,10 @@ namespace jank::evaluate
   {
     if(exprs.empty())
     {
-      return wrap_expression(jtl::make_ref<expr::primitive_literal>(expression_position::tail,
-                                                                    an_prc.root_frame,
-                                                                    true,
-                                                                    jank_nil),
+      return wrap_expression(make_arena_ref<expr::primitive_literal>(expression_position::tail,
+                                                                     an_prc.root_frame,
+                                                                     true,
+                                                                     jank_nil),
                              name,
                              {});
     }
@@ -261,8 +263,7 @@ namespace jank::evaluate
 
   object_ref eval(expression_ref const ex)
   {
-    profile::timer const timer{ util::format("eval ast node {}",
-                                             analyze::expression_kind_str(ex->kind)) };
+    profile::timer const timer{ "eval ast node {}", analyze::expression_kind_str(ex->kind) };
     object_ref ret{};
     visit_expr([&ret](auto const typed_ex) { ret = eval(typed_ex); }, ex);
     return ret;
@@ -551,7 +552,7 @@ namespace jank::evaluate
 
   object_ref eval(expr::function_ref const expr, jtl::immutable_string const &)
   {
-    profile::timer const timer{ util::format("eval jit function {}", expr->name) };
+    profile::timer const timer{ "eval jit function {}", expr->name };
     auto const module{ munge(expr->unique_name) };
     auto const mod{ ir::create(expr, module, codegen::compilation_target::eval) };
 
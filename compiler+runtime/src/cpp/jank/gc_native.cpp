@@ -0,0 +1,186 @@
+#include <array>
+#include <memory>
+#include <string_view>
+
+#include <jank/gc.hpp>
+#include <gc/gc_mark.h>
+
+#include <jank/gc_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::gc_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static obj::keyword_ref kw(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  static object_ref stats()
+  {
+    GC_word heap_size{}, free_bytes{}, unmapped_bytes{}, bytes_since_gc{}, total_bytes{};
+    GC_get_heap_usage_safe(&heap_size,
+                           &free_bytes,
+                           &unmapped_bytes,
+                           &bytes_since_gc,
+                           &total_bytes);
+
+    runtime::detail::native_transient_hash_map ret;
+    ret.set(kw("heap-size"), make_box(static_cast<i64>(heap_size)));
+    ret.set(kw("free-bytes"), make_box(static_cast<i64>(free_bytes)));
+    ret.set(kw("unmapped-bytes"), make_box(static_cast<i64>(unmapped_bytes)));
+    ret.set(kw("bytes-since-gc"), make_box(static_cast<i64>(bytes_since_gc)));
+    ret.set(kw("total-bytes"), make_box(static_cast<i64>(total_bytes)));
+    ret.set(kw("collections"), make_box(static_cast<i64>(GC_get_gc_no())));
+    ret.set(kw("pause-ms"), make_box(static_cast<i64>(GC_get_full_gc_total_time())));
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  /* Every object type has a name, so the first value without one is past the last type.
+   * This keeps the histogram in step with the enum as types are added. */
+  static constexpr usize object_type_count{ [] {
+    usize count{};
+    while(std::string_view{ object_type_str(static_cast<object_type>(count)) } != "unknown")
+    {
+      ++count;
+    }
+    return count;
+  }() };
+
+  /* The GC doesn't know which of its allocations are objects, so we recognize them by
+   * their layout. Every object starts with a vtable pointer, which is never in the GC's
+   * heap, and each vtable belongs to exactly one object type. Anything else which happens
+   * to look like an object would need a consistent fake vtable across every allocation,
+   * which we don't expect to see in practice. */
+  struct vtable_entry
+  {
+    void const *vtable{};
+    object_type type{};
+    bool conflicting{};
+    usize count{};
+    usize bytes{};
+  };
+
+  /* Enumerating the heap happens with the allocator lock held, so we can't allocate while
+   * doing it. Instead, we fill a table which is sized ahead of time. Once it's full, any
+   * new vtables are skipped, but there are far fewer object types than that. */
+  struct vtable_table
+  {
+    static constexpr usize capacity{ 1 << 12 };
+
+    std::array<vtable_entry, capacity> entries{};
+  };
+
+  static void GC_CALLBACK count_object(void * const ptr, size_t const bytes, void * const data)
+  {
+    if(bytes < sizeof(object))
+    {
+      return;
+    }
+
+    auto const vtable{ *static_cast<void const * const *>(ptr) };
+    auto const vtable_addr{ reinterpret_cast<uintptr_t>(vtable) };
+    auto const type{ static_cast<object const *>(ptr)->type };
+    if(!vtable || vtable_addr % alignof(void *) != 0
+       || static_cast<usize>(type) >= object_type_count)
+    {
+      return;
+    }
+
+    auto &entries{ static_cast<vtable_table *>(data)->entries };
+    for(usize i{ std::hash<uintptr_t>{}(vtable_addr) % vtable_table::capacity }, probes{};
+        probes < vtable_table::capacity;
+        i = (i + 1) % vtable_table::capacity, ++probes)
+    {
+      auto &entry{ entries[i] };
+      if(!entry.vtable)
+      {
+        entry.vtable = vtable;
+        entry.type = type;
+      }
+      if(entry.vtable == vtable)
+      {
+        entry.conflicting |= entry.type != type;
+        ++entry.count;
+        entry.bytes += bytes;
+        return;
+      }
+    }
+  }
+
+  static object_ref histogram()
+  {
+    auto const table{ std::make_unique<vtable_table>() };
+
+    /* Enumeration only sees objects which were marked, so we need a full collection
+     * first in order to get every live object. */
+    GC_gcollect();
+    GC_call_with_alloc_lock(
+      [](void * const data) -> void * {
+        GC_enumerate_reachable_objects_inner(&count_object, data);
+        return nullptr;
+      },
+      table.get());
+
+    std::array<std::pair<usize, usize>, object_type_count> by_type{};
+    for(auto const &entry : table->entries)
+    {
+      if(!entry.vtable || entry.conflicting || GC_base(const_cast<void *>(entry.vtable)))
+      {
+        continue;
+      }
+      auto &counts{ by_type[static_cast<usize>(entry.type)] };
+      counts.first += entry.count;
+      counts.second += entry.bytes;
+    }
+
+    runtime::detail::native_transient_hash_map ret;
+    for(usize i{}; i < by_type.size(); ++i)
+    {
+      auto const &[count, bytes]{ by_type[i] };
+      if(count == 0)
+      {
+        continue;
+      }
+      ret.set(kw(object_type_str(static_cast<object_type>(i))),
+              obj::persistent_hash_map::create_unique(
+                std::make_pair(kw("count"), make_box(static_cast<i64>(count))),
+                std::make_pair(kw("bytes"), make_box(static_cast<i64>(bytes)))));
+    }
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  static object_ref collect()
+  {
+    GC_gcollect();
+    return jank_nil;
+  }
+}
+
+extern "C" void jank_load_jank_gc_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.gc-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("stats", &gc_native::stats);
+  intern_fn("histogram", &gc_native::histogram);
+  intern_fn("collect", &gc_native::collect);
+}
@@ -1,5 +1,6 @@
 #include <jank/ir/builder.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/arena.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/analyze/cpp_util.hpp>
@@ -8,6 +9,7 @@
 namespace jank::ir
 {
   using namespace analyze::cpp_util;
+  using util::make_arena_ref;
 
   identifier builder::next_ident()
   {
@@ -74,7 +76,7 @@ namespace jank::ir
     auto const type{ untyped_object_ref_type() };
     used_identifiers.emplace(name);
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::parameter>(name, type));
+      make_arena_ref<inst::parameter>(name, type));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -88,7 +90,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::capture>(name, type, value));
+      make_arena_ref<inst::capture>(name, type, value));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -115,7 +117,7 @@ namespace jank::ir
 
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::literal>(name, type, value, lifted_literal_name));
+      make_arena_ref<inst::literal>(name, type, value, lifted_literal_name));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -129,7 +131,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::persistent_list>(name, jtl::move(values), meta));
+      make_arena_ref<inst::persistent_list>(name, jtl::move(values), meta));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -143,7 +145,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::persistent_vector>(name, jtl::move(values), meta));
+      make_arena_ref<inst::persistent_vector>(name, jtl::move(values), meta));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -158,7 +160,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::persistent_array_map>(name, jtl::move(values), meta));
+      make_arena_ref<inst::persistent_array_map>(name, jtl::move(values), meta));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -172,7 +174,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::persistent_hash_map>(name, jtl::move(values), meta));
+      make_arena_ref<inst::persistent_hash_map>(name, jtl::move(values), meta));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -186,7 +188,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::persistent_hash_set>(name, jtl::move(values), meta));
+      make_arena_ref<inst::persistent_hash_set>(name, jtl::move(values), meta));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -200,7 +202,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::function>(name, jtl::move(arities), arity_flags));
+      make_arena_ref<inst::function>(name, jtl::move(arities), arity_flags));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -217,11 +219,11 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::closure>(name,
-                                   context,
-                                   jtl::move(arities),
-                                   jtl::move(captures),
-                                   arity_flags));
+      make_arena_ref<inst::closure>(name,
+                                    context,
+                                    jtl::move(arities),
+                                    jtl::move(captures),
+                                    arity_flags));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, current_function()->blocks[block_index].instructions.back()->type);
@@ -233,7 +235,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::letfn>(name, jtl::move(bindings)));
+      make_arena_ref<inst::letfn>(name, jtl::move(bindings)));
     return name;
   }
 
@@ -246,7 +248,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const type{ var_type() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::def>(name, type, qualified_var, value, meta, is_dynamic));
+      make_arena_ref<inst::def>(name, type, qualified_var, value, meta, is_dynamic));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -274,7 +276,7 @@ namespace jank::ir
     }
 
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::var_deref>(name, lifted_var_name));
+      make_arena_ref<inst::var_deref>(name, lifted_var_name));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, untyped_object_ref_type());
@@ -292,7 +294,7 @@ namespace jank::ir
     auto const type{ var_type() };
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::var_ref>(name, type, var_name));
+      make_arena_ref<inst::var_ref>(name, type, var_name));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -305,7 +307,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const type{ untyped_object_ref_type() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::type_erase>(name, value));
+      make_arena_ref<inst::type_erase>(name, value));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -320,7 +322,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const type{ untyped_object_ref_type() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::dynamic_call>(name, type, fn, jtl::move(args)));
+      make_arena_ref<inst::dynamic_call>(name, type, fn, jtl::move(args)));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -337,12 +339,45 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const type{ untyped_object_ref_type() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::named_recursion>(name,
-                                           type,
-                                           fn,
-                                           fn_base_name,
-                                           jtl::move(args),
-                                           needs_dynamic_call));
+      make_arena_ref<inst::named_recursion>(name,
+                                            type,
+                                            fn,
+                                            fn_base_name,
+                                            jtl::move(args),
+                                            needs_dynamic_call));
+    if(pos == analyze::expression_position::tail)
+    {
+      return ret(name, type);
+    }
+    return name;
+  }
+
+  identifier builder::direct_call(analyze::expression_position const pos,
+                                  identifier const &fn,
+                                  jtl::immutable_string const &fn_base_name,
+                                  native_vector<identifier> &&args)
+  {
+    auto name{ next_ident() };
+    auto const type{ untyped_object_ref_type() };
+    current_function()->blocks[block_index].instructions.emplace_back(
+      make_arena_ref<inst::direct_call>(name, type, fn, fn_base_name, jtl::move(args)));
+    if(pos == analyze::expression_position::tail)
+    {
+      return ret(name, type);
+    }
+    return name;
+  }
+
+  identifier builder::keyword_get(analyze::expression_position const pos,
+                                  identifier const &source,
+                                  identifier const &key,
+                                  jtl::option<identifier> const &fallback,
+                                  bool const source_is_callee)
+  {
+    auto name{ next_ident() };
+    auto const type{ untyped_object_ref_type() };
+    current_function()->blocks[block_index].instructions.emplace_back(
+      make_arena_ref<inst::keyword_get>(name, type, source, key, fallback, source_is_callee));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -355,7 +390,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const type{ untyped_object_ref_type() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::recursion_reference>(name, type));
+      make_arena_ref<inst::recursion_reference>(name, type));
     if(pos == analyze::expression_position::tail)
     {
       return ret(name, type);
@@ -367,7 +402,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::truthy>(name, value));
+      make_arena_ref<inst::truthy>(name, value));
     return name;
   }
 
@@ -376,7 +411,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const &block{ current_function()->blocks[index].name };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::jump>(name, block));
+      make_arena_ref<inst::jump>(name, block));
     return name;
   }
 
@@ -385,7 +420,7 @@ namespace jank::ir
     auto name{ next_ident() };
     auto const &block{ current_function()->blocks[index].name };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::jump>(name, block, loop));
+      make_arena_ref<inst::jump>(name, block, loop));
     return name;
   }
 
@@ -393,14 +428,14 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::branch_set>(name, shadow, value));
+      make_arena_ref<inst::branch_set>(name, shadow, value));
     return name;
   }
 
   identifier builder::branch_get(identifier const &name, jtl::ptr<void> const type) const
   {
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::branch_get>(name, type));
+      make_arena_ref<inst::branch_get>(name, type));
     return name;
   }
 
@@ -412,7 +447,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::branch>(name, condition, then_blk, else_blk, merge_blk, shadow));
+      make_arena_ref<inst::branch>(name, condition, then_blk, else_blk, merge_blk, shadow));
     return name;
   }
 
@@ -423,7 +458,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::loop>(name, loop_blk, merge_blk, shadow, jtl::move(shadows)));
+      make_arena_ref<inst::loop>(name, loop_blk, merge_blk, shadow, jtl::move(shadows)));
     return name;
   }
 
@@ -437,14 +472,14 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::case_>(name,
-                                 shift,
-                                 mask,
-                                 value,
-                                 jtl::move(cases),
-                                 default_block,
-                                 merge_block,
-                                 shadow));
+      make_arena_ref<inst::case_>(name,
+                                  shift,
+                                  mask,
+                                  value,
+                                  jtl::move(cases),
+                                  default_block,
+                                  merge_block,
+                                  shadow));
     return name;
   }
 
@@ -455,7 +490,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::try_>(name, jtl::move(catches), merge_block, shadow, finally_block));
+      make_arena_ref<inst::try_>(name, jtl::move(catches), merge_block, shadow, finally_block));
     return name;
   }
 
@@ -466,7 +501,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::catch_>(name, type, merge_block, shadow, finally_block));
+      make_arena_ref<inst::catch_>(name, type, merge_block, shadow, finally_block));
     return name;
   }
 
@@ -474,7 +509,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::finally>(name, merge_block));
+      make_arena_ref<inst::finally>(name, merge_block));
     return name;
   }
 
@@ -482,7 +517,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::throw_>(name, value));
+      make_arena_ref<inst::throw_>(name, value));
     return name;
   }
 
@@ -490,7 +525,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::ret>(name, type, value));
+      make_arena_ref<inst::ret>(name, type, value));
     return name;
   }
 
@@ -498,7 +533,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_raw>(name, expr));
+      make_arena_ref<inst::cpp_raw>(name, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -510,7 +545,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_value>(name, expr));
+      make_arena_ref<inst::cpp_value>(name, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -525,12 +560,12 @@ namespace jank::ir
     if(expr->policy == analyze::conversion_policy::into_object)
     {
       current_function()->blocks[block_index].instructions.emplace_back(
-        jtl::make_ref<inst::cpp_into_object>(name, value, expr));
+        make_arena_ref<inst::cpp_into_object>(name, value, expr));
     }
     else
     {
       current_function()->blocks[block_index].instructions.emplace_back(
-        jtl::make_ref<inst::cpp_from_object>(name, value, expr));
+        make_arena_ref<inst::cpp_from_object>(name, value, expr));
     }
     if(expr->position == analyze::expression_position::tail)
     {
@@ -544,7 +579,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_unsafe_cast>(name, value, expr));
+      make_arena_ref<inst::cpp_unsafe_cast>(name, value, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -558,7 +593,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_call>(name, value, jtl::move(args), expr));
+      make_arena_ref<inst::cpp_call>(name, value, jtl::move(args), expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -571,7 +606,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_constructor_call>(name, jtl::move(args), expr));
+      make_arena_ref<inst::cpp_constructor_call>(name, jtl::move(args), expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -584,7 +619,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_member_call>(name, jtl::move(args), expr));
+      make_arena_ref<inst::cpp_member_call>(name, jtl::move(args), expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -597,7 +632,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_member_access>(name, value, expr));
+      make_arena_ref<inst::cpp_member_access>(name, value, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -611,7 +646,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_builtin_operator_call>(name, jtl::move(args), expr));
+      make_arena_ref<inst::cpp_builtin_operator_call>(name, jtl::move(args), expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -623,7 +658,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_box>(name, value, expr));
+      make_arena_ref<inst::cpp_box>(name, value, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -637,7 +672,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_unbox>(name, value, meta, expr));
+      make_arena_ref<inst::cpp_unbox>(name, value, meta, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -649,7 +684,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_new>(name, value, expr));
+      make_arena_ref<inst::cpp_new>(name, value, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -661,7 +696,7 @@ namespace jank::ir
   {
     auto name{ next_ident() };
     current_function()->blocks[block_index].instructions.emplace_back(
-      jtl::make_ref<inst::cpp_delete>(name, value, expr));
+      make_arena_ref<inst::cpp_delete>(name, value, expr));
     if(expr->position == analyze::expression_position::tail)
     {
       return ret(name, expression_type(expr));
@@ -180,6 +180,32 @@ namespace jank::ir::inst
   {
   }
 
+  direct_call::direct_call(identifier const &name,
+                           jtl::ptr<void> const type,
+                           identifier const &fn,
+                           jtl::immutable_string const &fn_base_name,
+                           native_vector<identifier> &&args)
+    : instruction{ instruction_kind::direct_call, name, type }
+    , fn{ fn }
+    , fn_base_name{ fn_base_name }
+    , args{ jtl::move(args) }
+  {
+  }
+
+  keyword_get::keyword_get(identifier const &name,
+                           jtl::ptr<void> const type,
+                           identifier const &source,
+                           identifier const &key,
+                           jtl::option<identifier> const &fallback,
+                           bool const source_is_callee)
+    : instruction{ instruction_kind::keyword_get, name, type }
+    , source{ source }
+    , key{ key }
+    , fallback{ fallback }
+    , source_is_callee{ source_is_callee }
+  {
+  }
+
   recursion_reference::recursion_reference(identifier const &name, jtl::ptr<void> const type)
     : instruction{ instruction_kind::recursion_reference, name, type }
   {
@@ -0,0 +1,248 @@
+#include <jank/ir/pass/hoist_var_derefs.hpp>
+#include <jank/ir/visit.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/util/cli.hpp>
+
+namespace jank::ir::pass
+{
+  /* Gathers every block which is referenced by the given instruction. Not all of these
+   * are terminators, since try/catch/finally also point at other blocks. */
+  static void successors(instruction_ref const inst, native_vector<identifier> &out)
+  {
+    visit_inst(
+      [&](auto const typed_inst) {
+        using T = typename decltype(typed_inst)::value_type;
+
+        if constexpr(std::same_as<T, inst::jump>)
+        {
+          out.emplace_back(typed_inst->block);
+        }
+        else if constexpr(std::same_as<T, inst::branch>)
+        {
+          out.emplace_back(typed_inst->then_block);
+          out.emplace_back(typed_inst->else_block);
+          if(typed_inst->merge_block.is_some())
+          {
+            out.emplace_back(typed_inst->merge_block.unwrap());
+          }
+        }
+        else if constexpr(std::same_as<T, inst::loop>)
+        {
+          out.emplace_back(typed_inst->loop_block);
+          if(typed_inst->merge_block.is_some())
+          {
+            out.emplace_back(typed_inst->merge_block.unwrap());
+          }
+        }
+        else if constexpr(std::same_as<T, inst::case_>)
+        {
+          for(auto const &c : typed_inst->case_blocks)
+          {
+            out.emplace_back(c.second);
+          }
+          out.emplace_back(typed_inst->default_block);
+          if(typed_inst->merge_block.is_some())
+          {
+            out.emplace_back(typed_inst->merge_block.unwrap());
+          }
+        }
+        else if constexpr(std::same_as<T, inst::try_>)
+        {
+          for(auto const &c : typed_inst->catches)
+          {
+            out.emplace_back(c.second);
+          }
+          out.emplace_back(typed_inst->merge_block);
+          if(typed_inst->finally_block.is_some())
+          {
+            out.emplace_back(typed_inst->finally_block.unwrap());
+          }
+        }
+        else if constexpr(std::same_as<T, inst::catch_>)
+        {
+          if(typed_inst->merge_block.is_some())
+          {
+            out.emplace_back(typed_inst->merge_block.unwrap());
+          }
+          if(typed_inst->finally_block.is_some())
+          {
+            out.emplace_back(typed_inst->finally_block.unwrap());
+          }
+        }
+        else if constexpr(std::same_as<T, inst::finally>)
+        {
+          out.emplace_back(typed_inst->merge_block);
+        }
+      },
+      inst);
+  }
+
+  /* The body of a loop is every block reachable from its loop block without passing
+   * through its merge block. A loop in tail position has no merge block, so every
+   * reachable block is part of the body. */
+  static native_set<usize> loop_body(function const &fn, inst::loop_ref const loop)
+  {
+    native_set<usize> body;
+    native_vector<usize> pending{ fn.find_block(loop->loop_block) };
+    native_vector<identifier> next;
+    while(!pending.empty())
+    {
+      auto const current{ pending.back() };
+      pending.pop_back();
+      if(!body.emplace(current).second)
+      {
+        continue;
+      }
+
+      next.clear();
+      for(auto const &i : fn.blocks[current].instructions)
+      {
+        successors(i, next);
+      }
+      for(auto const &blk : next)
+      {
+        if(loop->merge_block.is_some() && blk == loop->merge_block.unwrap())
+        {
+          continue;
+        }
+        pending.emplace_back(fn.find_block(blk));
+      }
+    }
+    return body;
+  }
+
+  /* A var deref can only be hoisted if its root isn't expected to change while the loop
+   * is running. Dynamic vars can be rebound per thread at any point, so they're skipped.
+   * Vars which don't exist yet are also skipped, since we know nothing about them. */
+  static bool is_hoistable_var(module const &mod, identifier const &lifted_var)
+  {
+    auto const found{ mod.lifted_vars.find(lifted_var) };
+    if(found == mod.lifted_vars.end())
+    {
+      return false;
+    }
+
+    auto const var{ runtime::__rt_ctx->find_var(
+      runtime::make_box<runtime::obj::symbol>(found->second.qualified_var)) };
+    return var.is_some() && !var->dynamic.load();
+  }
+
+  struct loop_info
+  {
+    usize preheader{};
+    inst::loop_ref loop;
+    native_set<usize> body;
+  };
+
+  /* Var derefs lock the var on every access. Within a loop body, the same non-dynamic vars
+   * are generally dereferenced on every iteration, even though their roots won't change
+   * unless they're redefined. This pass moves those derefs to the block which enters the
+   * outermost loop containing them, right before the loop instruction, so the lock is only
+   * taken once.
+   *
+   * In checked mode, each loop which contained a hoisted deref will compare the var's root
+   * version at the start of every iteration and deref again if it has changed. This keeps
+   * REPL redefinitions visible to long running loops, just not in the middle of an
+   * iteration. In unchecked mode, hoisted derefs are never refreshed. */
+  static void hoist_var_derefs(module const &mod, function &fn, bool const checked)
+  {
+    native_vector<loop_info> loops;
+    for(usize i{}; i < fn.blocks.size(); ++i)
+    {
+      for(auto const &inst : fn.blocks[i].instructions)
+      {
+        if(inst->kind == instruction_kind::loop)
+        {
+          auto const loop{ jtl::static_ref_cast<inst::loop>(inst) };
+          loops.push_back({ i, loop, loop_body(fn, loop) });
+        }
+      }
+    }
+
+    if(loops.empty())
+    {
+      return;
+    }
+
+    /* Any var which is redefined within a loop must keep its deref where it is. */
+    native_set<jtl::immutable_string> defined_vars;
+    for(auto const &blk : fn.blocks)
+    {
+      for(auto const &inst : blk.instructions)
+      {
+        if(inst->kind == instruction_kind::def)
+        {
+          defined_vars.emplace(jtl::static_ref_cast<inst::def>(inst)->qualified_var);
+        }
+      }
+    }
+
+    for(usize blk_index{}; blk_index < fn.blocks.size(); ++blk_index)
+    {
+      auto &instructions{ fn.blocks[blk_index].instructions };
+      for(auto it{ instructions.begin() }; it != instructions.end();)
+      {
+        if((*it)->kind != instruction_kind::var_deref)
+        {
+          ++it;
+          continue;
+        }
+
+        auto const deref{ jtl::static_ref_cast<inst::var_deref>(*it) };
+        auto const &qualified_var{ mod.lifted_vars.at(deref->var).qualified_var };
+        if(defined_vars.contains(qualified_var) || !is_hoistable_var(mod, deref->var))
+        {
+          ++it;
+          continue;
+        }
+
+        /* The outermost loop is the one with the largest body, since loop bodies either
+         * nest or are disjoint. */
+        loop_info const *outermost{};
+        for(auto &loop : loops)
+        {
+          if(!loop.body.contains(blk_index))
+          {
+            continue;
+          }
+          if(!outermost || outermost->body.size() < loop.body.size())
+          {
+            outermost = &loop;
+          }
+          if(checked)
+          {
+            loop.loop->checked_var_derefs.emplace_back(deref->name, deref->var);
+          }
+        }
+
+        if(!outermost)
+        {
+          ++it;
+          continue;
+        }
+
+        /* Inserting into our own block would invalidate our iterator, but a loop's body
+         * never contains its own preheader. */
+        jank_debug_assert(outermost->preheader != blk_index);
+
+        deref->version_checked = checked;
+        it = instructions.erase(it);
+
+        /* The loop is always the terminator of its preheader, so we slot in right before it. */
+        auto &preheader{ fn.blocks[outermost->preheader].instructions };
+        preheader.insert(preheader.end() - 1, deref);
+      }
+    }
+  }
+
+  void hoist_var_derefs(module &mod)
+  {
+    auto const checked{ util::cli::opts.hoist_var_derefs == util::cli::var_hoisting::checked };
+    for(auto &fn : mod.functions)
+    {
+      hoist_var_derefs(mod, fn, checked);
+    }
+  }
+}
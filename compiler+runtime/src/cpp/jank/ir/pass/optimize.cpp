@@ -0,0 +1,22 @@
+#include <jank/ir/pass/optimize.hpp>
+#include <jank/ir/pass/hoist_var_derefs.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/profile/time.hpp>
+
+namespace jank::ir::pass
+{
+  /* This is the general entry point to run optimizations on an IR module. Just like the
+   * AST optimization passes, there is a default set of passes and others may be
+   * enabled/disabled via CLI flags.
+   *
+   * The module is modified in place. */
+  void optimize(module &mod)
+  {
+    profile::timer const timer{ "optimize ir" };
+
+    if(util::cli::opts.hoist_var_derefs != util::cli::var_hoisting::none)
+    {
+      hoist_var_derefs(mod);
+    }
+  }
+}
@@ -221,9 +221,10 @@ namespace jank::ir
   void inst::var_deref::print(jtl::string_builder &sb, usize const) const
   {
     util::format_to(sb,
-                    "{:name {} :op :var-deref :var {} :type \"{}\"}",
+                    "{:name {} :op :var-deref :var {} :version-checked {} :type \"{}\"}",
                     name,
                     var,
+                    version_checked,
                     get_qualified_type_name(type));
   }
 
@@ -277,6 +278,43 @@ namespace jank::ir
     util::format_to(sb, "] :type \"{}\"}", get_qualified_type_name(type));
   }
 
+  void inst::direct_call::print(jtl::string_builder &sb, usize const) const
+  {
+    util::format_to(sb,
+                    "{:name {} :op :direct-call :fn {} :fn-base-name {} :args [",
+                    name,
+                    fn,
+                    fn_base_name);
+    bool needs_space{};
+    for(auto const &arg : args)
+    {
+      if(needs_space)
+      {
+        util::format_to(sb, " ");
+      }
+      needs_space = true;
+      sb(arg);
+    }
+    util::format_to(sb, "] :type \"{}\"}", get_qualified_type_name(type));
+  }
+
+  void inst::keyword_get::print(jtl::string_builder &sb, usize const) const
+  {
+    util::format_to(sb,
+                    "{:name {} :op :keyword-get :source {} :key {}",
+                    name,
+                    source,
+                    key);
+    if(fallback.is_some())
+    {
+      util::format_to(sb, " :fallback {}", fallback.unwrap());
+    }
+    util::format_to(sb,
+                    " :source-is-callee {} :type \"{}\"}",
+                    source_is_callee,
+                    get_qualified_type_name(type));
+  }
+
   void inst::recursion_reference::print(jtl::string_builder &sb, usize const) const
   {
     util::format_to(sb,
@@ -358,7 +396,18 @@ namespace jank::ir
                       s.value,
                       get_qualified_type_name(s.type));
     }
-    util::format_to(sb, "} :type \"{}\"}", get_qualified_type_name(type));
+    util::format_to(sb, "} :checked-var-derefs [");
+    needs_space = false;
+    for(auto const &d : checked_var_derefs)
+    {
+      if(needs_space)
+      {
+        util::format_to(sb, " ");
+      }
+      needs_space = true;
+      util::format_to(sb, "{:name {} :var {}}", d.first, d.second);
+    }
+    util::format_to(sb, "] :type \"{}\"}", get_qualified_type_name(type));
   }
 
   void inst::case_::print(jtl::string_builder &sb, usize const) const
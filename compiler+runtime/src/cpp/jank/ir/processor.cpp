@@ -8,16 +8,23 @@
 #include <jank/runtime/core/call.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/rtti.hpp>
 #include <jank/runtime/obj/persistent_array_map.hpp>
 #include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/runtime/obj/deferred_cpp_function.hpp>
 #include <jank/runtime/ns.hpp>
 #include <jank/runtime/module/loader.hpp>
 #include <jank/analyze/cpp_util.hpp>
 #include <jank/analyze/visit.hpp>
 #include <jank/ir/builder.hpp>
+#include <jank/ir/pass/optimize.hpp>
+#include <jank/codegen/cpp_processor.hpp>
+#include <jank/profile/compile_report.hpp>
 #include <jank/ui/highlight.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/scope_exit.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/error/codegen.hpp>
 
 namespace jank::ir
@@ -87,6 +94,101 @@ namespace jank::ir
                      util::format("{}/{}", expr->var->n->name->name, expr->var->name->name));
   }
 
+  static bool has_fixed_arity(runtime::obj::jit_function_ref const fn, usize const arity)
+  {
+    switch(arity)
+    {
+      case 0:
+        return fn->arity_0;
+      case 1:
+        return fn->arity_1;
+      case 2:
+        return fn->arity_2;
+      case 3:
+        return fn->arity_3;
+      case 4:
+        return fn->arity_4;
+      case 5:
+        return fn->arity_5;
+      case 6:
+        return fn->arity_6;
+      case 7:
+        return fn->arity_7;
+      case 8:
+        return fn->arity_8;
+      case 9:
+        return fn->arity_9;
+      case 10:
+        return fn->arity_10;
+      default:
+        return false;
+    }
+  }
+
+  /* With --direct-call, a call through a var which currently holds a compiled jank fn
+   * can skip both the var deref and the virtual call, by calling the fn's arity symbol
+   * directly. Much like Clojure's direct linking, the call site will not see later
+   * redefinitions of the var, so dynamic vars and vars marked ^:redef are left alone.
+   *
+   * This is only done for eval, since the arity symbols belong to the JIT session. AOT
+   * modules are re-analyzed with fresh names, so there is nothing stable to link to. */
+  static jtl::option<runtime::obj::jit_function_ref>
+  direct_call_target(analyze::expr::call_ref const expr, builder const &b)
+  {
+    if(!util::cli::opts.direct_call || b.mod->target != codegen::compilation_target::eval
+       || expr->source_expr->kind != analyze::expression_kind::var_deref
+       || runtime::max_params < expr->arg_exprs.size())
+    {
+      return none;
+    }
+
+    auto const var{ jtl::static_ref_cast<analyze::expr::var_deref>(expr->source_expr)->var };
+    static auto const redef_kw{ runtime::__rt_ctx->intern_keyword("redef").expect_ok() };
+    if(var->dynamic.load() || runtime::truthy(runtime::get(var->get_meta(), redef_kw)))
+    {
+      return none;
+    }
+
+    auto const root{ var->get_root() };
+    runtime::obj::jit_function_ref fn;
+    if(root->type == runtime::object_type::jit_function)
+    {
+      fn = runtime::expect_object<runtime::obj::jit_function>(root);
+    }
+    else if(root->type == runtime::object_type::deferred_cpp_function)
+    {
+      /* Linking to a lazily compiled fn means compiling it now. */
+      fn = runtime::expect_object<runtime::obj::deferred_cpp_function>(root)->compile();
+    }
+    else
+    {
+      return none;
+    }
+
+    auto const arg_count{ expr->arg_exprs.size() };
+    if(fn->base_name.empty() || !has_fixed_arity(fn, arg_count))
+    {
+      return none;
+    }
+
+    /* Calls which could land in the variadic arity need their rest args packed, which
+     * only the dynamic path does. */
+    auto const variadic_mask{ runtime::extract_variadic_arity_mask(fn->arity_flags) };
+    if((variadic_mask & 0b10000000) && (variadic_mask & 0b00001111) <= arg_count)
+    {
+      return none;
+    }
+
+    return fn;
+  }
+
+  static bool is_keyword_literal(analyze::expression_ref const expr)
+  {
+    return expr->kind == analyze::expression_kind::primitive_literal
+      && jtl::static_ref_cast<analyze::expr::primitive_literal>(expr)->data->type
+      == runtime::object_type::keyword;
+  }
+
   jtl::option<identifier> gen(analyze::expr::call_ref const expr, builder &b)
   {
     native_vector<identifier> arg_idents;
@@ -96,7 +198,33 @@ namespace jank::ir
       arg_idents.emplace_back(gen(arg_expr, b).unwrap());
     }
 
+    /* Keyword lookups, like `(:k m)` and `(m :k)`, are some of the most common calls, so
+     * they get their own instruction which avoids the dynamic call for maps. */
+    auto const arg_count{ expr->arg_exprs.size() };
+    jtl::option<identifier> keyword_fallback;
+    if(arg_count == 2)
+    {
+      keyword_fallback = arg_idents[1];
+    }
+    if((arg_count == 1 || arg_count == 2) && is_keyword_literal(expr->source_expr))
+    {
+      auto const key_ident{ gen(expr->source_expr, b).unwrap() };
+      return b.keyword_get(expr->position, arg_idents[0], key_ident, keyword_fallback, false);
+    }
+
+    auto const direct_fn{ direct_call_target(expr, b) };
+    if(direct_fn.is_some())
+    {
+      auto const fn{ direct_fn.unwrap() };
+      auto const fn_ident{ b.literal(analyze::expression_position::value, fn) };
+      return b.direct_call(expr->position, fn_ident, fn->base_name, jtl::move(arg_idents));
+    }
+
     auto const fn_ident{ gen(expr->source_expr, b).unwrap() };
+    if((arg_count == 1 || arg_count == 2) && is_keyword_literal(expr->arg_exprs[0]))
+    {
+      return b.keyword_get(expr->position, fn_ident, arg_idents[0], keyword_fallback, true);
+    }
     return b.dynamic_call(expr->position, fn_ident, jtl::move(arg_idents));
   }
 
@@ -866,6 +994,9 @@ namespace jank::ir
                 jtl::immutable_string const &module_name,
                 codegen::compilation_target const target)
   {
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::ir
+    };
     native_vector<jtl::immutable_string> entry_points;
     entry_points.reserve(fn_expr->arities.size());
     for(auto const &arity : fn_expr->arities)
@@ -884,6 +1015,21 @@ namespace jank::ir
       gen_arity(mod, fn_expr, arity);
     }
 
+    pass::optimize(mod);
+
+    if(profile::compile_report::is_enabled())
+    {
+      usize instructions{};
+      for(auto const &fn : mod.functions)
+      {
+        for(auto const &block : fn.blocks)
+        {
+          instructions += block.instructions.size();
+        }
+      }
+      profile::compile_report::add_instructions(instructions);
+    }
+
     jtl::immutable_string_view const print_settings{ getenv("JANK_PRINT_IR") ?: "" };
     if(print_settings == "1")
     {
@@ -6,11 +6,14 @@
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/Signals.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/JITLink/JITLink.h>
 #include <llvm/ExecutionEngine/Orc/Debugging/PerfSupportPlugin.h>
 #include <llvm/ExecutionEngine/Orc/Debugging/DebugInfoSupport.h>
 #include <llvm/ExecutionEngine/Orc/TargetProcess/JITLoaderPerf.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/BinaryFormat/Magic.h>
 
 #include <CppInterOp/Compatibility.h>
 #include <CppInterOp/CppInterOp.h>
@@ -29,6 +32,8 @@
 #include <jank/ir/processor.hpp>
 #include <jank/codegen/cpp_processor.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/compile_report.hpp>
+#include <jank/profile/sampler.hpp>
 #include <jank/error/system.hpp>
 #include <jank/error/runtime.hpp>
 #include <jank/error/codegen.hpp>
@@ -88,6 +93,46 @@ namespace jank::jit
     }
   }
 
+  /* The sampling profiler can't ask dladdr about JIT compiled code, so this tells it
+   * where each fn is linked. */
+  struct sampler_symbols_plugin : llvm::orc::ObjectLinkingLayer::Plugin
+  {
+    void modifyPassConfig(llvm::orc::MaterializationResponsibility &,
+                          llvm::jitlink::LinkGraph &,
+                          llvm::jitlink::PassConfiguration &config) override
+    {
+      config.PostFixupPasses.emplace_back([](llvm::jitlink::LinkGraph &graph) {
+        for(auto const symbol : graph.defined_symbols())
+        {
+          if(symbol->hasName() && symbol->isCallable())
+          {
+            llvm::StringRef const name{ *symbol->getName() };
+            profile::sampler::register_jit_symbol(symbol->getAddress().getValue(),
+                                                  symbol->getSize(),
+                                                  { name.data(), name.size() });
+          }
+        }
+        return llvm::Error::success();
+      });
+    }
+
+    llvm::Error notifyFailed(llvm::orc::MaterializationResponsibility &) override
+    {
+      return llvm::Error::success();
+    }
+
+    llvm::Error notifyRemovingResources(llvm::orc::JITDylib &, llvm::orc::ResourceKey) override
+    {
+      return llvm::Error::success();
+    }
+
+    void notifyTransferringResources(llvm::orc::JITDylib &,
+                                     llvm::orc::ResourceKey,
+                                     llvm::orc::ResourceKey) override
+    {
+    }
+  };
+
   processor::processor(jtl::immutable_string const &binary_version)
   {
     profile::timer const timer{ "jit ctor" };
@@ -218,12 +263,26 @@ namespace jank::jit
         break;
     }
 
+    /* Instrumented code needs the profile runtime, which jank doesn't link, so only AOT
+     * compiled code can generate profiles. Using one is fine, though. */
+    if(!util::cli::opts.profile_use.empty())
+    {
+      args.push_back(
+        strdup(util::format("-fprofile-use={}", util::cli::opts.profile_use).c_str()));
+    }
+
     //util::println("jit flags {}", args);
 
     /* We don't actually own this interpreter. CppInterOp does. */
     interpreter.reset(static_cast<CppInternal::Interpreter *>(
       Cpp::CreateInterpreter(args, {}, vfs, static_cast<int>(llvm::CodeModel::Large))));
 
+    if(auto const oll{ llvm::dyn_cast<llvm::orc::ObjectLinkingLayer>(
+         &interpreter->getExecutionEngine()->getObjLinkingLayer()) })
+    {
+      oll->addPlugin(std::make_unique<sampler_symbols_plugin>());
+    }
+
     /* Enabling perf support requires registering a couple of plugins with LLVM. These
      * plugins will generate files which perf can then use to inject additional info
      * into its recorded data (via `perf inject`).
@@ -293,6 +352,7 @@ namespace jank::jit
                              native_vector<u8> const &arities) const
   {
     auto const ret{ runtime::make_box<jank::runtime::obj::jit_function>(flags) };
+    ret->base_name = base_name;
     for(auto const arity : arities)
     {
       switch(arity)
@@ -354,9 +414,43 @@ namespace jank::jit
     eval_string(s, nullptr);
   }
 
+  namespace
+  {
+    /* Adds to the profiler's counter track of the total time spent JIT compiling, from when
+     * it's constructed until it's destroyed. */
+    struct jit_compile_time
+    {
+      jit_compile_time()
+        : start{ profile::is_enabled() ? std::chrono::steady_clock::now()
+                                       : std::chrono::steady_clock::time_point{} }
+      {
+      }
+
+      ~jit_compile_time()
+      {
+        if(!profile::is_enabled())
+        {
+          return;
+        }
+
+        /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+        static std::atomic<i64> total_us;
+        auto const elapsed{ std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start) };
+        profile::counter("jit compile us", total_us += elapsed.count());
+      }
+
+      std::chrono::steady_clock::time_point start;
+    };
+  }
+
   void processor::eval_string(jtl::immutable_string const &s, clang::Value * const ret) const
   {
     profile::timer const timer{ "jit eval_string" };
+    jit_compile_time const compile_time;
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::clang
+    };
     auto formatted{ s };
 
     jtl::immutable_string_view const print_settings{ getenv("JANK_PRINT_CODEGEN") ?: "" };
@@ -382,6 +476,14 @@ namespace jank::jit
     {
       throw std::runtime_error{ util::format("failed to load object file: {}", path) };
     }
+    /* Modules compiled for LTO are bitcode, even though they have the object extension. */
+    if(llvm::identify_magic(file.get()->getBuffer()) == llvm::file_magic::bitcode)
+    {
+      auto const buffer{ file.get()->getBuffer() };
+      load_bitcode(jtl::immutable_string{ path }, { buffer.data(), buffer.size() });
+      return;
+    }
+
     /* XXX: Object files won't be able to use global ctors until jank is on the ORC
      * runtime, which likely won't happen until clang::Interpreter is on the ORC runtime. */
     /* TODO: Return result on failure. */
@@ -392,9 +494,13 @@ namespace jank::jit
   void processor::load_ir_module(llvm::orc::ThreadSafeModule &&m) const
   {
     auto const &module_name{ m.getModuleUnlocked()->getName() };
-    profile::timer const timer{ util::format(
-      "jit ir module {}",
-      jtl::immutable_string_view{ module_name.data(), module_name.size() }) };
+    profile::timer const timer{ "jit ir module {}",
+                                jtl::immutable_string_view{ module_name.data(),
+                                                            module_name.size() } };
+    jit_compile_time const compile_time;
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::link
+    };
     //m->print(llvm::outs(), nullptr);
 
     auto const ee(interpreter->getExecutionEngine());
@@ -438,6 +544,10 @@ namespace jank::jit
 
   jtl::string_result<void *> processor::find_symbol(jtl::immutable_string const &name) const
   {
+    /* The JIT compiles lazily, so this is where LLVM generates and links the code. */
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::link
+    };
     if(auto symbol{ interpreter->getSymbolAddress(name.c_str()) })
     {
       return symbol.get().toPtr<void *>();
@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <charconv>
+
+#include <jank/nrepl/bencode.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::nrepl::bencode
+{
+  using namespace jank::runtime;
+
+  /* Nesting deeper than this is surely not an nREPL message and we'd rather not recurse
+   * until the stack runs out. */
+  static constexpr usize max_depth{ 256 };
+
+  namespace
+  {
+    enum class parse_status : u8
+    {
+      ok,
+      incomplete,
+      invalid
+    };
+
+    struct parser
+    {
+      parse_status parse_value(object_ref &out, usize const depth)
+      {
+        if(pos >= input.size())
+        {
+          return incomplete(1);
+        }
+        if(depth > max_depth)
+        {
+          return invalid("Bencode value is nested too deeply.");
+        }
+
+        switch(input[pos])
+        {
+          case 'i':
+            return parse_integer(out);
+          case 'l':
+            return parse_list(out, depth);
+          case 'd':
+            return parse_dict(out, depth);
+          default:
+            return parse_string(out);
+        }
+      }
+
+      parse_status parse_integer(object_ref &out)
+      {
+        auto const end{ input.find('e', pos) };
+        if(end == std::string_view::npos)
+        {
+          return incomplete(1);
+        }
+
+        i64 value{};
+        auto const digits{ input.substr(pos + 1, end - pos - 1) };
+        auto const parsed{ std::from_chars(digits.data(), digits.data() + digits.size(), value) };
+        if(digits.empty() || parsed.ec != std::errc{}
+           || parsed.ptr != digits.data() + digits.size())
+        {
+          return invalid(util::format("Invalid bencode integer '{}'.", digits));
+        }
+
+        out = make_box(value);
+        pos = end + 1;
+        return parse_status::ok;
+      }
+
+      parse_status parse_length(usize &length)
+      {
+        auto const colon{ input.find(':', pos) };
+        if(colon == std::string_view::npos)
+        {
+          /* A length with this many digits can't be valid. */
+          if(input.size() - pos > 20)
+          {
+            return invalid("Invalid bencode string length.");
+          }
+          return incomplete(1);
+        }
+
+        auto const digits{ input.substr(pos, colon - pos) };
+        auto const parsed{ std::from_chars(digits.data(), digits.data() + digits.size(), length) };
+        if(digits.empty() || parsed.ec != std::errc{}
+           || parsed.ptr != digits.data() + digits.size())
+        {
+          return invalid(util::format("Invalid bencode string length '{}'.", digits));
+        }
+
+        pos = colon + 1;
+        return parse_status::ok;
+      }
+
+      parse_status parse_string(object_ref &out)
+      {
+        auto const start{ pos };
+        usize length{};
+        auto const status{ parse_length(length) };
+        if(status != parse_status::ok)
+        {
+          return status;
+        }
+
+        if(input.size() - pos < length)
+        {
+          auto const missing{ length - (input.size() - pos) };
+          pos = start;
+          return incomplete(missing);
+        }
+
+        out = make_box<obj::persistent_string>(jtl::immutable_string{ input.data() + pos, length });
+        pos += length;
+        return parse_status::ok;
+      }
+
+      parse_status parse_list(object_ref &out, usize const depth)
+      {
+        ++pos;
+        runtime::detail::native_transient_vector items;
+        while(true)
+        {
+          if(pos >= input.size())
+          {
+            return incomplete(1);
+          }
+          if(input[pos] == 'e')
+          {
+            ++pos;
+            break;
+          }
+
+          object_ref item;
+          auto const status{ parse_value(item, depth + 1) };
+          if(status != parse_status::ok)
+          {
+            return status;
+          }
+          items.push_back(item);
+        }
+
+        out = make_box<obj::persistent_vector>(items.persistent());
+        return parse_status::ok;
+      }
+
+      parse_status parse_dict(object_ref &out, usize const depth)
+      {
+        ++pos;
+        runtime::detail::native_transient_hash_map items;
+        while(true)
+        {
+          if(pos >= input.size())
+          {
+            return incomplete(1);
+          }
+          if(input[pos] == 'e')
+          {
+            ++pos;
+            break;
+          }
+
+          object_ref key, value;
+          auto status{ parse_string(key) };
+          if(status != parse_status::ok)
+          {
+            return status;
+          }
+          status = parse_value(value, depth + 1);
+          if(status != parse_status::ok)
+          {
+            return status;
+          }
+          items.set(key, value);
+        }
+
+        out = make_box<obj::persistent_hash_map>(items.persistent());
+        return parse_status::ok;
+      }
+
+      parse_status incomplete(usize const missing)
+      {
+        needed = missing;
+        return parse_status::incomplete;
+      }
+
+      parse_status invalid(jtl::immutable_string const &message)
+      {
+        error = message;
+        return parse_status::invalid;
+      }
+
+      std::string_view input;
+      usize pos{};
+      usize needed{};
+      jtl::immutable_string error;
+    };
+  }
+
+  void decoder::feed(std::string_view const bytes)
+  {
+    /* Decoded bytes are only dropped once they make up most of the buffer, so we don't shift
+     * it down for every message. */
+    if(offset > 0 && offset >= buffer.size() / 2)
+    {
+      buffer.erase(0, offset);
+      offset = 0;
+    }
+
+    buffer.append(bytes);
+    needed = bytes.size() >= needed ? 0 : needed - bytes.size();
+  }
+
+  jtl::result<jtl::option<object_ref>, jtl::immutable_string> decoder::next()
+  {
+    if(offset == buffer.size() || needed > 0)
+    {
+      return ok(none);
+    }
+
+    parser p{ std::string_view{ buffer }.substr(offset) };
+    object_ref value;
+    switch(p.parse_value(value, 0))
+    {
+      case parse_status::ok:
+        offset += p.pos;
+        return ok(value);
+      case parse_status::incomplete:
+        needed = p.needed;
+        return ok(none);
+      case parse_status::invalid:
+      default:
+        return err(p.error);
+    }
+  }
+
+  usize decoder::pending() const
+  {
+    return buffer.size() - offset;
+  }
+
+  encoder::encoder(usize const chunk_size, flush_fn &&flush)
+    : chunk_size{ chunk_size }
+    , flush{ std::move(flush) }
+  {
+    chunk.reserve(chunk_size);
+  }
+
+  void encoder::write(std::string_view const s)
+  {
+    chunk.append(s);
+    if(chunk.size() >= chunk_size)
+    {
+      flush(std::move(chunk));
+      chunk.clear();
+      chunk.reserve(chunk_size);
+    }
+  }
+
+  void encoder::write_string(std::string_view const s)
+  {
+    write(util::format("{}:", s.size()));
+    write(s);
+  }
+
+  static std::string_view to_view(jtl::immutable_string const &s)
+  {
+    return { s.data(), s.size() };
+  }
+
+  jtl::string_result<void> encoder::encode(object_ref const o)
+  {
+    switch(o->type)
+    {
+      case object_type::nil:
+        return err("Unable to encode nil as bencode.");
+      case object_type::integer:
+        write(util::format("i{}e", expect_object<obj::integer>(o)->data));
+        return ok();
+      case object_type::persistent_string:
+        write_string(to_view(expect_object<obj::persistent_string>(o)->data));
+        return ok();
+      case object_type::keyword:
+        write_string(to_view(expect_object<obj::keyword>(o)->sym->name));
+        return ok();
+      default:
+        break;
+    }
+
+    if(is_map(o))
+    {
+      /* Keys are sorted by their raw bytes. */
+      native_vector<std::pair<jtl::immutable_string, object_ref>> entries;
+      for(auto it{ seq(o) }; it.is_some(); it = next(it))
+      {
+        auto const entry{ first(it) };
+        auto const key{ first(entry) };
+        entries.emplace_back(key->type == object_type::keyword
+                               ? expect_object<obj::keyword>(key)->sym->name
+                               : runtime::to_string(key),
+                             second(entry));
+      }
+      std::ranges::sort(entries, [](auto const &l, auto const &r) {
+        return to_view(l.first) < to_view(r.first);
+      });
+
+      write("d");
+      for(auto const &entry : entries)
+      {
+        write_string(to_view(entry.first));
+        auto const res{ encode(entry.second) };
+        if(res.is_err())
+        {
+          return res;
+        }
+      }
+      write("e");
+      return ok();
+    }
+
+    if(is_collection(o))
+    {
+      write("l");
+      for(auto it{ seq(o) }; it.is_some(); it = next(it))
+      {
+        auto const res{ encode(first(it)) };
+        if(res.is_err())
+        {
+          return res;
+        }
+      }
+      write("e");
+      return ok();
+    }
+
+    write_string(to_view(runtime::to_string(o)));
+    return ok();
+  }
+
+  void encoder::finish()
+  {
+    if(!chunk.empty())
+    {
+      flush(std::move(chunk));
+      chunk.clear();
+    }
+  }
+
+  jtl::string_result<jtl::immutable_string> encode(object_ref const o)
+  {
+    std::string ret;
+    encoder enc{ 4096, [&](std::string &&s) { ret += s; } };
+    auto const res{ enc.encode(o) };
+    if(res.is_err())
+    {
+      return err(res.expect_err());
+    }
+    enc.finish();
+    return ok(jtl::immutable_string{ ret });
+  }
+
+  object_ref parse(object_ref const input)
+  {
+    auto const s{ runtime::to_string(input) };
+    decoder d;
+    d.feed(to_view(s));
+    auto const res{ d.next() };
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err().c_str() };
+    }
+    if(res.expect_ok().is_none())
+    {
+      return jank_nil;
+    }
+
+    auto const consumed{ s.size() - d.pending() };
+    return make_box<obj::persistent_vector>(
+      std::in_place,
+      res.expect_ok().unwrap(),
+      make_box<obj::persistent_string>(s.substr(consumed)));
+  }
+
+  object_ref write(object_ref const o)
+  {
+    auto const res{ encode(o) };
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err().c_str() };
+    }
+    return make_box<obj::persistent_string>(res.expect_ok());
+  }
+}
@@ -1,103 +1,254 @@
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <boost/asio.hpp>
 
 #include <jtl/string_builder.hpp>
 
+#include <jank/gc.hpp>
 #include <jank/nrepl/server.hpp>
+#include <jank/nrepl/bencode.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
+#include <jank/util/scope_exit.hpp>
 
 namespace jank::nrepl::server
 {
   using namespace boost::asio;
   using namespace boost::asio::ip;
+  using namespace jank::runtime;
+
+  /* Responses are written in chunks of this size, so a big value doesn't need one big
+   * contiguous buffer. */
+  static constexpr usize tx_chunk_size{ static_cast<usize>(64 * 1024) };
+  static constexpr usize rx_capacity{ static_cast<usize>(64 * 1024) };
+
+  struct connection;
+
+  struct request
+  {
+    i64 connection{};
+    object_ref message;
+  };
 
-  struct native_client::impl
+  struct native_server::impl
   {
-    impl(boost::asio::io_context &io_context)
-      : socket_{ io_context }
+    impl(tcp::endpoint const &endpoint)
+      : acceptor_{ io_context_, endpoint }
     {
     }
 
-    void accept(tcp::acceptor &acceptor)
+    void accept();
+    void push(i64 const connection, object_ref const message);
+    void remove(i64 const connection);
+
+    io_context io_context_;
+    tcp::acceptor acceptor_;
+    std::thread io_thread_;
+
+    std::mutex connections_mutex_;
+    std::unordered_map<i64, std::shared_ptr<connection>> connections_;
+    i64 next_connection_id_{};
+
+    std::mutex requests_mutex_;
+    std::condition_variable request_ready_;
+    /* These hold GC objects while living outside of the GC heap, so they need to be
+     * scanned without being collected. */
+    std::deque<request, traceable_allocator<request>> requests_;
+  };
+
+  struct connection : std::enable_shared_from_this<connection>
+  {
+    connection(native_server::impl &server, tcp::socket &&socket, i64 const id)
+      : server_{ server }
+      , socket_{ std::move(socket) }
+      , strand_{ make_strand(server.io_context_) }
+      , id_{ id }
+      , rx_buf_(rx_capacity)
     {
-      acceptor.accept(socket_);
-      connected_ = true;
     }
 
-    bool is_connected() const
+    void read()
     {
-      return connected_;
+      socket_.async_read_some(
+        buffer(rx_buf_),
+        bind_executor(strand_,
+                      [self = shared_from_this()](boost::system::error_code const &error,
+                                                  std::size_t const length) {
+                        self->on_read(error, length);
+                      }));
     }
 
-    std::string read_some()
+    void on_read(boost::system::error_code const &error, std::size_t const length)
     {
-      boost::system::error_code error;
+      if(error)
+      {
+        close();
+        return;
+      }
 
-      auto const length{ socket_.read_some(buffer(rx_buf_, rx_capacity), error) };
-      if(error == boost::asio::error::eof || error == boost::asio::error::connection_reset)
+      decoder_.feed({ rx_buf_.data(), length });
+      while(true)
       {
-        connected_ = false;
-        return "";
+        auto const res{ decoder_.next() };
+        if(res.is_err())
+        {
+          util::println(stderr, "nREPL client sent invalid bencode: {}", res.expect_err());
+          close();
+          return;
+        }
+        if(res.expect_ok().is_none())
+        {
+          break;
+        }
+        server_.push(id_, res.expect_ok().unwrap());
       }
 
-      return { rx_buf_, length };
+      read();
+    }
+
+    /* Can be called from any thread. The chunks of a message are queued together, so
+     * messages sent from different threads never interleave. */
+    void send(std::vector<std::string> &&chunks)
+    {
+      post(strand_, [self = shared_from_this(), chunks = std::move(chunks)]() mutable {
+        for(auto &chunk : chunks)
+        {
+          self->tx_queue_.emplace_back(std::move(chunk));
+        }
+        if(!self->writing_ && !self->tx_queue_.empty())
+        {
+          self->write();
+        }
+      });
+    }
+
+    void write()
+    {
+      writing_ = true;
+      async_write(socket_,
+                  buffer(tx_queue_.front()),
+                  bind_executor(strand_,
+                                [self = shared_from_this()](boost::system::error_code const &error,
+                                                            std::size_t) {
+                                  self->tx_queue_.pop_front();
+                                  if(error)
+                                  {
+                                    self->close();
+                                    return;
+                                  }
+
+                                  if(self->tx_queue_.empty())
+                                  {
+                                    self->writing_ = false;
+                                  }
+                                  else
+                                  {
+                                    self->write();
+                                  }
+                                }));
     }
 
-    void write_some(std::string const &message)
+    void close()
     {
-      boost::system::error_code error_code;
-      socket_.write_some(buffer(message), error_code);
+      if(!open_.exchange(false))
+      {
+        return;
+      }
+      boost::system::error_code ignored;
+      socket_.close(ignored);
+      server_.remove(id_);
     }
 
+    native_server::impl &server_;
     tcp::socket socket_;
-    bool connected_{ false };
+    strand<io_context::executor_type> strand_;
+    i64 id_{};
+    std::atomic_bool open_{ true };
 
-    static constexpr std::size_t rx_capacity{ static_cast<std::size_t>(1024 * 1024) }; // 1MiB
-    char rx_buf_[rx_capacity]{};
+    /* Only touched within the strand. */
+    std::vector<char> rx_buf_;
+    bencode::decoder decoder_;
+    std::deque<std::string> tx_queue_;
+    bool writing_{};
   };
 
-  native_client::native_client(std::unique_ptr<native_client::impl> impl)
-    : impl_{ std::move(impl) }
+  void native_server::impl::accept()
   {
-  }
-
-  bool native_client::is_connected() const
-  {
-    return impl_->is_connected();
-  }
+    acceptor_.async_accept(make_strand(io_context_),
+                           [this](boost::system::error_code const &ec, tcp::socket socket) {
+                             if(ec)
+                             {
+                               /* The acceptor is closed when the server is shutting down. */
+                               if(ec != boost::asio::error::operation_aborted)
+                               {
+                                 accept();
+                               }
+                               return;
+                             }
 
-  std::string native_client::read_some() const
-  {
-    return impl_->read_some();
-  }
+                             std::shared_ptr<connection> conn;
+                             {
+                               std::lock_guard const lock{ connections_mutex_ };
+                               auto const id{ ++next_connection_id_ };
+                               conn = std::make_shared<connection>(*this, std::move(socket), id);
+                               connections_.emplace(id, conn);
+                             }
+                             post(conn->strand_, [conn]() { conn->read(); });
 
-  void native_client::write_some(std::string const &data) const
-  {
-    impl_->write_some(data);
+                             accept();
+                           });
   }
 
-  // server
-  struct native_server::impl
+  void native_server::impl::push(i64 const connection, object_ref const message)
   {
-    impl(tcp::endpoint const &endpoint)
-      : acceptor_{ io_context_, endpoint }
     {
+      std::lock_guard const lock{ requests_mutex_ };
+      requests_.push_back({ connection, message });
     }
+    request_ready_.notify_one();
+  }
 
-    std::unique_ptr<native_client::impl> accept()
+  void native_server::impl::remove(i64 const connection)
+  {
     {
-      auto impl{ std::make_unique<native_client::impl>(io_context_) };
-      impl->accept(acceptor_);
-
-      return impl;
+      std::lock_guard const lock{ connections_mutex_ };
+      connections_.erase(connection);
     }
-
-    io_context io_context_;
-    tcp::acceptor acceptor_;
-  };
+    /* A nil request tells jank that the connection is gone, so it can drop whatever it was
+     * keeping for it. */
+    push(connection, jank_nil);
+  }
 
   native_server::native_server()
     : impl_{ std::make_shared<native_server::impl>(tcp::endpoint(ip::address_v4::loopback(), 0)) }
   {
+    impl_->accept();
+    impl_->io_thread_ = std::thread{ [impl = impl_.get()]() {
+      /* Requests are decoded on this thread, so it allocates. */
+      GC_stack_base sb{};
+      GC_get_stack_base(&sb);
+      GC_register_my_thread(&sb);
+      util::scope_exit const unregister{ []() { GC_unregister_my_thread(); } };
+
+      impl->io_context_.run();
+    } };
+  }
+
+  native_server::~native_server()
+  {
+    impl_->io_context_.stop();
+    if(impl_->io_thread_.joinable())
+    {
+      impl_->io_thread_.join();
+    }
   }
 
   jtl::immutable_string native_server::get_endpoint() const
@@ -113,12 +264,44 @@ namespace jank::nrepl::server
     return impl_->acceptor_.local_endpoint().port();
   }
 
-  native_client *native_server::accept() const
+  object_ref native_server::receive() const
+  {
+    request req;
+    {
+      std::unique_lock lock{ impl_->requests_mutex_ };
+      impl_->request_ready_.wait(lock, [this]() { return !impl_->requests_.empty(); });
+      req = impl_->requests_.front();
+      impl_->requests_.pop_front();
+    }
+
+    return make_box<obj::persistent_vector>(std::in_place, make_box(req.connection), req.message);
+  }
+
+  bool native_server::send(object_ref const connection, object_ref const message) const
   {
-    auto impl{ impl_->accept() };
+    std::shared_ptr<struct connection> conn;
+    {
+      std::lock_guard const lock{ impl_->connections_mutex_ };
+      auto const found{ impl_->connections_.find(to_int(connection)) };
+      if(found == impl_->connections_.end())
+      {
+        return false;
+      }
+      conn = found->second;
+    }
 
-    // TODO: This leaks memory but jank complains about not being able to delete
-    // an opaque type if we return unique_ptr<native_client>.
-    return new native_client(std::move(impl));
+    /* Nothing is queued until the whole message has been encoded, so a message which can't
+     * be encoded doesn't leave half of itself on the wire. */
+    std::vector<std::string> chunks;
+    bencode::encoder encoder{ tx_chunk_size,
+                              [&](std::string &&chunk) { chunks.emplace_back(std::move(chunk)); } };
+    auto const res{ encoder.encode(message) };
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err().c_str() };
+    }
+    encoder.finish();
+    conn->send(std::move(chunks));
+    return true;
   }
 }
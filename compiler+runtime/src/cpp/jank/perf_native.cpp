@@ -23,4 +23,14 @@ extern "C" void jank_load_jank_perf_native()
           make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
   });
   intern_fn("benchmark", &perf::benchmark);
+  intern_fn("start-sampling", &perf::start_sampling);
+  intern_fn("stop-sampling", &perf::stop_sampling);
+  intern_fn("is-sampling", &perf::is_sampling);
+  intern_fn("folded-stacks", &perf::folded_stacks);
+  intern_fn("clear-samples", &perf::clear_samples);
+  intern_fn("start-allocation-profile", &perf::start_allocation_profile);
+  intern_fn("stop-allocation-profile", &perf::stop_allocation_profile);
+  intern_fn("allocation-sites", &perf::allocation_sites);
+  intern_fn("allocation-types", &perf::allocation_types);
+  intern_fn("clear-allocations", &perf::clear_allocations);
 }
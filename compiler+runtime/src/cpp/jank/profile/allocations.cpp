@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include <pthread.h>
+
+#include <jank/profile/allocations.hpp>
+#include <jank/profile/sampler.hpp>
+#include <jank/runtime/object.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::profile::allocations
+{
+  using util::cli::opts;
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  std::atomic_bool enabled;
+
+  /* Enough frames to get from the runtime fn which allocated a box out to the jank fn
+   * which called it, in most cases. */
+  static constexpr usize max_depth{ 16 };
+  static constexpr u32 max_interval{ 1 << 24 };
+  static constexpr usize max_report_sites{ 20 };
+
+  struct sample_key
+  {
+    auto operator<=>(sample_key const &) const = default;
+
+    runtime::object_type type{};
+    usize depth{};
+    /* The innermost frame comes first. */
+    std::array<uptr, max_depth> pcs{};
+  };
+
+  struct totals
+  {
+    u64 count{};
+    u64 bytes{};
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    std::mutex mutex;
+    std::map<sample_key, totals> samples;
+    std::chrono::steady_clock::duration elapsed{};
+    std::chrono::steady_clock::time_point started;
+  } state;
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic<u32> sample_interval{ 1 };
+  /* Bumped on each start, so that each thread redraws a countdown which was drawn for the
+   * previous interval. Zero is never a generation, so new threads always draw one. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic<u64> generation{ 0 };
+
+  struct thread_state
+  {
+    /* The boxes left until the next sample, including it. */
+    u64 countdown{};
+    /* The generation the countdown was drawn in. */
+    u64 generation{};
+    u64 random{};
+    uptr stack_low{};
+    uptr stack_high{};
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local thread_state local;
+
+  /* xorshift64, which is plenty for spacing out samples. */
+  static u64 next_random(u64 &s)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+  }
+
+  /* Sampling every interval'th box could line up with a loop which allocates a few boxes
+   * per iteration, and then only ever see one of them. Instead, the gap between samples is
+   * drawn uniformly from 1 to 2 * interval - 1, which still averages out to interval. */
+  static u64 next_countdown(thread_state &s)
+  {
+    auto const interval{ static_cast<u64>(sample_interval.load(std::memory_order_relaxed)) };
+    return 1 + (next_random(s.random) % ((interval * 2) - 1));
+  }
+
+  static void prepare_thread(thread_state &s)
+  {
+    s.random = reinterpret_cast<uptr>(&s)
+      ^ static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count());
+    if(s.random == 0)
+    {
+      s.random = 1;
+    }
+
+    /* Stacks are walked within the thread's own stack, so a bad frame pointer can stop
+     * the walk early, but can't send it anywhere unmapped. */
+#if defined(__linux__)
+    pthread_attr_t attr;
+    if(pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+      void *addr{};
+      size_t size{};
+      if(pthread_attr_getstack(&attr, &addr, &size) == 0)
+      {
+        s.stack_low = reinterpret_cast<uptr>(addr);
+        s.stack_high = s.stack_low + size;
+      }
+      pthread_attr_destroy(&attr);
+    }
+#elif defined(__APPLE__)
+    auto const self{ pthread_self() };
+    s.stack_high = reinterpret_cast<uptr>(pthread_get_stackaddr_np(self));
+    s.stack_low = s.stack_high - pthread_get_stacksize_np(self);
+#endif
+  }
+
+  [[gnu::noinline]]
+  void record(runtime::object_type const type, usize const bytes)
+  {
+    auto &s{ local };
+    auto const current{ generation.load(std::memory_order_acquire) };
+    if(s.generation != current) [[unlikely]]
+    {
+      if(s.random == 0)
+      {
+        prepare_thread(s);
+      }
+      s.generation = current;
+      s.countdown = next_countdown(s);
+    }
+    if(--s.countdown != 0)
+    {
+      return;
+    }
+    s.countdown = next_countdown(s);
+
+    /* Each frame record holds the caller's frame pointer, followed by the return address.
+     * Ours returns into make_box, or into its caller, when it was inlined. */
+    sample_key key{ .type = type };
+    auto fp{ reinterpret_cast<uptr>(__builtin_frame_address(0)) };
+    while(key.depth < max_depth && fp >= s.stack_low && fp % alignof(uptr) == 0
+          && fp + (2 * sizeof(uptr)) <= s.stack_high)
+    {
+      auto const frame{ reinterpret_cast<uptr const *>(fp) };
+      if(frame[1] == 0)
+      {
+        break;
+      }
+      key.pcs[key.depth++] = frame[1];
+      if(frame[0] <= fp)
+      {
+        break;
+      }
+      fp = frame[0];
+    }
+
+    auto const interval{ sample_interval.load(std::memory_order_relaxed) };
+    std::lock_guard const lock{ state.mutex };
+    auto &t{ state.samples[key] };
+    t.count += interval;
+    t.bytes += bytes * interval;
+  }
+
+  jtl::string_result<void> start(u32 const interval)
+  {
+    if(interval == 0 || interval > max_interval)
+    {
+      return err(util::format("Invalid allocation sample interval '{}'. It must be from 1 to {}.",
+                              interval,
+                              max_interval));
+    }
+
+    std::lock_guard const lock{ state.mutex };
+    if(enabled.load(std::memory_order_acquire))
+    {
+      return err("The allocation profiler is already running.");
+    }
+    sample_interval.store(interval, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    state.started = std::chrono::steady_clock::now();
+    enabled.store(true, std::memory_order_release);
+    return ok();
+  }
+
+  void stop()
+  {
+    std::lock_guard const lock{ state.mutex };
+    if(!enabled.exchange(false))
+    {
+      return;
+    }
+    state.elapsed += std::chrono::steady_clock::now() - state.started;
+  }
+
+  void clear()
+  {
+    std::lock_guard const lock{ state.mutex };
+    state.samples.clear();
+    state.elapsed = {};
+    state.started = std::chrono::steady_clock::now();
+  }
+
+  f64 elapsed_seconds()
+  {
+    std::lock_guard const lock{ state.mutex };
+    auto elapsed{ state.elapsed };
+    if(enabled.load(std::memory_order_acquire))
+    {
+      elapsed += std::chrono::steady_clock::now() - state.started;
+    }
+    return std::chrono::duration<f64>{ elapsed }.count();
+  }
+
+  /* make_box is usually inlined into its caller, but not always, so its own frames are
+   * recognized by name. */
+  static bool is_make_box(jtl::immutable_string const &name)
+  {
+    return name.contains("jank::runtime::make_box");
+  }
+
+  std::vector<site> sites()
+  {
+    std::map<sample_key, totals> samples;
+    {
+      std::lock_guard const lock{ state.mutex };
+      samples = state.samples;
+    }
+
+    /* Every frame is a return address, which may be just past the end of its fn, if the
+     * call was the last thing in it, so each is symbolized by the byte before it. */
+    std::unordered_map<uptr, jtl::immutable_string> names;
+    auto const name_of{ [&](uptr const pc) -> jtl::immutable_string const & {
+      auto found{ names.find(pc) };
+      if(found == names.end())
+      {
+        found = names.emplace(pc, sampler::symbolize(pc - 1)).first;
+      }
+      return found->second;
+    } };
+    std::unordered_map<uptr, jtl::option<jtl::immutable_string>> jank_fns;
+    auto const jank_fn_of{ [&](uptr const pc) -> jtl::option<jtl::immutable_string> const & {
+      auto found{ jank_fns.find(pc) };
+      if(found == jank_fns.end())
+      {
+        found = jank_fns.emplace(pc, sampler::jank_fn_at(pc - 1)).first;
+      }
+      return found->second;
+    } };
+
+    /* Different stacks through the same site, on behalf of the same jank fn, are merged. */
+    std::map<std::tuple<runtime::object_type, uptr, std::string>, site> merged;
+    for(auto const &[key, t] : samples)
+    {
+      usize caller{};
+      while(caller < key.depth && is_make_box(name_of(key.pcs[caller])))
+      {
+        ++caller;
+      }
+
+      site s{ .type = key.type, .caller = "(unknown)" };
+      if(caller < key.depth)
+      {
+        s.address = key.pcs[caller];
+        s.caller = name_of(s.address);
+      }
+      for(auto i{ caller }; i < key.depth; ++i)
+      {
+        auto const &jank_fn{ jank_fn_of(key.pcs[i]) };
+        if(jank_fn.is_some())
+        {
+          s.jank_fn = jank_fn;
+          break;
+        }
+      }
+
+      std::string jank_fn_name;
+      if(s.jank_fn.is_some())
+      {
+        jank_fn_name = { s.jank_fn.unwrap().data(), s.jank_fn.unwrap().size() };
+      }
+      auto const found{
+        merged.try_emplace({ s.type, s.address, std::move(jank_fn_name) }, std::move(s)).first
+      };
+      found->second.count += t.count;
+      found->second.bytes += t.bytes;
+    }
+
+    std::vector<site> ret;
+    ret.reserve(merged.size());
+    for(auto &[_, s] : merged)
+    {
+      ret.emplace_back(std::move(s));
+    }
+    std::ranges::stable_sort(ret, [](site const &lhs, site const &rhs) {
+      return lhs.bytes > rhs.bytes;
+    });
+    return ret;
+  }
+
+  static void write_text(std::ostream &out)
+  {
+    auto const all{ sites() };
+    auto const seconds{ std::max(elapsed_seconds(), 1e-9) };
+
+    std::map<runtime::object_type, totals> by_type;
+    for(auto const &s : all)
+    {
+      auto &t{ by_type[s.type] };
+      t.count += s.count;
+      t.bytes += s.bytes;
+    }
+    std::vector<std::pair<runtime::object_type, totals>> types{ by_type.begin(),
+                                                                by_type.end() };
+    std::ranges::stable_sort(types, [](auto const &lhs, auto const &rhs) {
+      return lhs.second.bytes > rhs.second.bytes;
+    });
+
+    out << std::fixed << std::setprecision(0);
+    out << "\nAllocations (estimated from 1 in " << sample_interval.load() << " boxes over "
+        << std::setprecision(3) << seconds << std::setprecision(0) << " s)\n\n";
+    out << std::setw(14) << "bytes" << ' ' << std::setw(12) << "count" << ' ' << std::setw(14)
+        << "bytes/s" << "  type\n";
+    for(auto const &[type, t] : types)
+    {
+      out << std::setw(14) << t.bytes << ' ' << std::setw(12) << t.count << ' '
+          << std::setw(14) << (static_cast<f64>(t.bytes) / seconds) << "  "
+          << runtime::object_type_str(type) << '\n';
+    }
+
+    if(all.empty())
+    {
+      return;
+    }
+    auto const count{ std::min(all.size(), max_report_sites) };
+    out << "\nTop " << count << " allocation sites\n\n";
+    for(usize i{}; i < count; ++i)
+    {
+      auto const &s{ all[i] };
+      out << std::setw(14) << s.bytes << ' ' << std::setw(12) << s.count << ' '
+          << std::setw(14) << (static_cast<f64>(s.bytes) / seconds) << "  "
+          << runtime::object_type_str(s.type) << '\n';
+      if(s.jank_fn.is_some())
+      {
+        out << "                in " << s.jank_fn.unwrap() << '\n';
+      }
+      out << "                at " << s.caller << '\n';
+    }
+  }
+
+  static void write_at_exit()
+  {
+    stop();
+
+    if(opts.alloc_profile_file == "-")
+    {
+      write_text(std::cout);
+      std::cout.flush();
+      return;
+    }
+
+    std::ofstream out{ opts.alloc_profile_file.c_str() };
+    if(!out.is_open())
+    {
+      util::println(stderr, "Unable to open allocation profile file: {}", opts.alloc_profile_file);
+      return;
+    }
+    write_text(out);
+  }
+
+  void configure()
+  {
+    if(opts.alloc_profile_file.empty())
+    {
+      return;
+    }
+
+    auto const res{ start(opts.alloc_sample_interval) };
+    if(res.is_err())
+    {
+      util::println(stderr, "Unable to start the allocation profiler: {}", res.expect_err());
+      return;
+    }
+    std::atexit(write_at_exit);
+  }
+}
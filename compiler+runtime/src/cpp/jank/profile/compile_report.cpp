@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <jank/profile/compile_report.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/escape.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::profile::compile_report
+{
+  using util::cli::opts;
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  std::atomic_bool enabled;
+
+  /* Forms are summarized in the report by their code, up to this many bytes. */
+  static constexpr usize max_form_size{ 80 };
+
+  struct totals
+  {
+    void add(totals const &rhs)
+    {
+      for(usize i{}; i < phase_count; ++i)
+      {
+        times[i] += rhs.times[i];
+      }
+      cpp_bytes += rhs.cpp_bytes;
+      instructions += rhs.instructions;
+    }
+
+    i64 total() const
+    {
+      return std::accumulate(times.begin(), times.end(), i64{});
+    }
+
+    /* In nanoseconds. */
+    std::array<i64, phase_count> times{};
+    usize cpp_bytes{};
+    usize instructions{};
+  };
+
+  struct form_record
+  {
+    std::string ns;
+    std::string file;
+    usize line{};
+    std::string form;
+    totals t;
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    std::mutex mutex;
+    std::vector<form_record> forms;
+    /* Time which is part of a namespace, but not of any one form, such as AOT compiling the
+     * whole module once it's loaded. */
+    std::map<std::string, totals> modules;
+    /* Time spent compiling outside of any frame. */
+    totals runtime;
+  } report;
+
+  /* Each thread tracks its own phases, so only recording needs the lock. The bottom frame
+   * is never popped and it's flushed into the runtime's totals whenever the thread leaves
+   * its outermost phase. */
+  struct thread_state
+  {
+    thread_state()
+    {
+      frames.emplace_back();
+    }
+
+    std::vector<totals> frames;
+    std::vector<phase> phases;
+    i64 last_switch{};
+  };
+
+  static thread_state &local_state()
+  {
+    thread_local thread_state state;
+    return state;
+  }
+
+  static i64 now()
+  {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  /* Charges the time since the last switch to whichever phase is running. */
+  static void charge(thread_state &state, i64 const time)
+  {
+    if(!state.phases.empty())
+    {
+      state.frames.back().times[static_cast<usize>(state.phases.back())]
+        += time - state.last_switch;
+    }
+    state.last_switch = time;
+  }
+
+  void enter(phase const p)
+  {
+    auto &state{ local_state() };
+    charge(state, now());
+    state.phases.emplace_back(p);
+  }
+
+  void exit()
+  {
+    auto &state{ local_state() };
+    if(state.phases.empty())
+    {
+      return;
+    }
+    charge(state, now());
+    state.phases.pop_back();
+
+    if(state.phases.empty() && state.frames.size() == 1)
+    {
+      std::lock_guard const lock{ report.mutex };
+      report.runtime.add(state.frames.back());
+      state.frames.back() = {};
+    }
+  }
+
+  void push_frame()
+  {
+    auto &state{ local_state() };
+    charge(state, now());
+    state.frames.emplace_back();
+  }
+
+  void pop_frame()
+  {
+    auto &state{ local_state() };
+    charge(state, now());
+    if(state.frames.size() > 1)
+    {
+      state.frames.pop_back();
+    }
+  }
+
+  /* Collapses the form's whitespace, so each one fits on a line. */
+  static std::string summarize_form(runtime::object_ref const form)
+  {
+    auto const code{ runtime::to_code_string(form) };
+    std::string ret;
+    bool in_space{};
+    for(auto const c : code)
+    {
+      /* Don't cut a UTF-8 sequence in half. */
+      if(ret.size() >= max_form_size && (c & 0xc0) != 0x80)
+      {
+        ret += "...";
+        break;
+      }
+      if(std::isspace(static_cast<unsigned char>(c)) != 0 || c == ',')
+      {
+        in_space = true;
+        continue;
+      }
+      if(in_space && !ret.empty())
+      {
+        ret += ' ';
+      }
+      in_space = false;
+      ret += c;
+    }
+    return ret;
+  }
+
+  void record_form(jtl::immutable_string const &ns, runtime::object_ref const form)
+  {
+    if(!is_enabled())
+    {
+      return;
+    }
+
+    auto &state{ local_state() };
+    charge(state, now());
+
+    auto const source{ runtime::object_source(form) };
+    form_record record{ { ns.data(), ns.size() },
+                        { source.file.data(), source.file.size() },
+                        source.start.line,
+                        summarize_form(form),
+                        state.frames.back() };
+    state.frames.back() = {};
+    {
+      std::lock_guard const lock{ report.mutex };
+      report.forms.emplace_back(std::move(record));
+    }
+
+    /* Summarizing the form isn't part of compiling it. */
+    state.last_switch = now();
+  }
+
+  void record_module(jtl::immutable_string const &ns)
+  {
+    if(!is_enabled())
+    {
+      return;
+    }
+
+    auto &state{ local_state() };
+    charge(state, now());
+
+    std::lock_guard const lock{ report.mutex };
+    report.modules[{ ns.data(), ns.size() }].add(state.frames.back());
+    state.frames.back() = {};
+  }
+
+  void add_generated_cpp(usize const bytes)
+  {
+    if(is_enabled())
+    {
+      local_state().frames.back().cpp_bytes += bytes;
+    }
+  }
+
+  void add_instructions(usize const count)
+  {
+    if(is_enabled())
+    {
+      local_state().frames.back().instructions += count;
+    }
+  }
+
+  struct namespace_summary
+  {
+    usize forms{};
+    totals t;
+  };
+
+  static std::map<std::string, namespace_summary> summarize_namespaces()
+  {
+    std::map<std::string, namespace_summary> ret;
+    for(auto const &form : report.forms)
+    {
+      auto &summary{ ret[form.ns] };
+      ++summary.forms;
+      summary.t.add(form.t);
+    }
+    for(auto const &[ns, t] : report.modules)
+    {
+      ret[ns].t.add(t);
+    }
+    return ret;
+  }
+
+  static std::vector<form_record const *> slowest_forms()
+  {
+    std::vector<form_record const *> ret;
+    ret.reserve(report.forms.size());
+    for(auto const &form : report.forms)
+    {
+      ret.emplace_back(&form);
+    }
+    auto const count{ std::min<usize>(opts.compile_report_slowest, ret.size()) };
+    std::partial_sort(ret.begin(),
+                      ret.begin() + static_cast<std::ptrdiff_t>(count),
+                      ret.end(),
+                      [](auto const lhs, auto const rhs) {
+                        return lhs->t.total() > rhs->t.total();
+                      });
+    ret.resize(count);
+    return ret;
+  }
+
+  static double to_ms(i64 const ns)
+  {
+    return static_cast<double>(ns) / 1'000'000.0;
+  }
+
+  /* Writes the fields shared by namespaces, forms, and the totals, without braces. */
+  static void write_json_totals(std::ostream &out, totals const &t)
+  {
+    out << R"("total-ms":)" << to_ms(t.total()) << R"(,"cpp-bytes":)" << t.cpp_bytes
+        << R"(,"instructions":)" << t.instructions << R"(,"phases-ms":{)";
+    for(usize i{}; i < phase_count; ++i)
+    {
+      out << (i == 0 ? "" : ",") << '"' << phase_str(static_cast<phase>(i))
+          << "\":" << to_ms(t.times[i]);
+    }
+    out << '}';
+  }
+
+  static void write_json_form(std::ostream &out, form_record const &form)
+  {
+    out << R"({"namespace":)";
+    util::write_json_string(out, form.ns);
+    out << R"(,"file":)";
+    util::write_json_string(out, form.file);
+    out << R"(,"line":)" << form.line << R"(,"form":)";
+    util::write_json_string(out, form.form);
+    out << ',';
+    write_json_totals(out, form.t);
+    out << '}';
+  }
+
+  static void write_json(std::ostream &out)
+  {
+    auto const namespaces{ summarize_namespaces() };
+    totals all{ report.runtime };
+    for(auto const &[_, summary] : namespaces)
+    {
+      all.add(summary.t);
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n\"total\":{";
+    write_json_totals(out, all);
+    out << "},\n\"runtime\":{";
+    write_json_totals(out, report.runtime);
+    out << "},\n\"namespaces\":{";
+    bool first{ true };
+    for(auto const &[ns, summary] : namespaces)
+    {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      util::write_json_string(out, ns);
+      out << R"(:{"forms":)" << summary.forms << ',';
+      write_json_totals(out, summary.t);
+      out << '}';
+    }
+    out << "},\n\"slowest\":[";
+    first = true;
+    for(auto const form : slowest_forms())
+    {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      write_json_form(out, *form);
+    }
+    out << "],\n\"forms\":[";
+    first = true;
+    for(auto const &form : report.forms)
+    {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      write_json_form(out, form);
+    }
+    out << "]}\n";
+  }
+
+  static void write_text_row(std::ostream &out,
+                             std::string_view const name,
+                             usize const name_width,
+                             totals const &t)
+  {
+    out << std::left << std::setw(static_cast<int>(name_width)) << name << std::right
+        << std::setw(11) << to_ms(t.total());
+    for(usize i{}; i < phase_count; ++i)
+    {
+      out << ' ' << std::setw(11) << to_ms(t.times[i]);
+    }
+    out << ' ' << std::setw(11) << t.cpp_bytes << ' ' << std::setw(12) << t.instructions
+        << '\n';
+  }
+
+  static void write_text_header(std::ostream &out,
+                                std::string_view const name,
+                                usize const name_width)
+  {
+    out << std::left << std::setw(static_cast<int>(name_width)) << name << std::right
+        << std::setw(11) << "total ms";
+    for(usize i{}; i < phase_count; ++i)
+    {
+      out << ' ' << std::setw(11) << phase_str(static_cast<phase>(i));
+    }
+    out << ' ' << std::setw(11) << "cpp bytes" << ' ' << std::setw(12) << "instructions"
+        << '\n';
+  }
+
+  static void write_text(std::ostream &out)
+  {
+    auto const namespaces{ summarize_namespaces() };
+    totals all{ report.runtime };
+    usize name_width{ 9 };
+    for(auto const &[ns, summary] : namespaces)
+    {
+      all.add(summary.t);
+      name_width = std::max(name_width, ns.size() + 2);
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "\nCompile report (phases in ms)\n\n";
+    write_text_header(out, "namespace", name_width);
+    for(auto const &[ns, summary] : namespaces)
+    {
+      write_text_row(out, ns, name_width, summary.t);
+    }
+    write_text_row(out, "(runtime)", name_width, report.runtime);
+    write_text_row(out, "(total)", name_width, all);
+
+    auto const slowest{ slowest_forms() };
+    if(slowest.empty())
+    {
+      return;
+    }
+    out << "\nSlowest " << slowest.size() << " forms\n\n";
+    for(auto const form : slowest)
+    {
+      auto const &t{ form->t };
+      auto const slowest_phase{ std::max_element(t.times.begin(), t.times.end())
+                                - t.times.begin() };
+      out << std::setw(11) << to_ms(t.total()) << " ms  " << form->ns << ':' << form->line
+          << "  (mostly " << phase_str(static_cast<phase>(slowest_phase)) << ")\n"
+          << "             " << form->form << '\n';
+    }
+  }
+
+  void configure()
+  {
+    if(!opts.compile_report_file.empty())
+    {
+      enabled.store(true, std::memory_order_relaxed);
+      std::atexit(write);
+    }
+  }
+
+  void write()
+  {
+    if(!enabled.exchange(false))
+    {
+      return;
+    }
+
+    std::lock_guard const lock{ report.mutex };
+    if(opts.compile_report_file == "-")
+    {
+      write_text(std::cout);
+      std::cout.flush();
+      return;
+    }
+
+    std::ofstream out{ opts.compile_report_file.c_str() };
+    if(!out.is_open())
+    {
+      util::println(stderr, "Unable to open compile report file: {}", opts.compile_report_file);
+      return;
+    }
+    write_json(out);
+  }
+}
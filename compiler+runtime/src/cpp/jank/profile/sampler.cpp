@@ -0,0 +1,594 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifdef __linux__
+  #include <ucontext.h>
+#endif
+
+#include <llvm/Demangle/Demangle.h>
+
+#include <jank/profile/sampler.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::profile::sampler
+{
+  using util::cli::opts;
+
+#if(defined(__linux__) || defined(__APPLE__)) && (defined(__x86_64__) || defined(__aarch64__))
+  static constexpr bool is_supported{ true };
+#else
+  static constexpr bool is_supported{ false };
+#endif
+
+  static constexpr usize max_depth{ 128 };
+  /* A frame pointer which moves further than this isn't considered to be one. */
+  static constexpr uptr max_frame_size{ 1 << 20 };
+  static constexpr u32 max_hz{ 10'000 };
+  static constexpr std::chrono::milliseconds drain_interval{ 100 };
+
+  struct sample
+  {
+    usize depth{};
+    /* The innermost frame comes first. */
+    std::array<uptr, max_depth> pcs{};
+  };
+
+  /* Samples are recorded from within the signal handler, where we can't lock or allocate,
+   * so they go into a ring which is drained on another thread. Only one handler records
+   * at a time, so there's a single producer. */
+  struct sample_ring
+  {
+    static constexpr usize capacity{ 1 << 10 };
+
+    std::array<sample, capacity> samples{};
+    std::atomic<usize> head{};
+    std::atomic<usize> tail{};
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    /* Held for the whole of each start and stop, including joining the drain thread, so
+     * that a start can't replace a thread which a stop is still joining. */
+    std::mutex control;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    bool stopping{};
+    /* The ring and pipe are created on the first start and kept from then on, since a late
+     * signal may still be using them after we stop. */
+    std::unique_ptr<sample_ring> ring;
+    std::array<int, 2> probe_pipe{ -1, -1 };
+    /* Whatever handled SIGPROF before we started, so stopping can put it back. */
+    struct sigaction previous_action{};
+    /* Each unique stack, by address, and how many times it was sampled. */
+    std::map<std::vector<uptr>, u64> stacks;
+  } state;
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic_bool running;
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic_flag recording;
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic<u64> dropped;
+
+  struct jit_symbol
+  {
+    uptr end{};
+    std::string name;
+  };
+
+  /* Every fn is registered as it's analyzed, so this is only what's needed to name it
+   * later. Names are only formatted once something is symbolized. */
+  struct jank_fn
+  {
+    jtl::immutable_string qualified_name;
+    jtl::immutable_string file;
+    usize line{};
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    std::mutex mutex;
+    std::map<uptr, jit_symbol> symbols;
+    native_unordered_map<jtl::immutable_string, jank_fn> jank_fns;
+  } registry;
+
+  struct registers
+  {
+    uptr pc{};
+    uptr fp{};
+    uptr sp{};
+  };
+
+  static bool read_registers(void * const context, registers &regs)
+  {
+#if defined(__linux__) && defined(__x86_64__)
+    auto const &mc{ static_cast<ucontext_t *>(context)->uc_mcontext };
+    regs.pc = static_cast<uptr>(mc.gregs[REG_RIP]);
+    regs.fp = static_cast<uptr>(mc.gregs[REG_RBP]);
+    regs.sp = static_cast<uptr>(mc.gregs[REG_RSP]);
+    return true;
+#elif defined(__linux__) && defined(__aarch64__)
+    auto const &mc{ static_cast<ucontext_t *>(context)->uc_mcontext };
+    regs.pc = mc.pc;
+    regs.fp = mc.regs[29];
+    regs.sp = mc.sp;
+    return true;
+#elif defined(__APPLE__) && defined(__x86_64__)
+    auto const &ss{ static_cast<ucontext_t *>(context)->uc_mcontext->__ss };
+    regs.pc = ss.__rip;
+    regs.fp = ss.__rbp;
+    regs.sp = ss.__rsp;
+    return true;
+#elif defined(__APPLE__) && defined(__aarch64__)
+    auto const &ss{ static_cast<ucontext_t *>(context)->uc_mcontext->__ss };
+    regs.pc = __darwin_arm_thread_state64_get_pc(ss);
+    regs.fp = __darwin_arm_thread_state64_get_fp(ss);
+    regs.sp = __darwin_arm_thread_state64_get_sp(ss);
+    return true;
+#else
+    static_cast<void>(context);
+    static_cast<void>(regs);
+    return false;
+#endif
+  }
+
+  /* Code which was compiled without frame pointers uses the register for anything, so we
+   * can't just dereference it. Writing from an unreadable address into a pipe fails with
+   * EFAULT, rather than faulting, so we read each frame by way of the pipe. */
+  static bool read_frame(uptr const fp, std::array<uptr, 2> &frame)
+  {
+    auto const written{
+      ::write(state.probe_pipe[1], reinterpret_cast<void const *>(fp), sizeof(frame))
+    };
+    if(written <= 0)
+    {
+      return false;
+    }
+    auto const got{ ::read(state.probe_pipe[0], frame.data(), sizeof(frame)) };
+    return written == sizeof(frame) && got == written;
+  }
+
+  /* Each frame record holds the caller's frame pointer, followed by the return address. */
+  static void on_sigprof(int, siginfo_t *, void * const context)
+  {
+    if(!running.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    /* If another thread is already recording, this sample is dropped. */
+    if(recording.test_and_set(std::memory_order_acquire))
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    auto const saved_errno{ errno };
+
+    auto &ring{ *state.ring };
+    auto const h{ ring.head.load(std::memory_order_relaxed) };
+    registers regs;
+    if(h - ring.tail.load(std::memory_order_acquire) == sample_ring::capacity
+       || !read_registers(context, regs))
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      auto &s{ ring.samples[h % sample_ring::capacity] };
+      s.depth = 0;
+      s.pcs[s.depth++] = regs.pc;
+      for(auto fp{ regs.fp }; s.depth < max_depth;)
+      {
+        std::array<uptr, 2> frame{};
+        if(fp < regs.sp || fp % alignof(uptr) != 0 || !read_frame(fp, frame) || frame[1] == 0)
+        {
+          break;
+        }
+        s.pcs[s.depth++] = frame[1];
+        if(frame[0] <= fp || frame[0] - fp > max_frame_size)
+        {
+          break;
+        }
+        fp = frame[0];
+      }
+      ring.head.store(h + 1, std::memory_order_release);
+    }
+
+    errno = saved_errno;
+    recording.clear(std::memory_order_release);
+  }
+
+  /* Expects the state's mutex to be held. */
+  static void drain()
+  {
+    if(!state.ring)
+    {
+      return;
+    }
+
+    auto &ring{ *state.ring };
+    auto const h{ ring.head.load(std::memory_order_acquire) };
+    auto t{ ring.tail.load(std::memory_order_relaxed) };
+    for(; t != h; ++t)
+    {
+      auto const &s{ ring.samples[t % sample_ring::capacity] };
+      ++state.stacks[std::vector<uptr>(s.pcs.begin(),
+                                       s.pcs.begin() + static_cast<std::ptrdiff_t>(s.depth))];
+    }
+    ring.tail.store(t, std::memory_order_release);
+  }
+
+  static void drain_loop()
+  {
+    std::unique_lock lock{ state.mutex };
+    while(!state.stopping)
+    {
+      state.wake.wait_for(lock, drain_interval);
+      drain();
+    }
+  }
+
+  /* Expects the state's mutex to be held. */
+  static jtl::string_result<void> prepare()
+  {
+    if(!state.ring)
+    {
+      if(::pipe(state.probe_pipe.data()) != 0)
+      {
+        return err(util::format("Unable to create the sampler's pipe: {}", std::strerror(errno)));
+      }
+      for(auto const fd : state.probe_pipe)
+      {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      }
+      state.ring = std::make_unique<sample_ring>();
+    }
+
+    struct sigaction action{};
+    action.sa_sigaction = &on_sigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if(sigaction(SIGPROF, &action, &state.previous_action) != 0)
+    {
+      return err(util::format("Unable to install the SIGPROF handler: {}", std::strerror(errno)));
+    }
+
+    return ok();
+  }
+
+  jtl::string_result<void> start(u32 const hz)
+  {
+    if constexpr(!is_supported)
+    {
+      return err("Sampling isn't supported on this platform.");
+    }
+    if(hz == 0 || hz > max_hz)
+    {
+      return err(
+        util::format("Invalid sample rate '{}'. It must be from 1 to {} Hz.", hz, max_hz));
+    }
+
+    std::lock_guard const control_lock{ state.control };
+    std::lock_guard const lock{ state.mutex };
+    if(running.load(std::memory_order_acquire))
+    {
+      return err("The sampler is already running.");
+    }
+    if(auto const res{ prepare() }; res.is_err())
+    {
+      return res;
+    }
+
+    state.stopping = false;
+    running.store(true, std::memory_order_release);
+
+    /* ITIMER_PROF counts the CPU time of the whole process, so threads are sampled in
+     * proportion to how much they run and idle threads aren't sampled at all. */
+    auto const interval_us{ 1'000'000 / hz };
+    itimerval timer{};
+    timer.it_interval.tv_sec = interval_us / 1'000'000;
+    timer.it_interval.tv_usec = interval_us % 1'000'000;
+    timer.it_value = timer.it_interval;
+    if(setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+    {
+      running.store(false, std::memory_order_release);
+      sigaction(SIGPROF, &state.previous_action, nullptr);
+      return err(util::format("Unable to start the sampling timer: {}", std::strerror(errno)));
+    }
+
+    state.thread = std::thread{ drain_loop };
+    return ok();
+  }
+
+  void stop()
+  {
+    std::lock_guard const control_lock{ state.control };
+    if(!running.exchange(false))
+    {
+      return;
+    }
+
+    itimerval const timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    /* A SIGPROF from before the timer stopped may still be pending. Ignoring the signal
+     * discards it, so it can't reach the previous action, which, by default, terminates
+     * the process. */
+    struct sigaction ignore{};
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGPROF, &ignore, nullptr);
+    {
+      std::lock_guard const lock{ state.mutex };
+      state.stopping = true;
+    }
+    state.wake.notify_one();
+    state.thread.join();
+
+    /* A handler which started before we stopped may still be recording. */
+    while(recording.test(std::memory_order_acquire))
+    {
+      std::this_thread::yield();
+    }
+    sigaction(SIGPROF, &state.previous_action, nullptr);
+    std::lock_guard const lock{ state.mutex };
+    drain();
+  }
+
+  bool is_running()
+  {
+    return running.load(std::memory_order_acquire);
+  }
+
+  void clear()
+  {
+    std::lock_guard const lock{ state.mutex };
+    drain();
+    state.stacks.clear();
+    dropped.store(0, std::memory_order_relaxed);
+  }
+
+  void register_jit_symbol(uptr const start, usize const size, std::string_view const name)
+  {
+    /* Every jank fn is extern "C", so mangled C++ symbols are skipped. That keeps this
+     * small, since JIT compiled code also instantiates plenty of C++ templates. */
+    if(size == 0 || name.starts_with("_Z") || name.starts_with("__Z"))
+    {
+      return;
+    }
+
+    auto const end{ start + size };
+    std::lock_guard const lock{ registry.mutex };
+    /* Code may be linked where removed code used to be, so anything it overlaps is stale. */
+    auto it{ registry.symbols.upper_bound(start) };
+    if(it != registry.symbols.begin() && std::prev(it)->second.end > start)
+    {
+      --it;
+    }
+    while(it != registry.symbols.end() && it->first < end)
+    {
+      it = registry.symbols.erase(it);
+    }
+    registry.symbols.emplace(start, jit_symbol{ end, std::string{ name } });
+  }
+
+  void register_jank_fn(jtl::immutable_string const &munged_name,
+                        jtl::immutable_string const &qualified_name,
+                        read::source const &source)
+  {
+    jank_fn fn{ qualified_name, source.file, source.start.line };
+    std::lock_guard const lock{ registry.mutex };
+    registry.jank_fns.insert_or_assign(munged_name, std::move(fn));
+  }
+
+  static std::string describe(jank_fn const &fn)
+  {
+    auto const name{ fn.file == read::no_source_path
+                       ? fn.qualified_name
+                       : util::format("{} ({}:{})", fn.qualified_name, fn.file, fn.line) };
+    return { name.data(), name.size() };
+  }
+
+  /* Linkage names are the fn's munged unique name followed by its arity. Expects the
+   * registry's mutex to be held. */
+  static jank_fn const *find_jank_fn(std::string_view symbol)
+  {
+    if constexpr(jtl::current_platform == jtl::platform::macos_like)
+    {
+      if(symbol.starts_with('_'))
+      {
+        symbol.remove_prefix(1);
+      }
+    }
+
+    auto const arity_start{ symbol.rfind('_') };
+    if(arity_start == std::string_view::npos || arity_start + 1 == symbol.size()
+       || !std::all_of(symbol.begin() + static_cast<std::ptrdiff_t>(arity_start) + 1,
+                       symbol.end(),
+                       [](char const c) { return c >= '0' && c <= '9'; }))
+    {
+      return nullptr;
+    }
+
+    auto const found{ registry.jank_fns.find(
+      jtl::immutable_string{ symbol.data(), arity_start }) };
+    return found == registry.jank_fns.end() ? nullptr : &found->second;
+  }
+
+  static std::string to_hex(uptr const value)
+  {
+    std::array<char, sizeof(uptr) * 2> digits{};
+    auto const res{ std::to_chars(digits.data(), digits.data() + digits.size(), value, 16) };
+    return "0x" + std::string{ digits.data(), res.ptr };
+  }
+
+  static std::string symbol_name(uptr const pc)
+  {
+    std::string name;
+    {
+      std::lock_guard const lock{ registry.mutex };
+      auto it{ registry.symbols.upper_bound(pc) };
+      if(it != registry.symbols.begin() && pc < std::prev(it)->second.end)
+      {
+        auto const &symbol{ std::prev(it)->second.name };
+        auto const fn{ find_jank_fn(symbol) };
+        name = fn ? describe(*fn) : symbol;
+      }
+    }
+
+    if(name.empty())
+    {
+      Dl_info info{};
+      if(dladdr(reinterpret_cast<void *>(pc), &info) == 0)
+      {
+        name = to_hex(pc);
+      }
+      else if(info.dli_sname)
+      {
+        name = llvm::demangle(info.dli_sname);
+      }
+      else
+      {
+        std::string_view const file{ info.dli_fname ? info.dli_fname : "" };
+        name = std::string{ file.substr(file.rfind('/') + 1) } + "+"
+          + to_hex(pc - reinterpret_cast<uptr>(info.dli_fbase));
+      }
+    }
+
+    /* Folded stacks are separated by semicolons and lines. */
+    std::ranges::replace(name, ';', ':');
+    std::ranges::replace(name, '\n', ' ');
+    return name;
+  }
+
+  jtl::immutable_string symbolize(uptr const address)
+  {
+    auto const name{ symbol_name(address) };
+    return { name.data(), name.size() };
+  }
+
+  jtl::option<jtl::immutable_string> jank_fn_at(uptr const address)
+  {
+    std::lock_guard const lock{ registry.mutex };
+    auto const it{ registry.symbols.upper_bound(address) };
+    if(it == registry.symbols.begin() || address >= std::prev(it)->second.end)
+    {
+      return none;
+    }
+    auto const fn{ find_jank_fn(std::prev(it)->second.name) };
+    if(!fn)
+    {
+      return none;
+    }
+    auto const name{ describe(*fn) };
+    return jtl::immutable_string{ name.data(), name.size() };
+  }
+
+  static std::string fold()
+  {
+    std::map<std::vector<uptr>, u64> stacks;
+    {
+      std::lock_guard const lock{ state.mutex };
+      drain();
+      stacks = state.stacks;
+    }
+
+    /* Different addresses within the same fns fold into the same stack. */
+    std::unordered_map<uptr, std::string> names;
+    std::map<std::string, u64> folded;
+    for(auto const &[pcs, count] : stacks)
+    {
+      std::string line;
+      for(auto it{ pcs.rbegin() }; it != pcs.rend(); ++it)
+      {
+        /* Every frame but the innermost is a return address, which may be just past the
+         * end of its fn, if the call was the last thing in it. */
+        auto const pc{ std::next(it) == pcs.rend() ? *it : *it - 1 };
+        auto found{ names.find(pc) };
+        if(found == names.end())
+        {
+          found = names.emplace(pc, symbol_name(pc)).first;
+        }
+        if(!line.empty())
+        {
+          line += ';';
+        }
+        line += found->second;
+      }
+      folded[line] += count;
+    }
+
+    std::string ret;
+    for(auto const &[line, count] : folded)
+    {
+      ret += line;
+      ret += ' ';
+      ret += std::to_string(count);
+      ret += '\n';
+    }
+    return ret;
+  }
+
+  jtl::immutable_string folded_stacks()
+  {
+    auto const ret{ fold() };
+    return { ret.data(), ret.size() };
+  }
+
+  static void write_at_exit()
+  {
+    stop();
+
+    std::ofstream out{ opts.sample_profile_file.c_str() };
+    if(!out.is_open())
+    {
+      util::println(stderr, "Unable to open sample profile file: {}", opts.sample_profile_file);
+      return;
+    }
+    out << fold();
+
+    if(auto const count{ dropped.load(std::memory_order_relaxed) }; count != 0)
+    {
+      util::println(stderr, "The sampler dropped {} samples.", count);
+    }
+  }
+
+  void configure()
+  {
+    if(opts.sample_profile_file.empty())
+    {
+      return;
+    }
+
+    auto const res{ start(opts.sample_rate) };
+    if(res.is_err())
+    {
+      util::println(stderr, "Unable to start the sampler: {}", res.expect_err());
+      return;
+    }
+    std::atexit(write_at_exit);
+  }
+}
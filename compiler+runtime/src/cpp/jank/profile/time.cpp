@@ -1,16 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include <unistd.h>
+
+#include <jank/gc.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/cli.hpp>
+#include <jank/util/escape.hpp>
 
 namespace jank::profile
 {
   using util::cli::opts;
+  using util::cli::profiler_format;
+
+  static constexpr char const *tag{ "jank::profile" };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  std::atomic_bool enabled;
+
+  enum class event_kind : u8
+  {
+    enter,
+    exit,
+    report,
+    counter,
+    flow_start,
+    flow_end
+  };
+
+  static constexpr char const *event_kind_str(event_kind const kind)
+  {
+    switch(kind)
+    {
+      case event_kind::enter:
+        return "enter";
+      case event_kind::exit:
+        return "exit";
+      case event_kind::report:
+        return "report";
+      case event_kind::counter:
+        return "counter";
+      case event_kind::flow_start:
+        return "flow-start";
+      case event_kind::flow_end:
+        return "flow-end";
+      default:
+        return "unknown";
+    }
+  }
+
+  /* Events are fixed size, so recording one is a copy into the ring and never allocates.
+   * Region names longer than the inline storage are truncated. */
+  struct event
+  {
+    static constexpr usize max_region_size{ 128 - (sizeof(i64) * 2) - 2 };
+
+    i64 time{};
+    /* The counter value or flow id, depending on the kind. */
+    i64 value{};
+    event_kind kind{};
+    u8 region_size{};
+    std::array<char, max_region_size> region{};
+  };
+
+  /* A single producer, single consumer ring of events. Each thread records into its own
+   * ring and only the flushing thread reads from them, so neither side needs a lock. */
+  struct ring
+  {
+    static constexpr usize capacity{ 1 << 13 };
+
+    bool push(event const &e)
+    {
+      auto const h{ head.load(std::memory_order_relaxed) };
+      if(h - tail.load(std::memory_order_acquire) == capacity)
+      {
+        return false;
+      }
+      events[h % capacity] = e;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
+
+    template <typename F>
+    void drain(F &&f)
+    {
+      auto const h{ head.load(std::memory_order_acquire) };
+      auto t{ tail.load(std::memory_order_relaxed) };
+      for(; t != h; ++t)
+      {
+        f(events[t % capacity]);
+      }
+      tail.store(t, std::memory_order_release);
+    }
+
+    std::array<event, capacity> events{};
+    /* Traces need a thread id for each event, but the OS's ids aren't portable, so we just
+     * number the threads in the order they start recording. */
+    u32 thread_id{};
+    std::atomic<usize> head{};
+    std::atomic<usize> tail{};
+    /* Set once the owning thread has exited, so the ring can be dropped once it's empty. */
+    std::atomic_bool retired{};
+  };
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static struct
+  {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::shared_ptr<ring>> rings;
+    std::ofstream output;
+    std::thread thread;
+    bool stopping{};
+    pid_t pid{};
+    u32 next_thread_id{ 1 };
+    /* The GC's stats are sampled on every flush and recorded as counters when they change. */
+    usize gc_collections{};
+    usize gc_heap_size{};
+    usize gc_time_ms{};
+  } flusher;
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic<u64> flow_ids{ 1 };
+
+  /* Collections are recorded from within the GC, with its allocator lock held, so they
+   * can't go through the thread rings, which may allocate or wait for the flusher. The
+   * flusher can itself be waiting on the GC, so they get their own ring which never
+   * blocks. Only one thread collects at a time, so it's still a single producer. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static ring gc_ring;
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static i64 gc_start_time{};
 
-  static constexpr jtl::immutable_string_view tag{ "jank::profile" };
-  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-  static std::ofstream output;
+  /* The flushing thread drains the rings at least this often, so they don't fill up
+   * between flushes. */
+  static constexpr std::chrono::milliseconds flush_interval{ 10 };
 
   static auto now()
   {
@@ -18,65 +150,314 @@ namespace jank::profile
     return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
   }
 
+  /* Chrome traces are in microseconds, but we keep the nanoseconds as the fraction. */
+  static void write_micros(i64 const ns)
+  {
+    auto const fraction{ ns % 1000 };
+    flusher.output << ns / 1000 << '.' << static_cast<char>('0' + (fraction / 100))
+                   << static_cast<char>('0' + (fraction / 10 % 10))
+                   << static_cast<char>('0' + (fraction % 10));
+  }
+
+  static void write_chrome_event(event const &e, u32 const thread_id)
+  {
+    auto &out{ flusher.output };
+    out << ",\n{\"name\":";
+    util::write_json_string(out, { e.region.data(), e.region_size });
+    out << ",\"cat\":\"jank\",\"ts\":";
+    write_micros(e.time);
+    out << ",\"pid\":" << flusher.pid << ",\"tid\":" << thread_id;
+
+    switch(e.kind)
+    {
+      case event_kind::enter:
+        out << ",\"ph\":\"B\"";
+        break;
+      case event_kind::exit:
+        out << ",\"ph\":\"E\"";
+        break;
+      case event_kind::report:
+        out << ",\"ph\":\"i\",\"s\":\"t\"";
+        break;
+      case event_kind::counter:
+        out << ",\"ph\":\"C\",\"args\":{\"value\":" << e.value << '}';
+        break;
+      case event_kind::flow_start:
+        out << ",\"ph\":\"s\",\"id\":" << e.value;
+        break;
+      case event_kind::flow_end:
+        out << ",\"ph\":\"f\",\"bp\":\"e\",\"id\":" << e.value;
+        break;
+    }
+    out << '}';
+  }
+
+  static void write_text_event(event const &e)
+  {
+    flusher.output << tag << ' ' << e.time << ' ' << event_kind_str(e.kind) << ' '
+                   << std::string_view{ e.region.data(), e.region_size };
+    switch(e.kind)
+    {
+      case event_kind::counter:
+      case event_kind::flow_start:
+      case event_kind::flow_end:
+        flusher.output << ' ' << e.value;
+        break;
+      default:
+        break;
+    }
+    flusher.output << '\n';
+  }
+
+  static void write_event(event const &e, u32 const thread_id)
+  {
+    switch(opts.profiler_format)
+    {
+      case profiler_format::text:
+        write_text_event(e);
+        break;
+      case profiler_format::chrome_trace:
+        write_chrome_event(e, thread_id);
+        break;
+    }
+  }
+
+  static event make_event(event_kind const kind,
+                          jtl::immutable_string_view const &region,
+                          i64 const value)
+  {
+    event e{ now(), value, kind };
+    auto size{ std::min(region.size(), event::max_region_size) };
+    /* Don't cut a UTF-8 sequence in half, since that would make the trace invalid. */
+    while(size < region.size() && size > 0 && (region.data()[size] & 0xc0) == 0x80)
+    {
+      --size;
+    }
+    e.region_size = static_cast<u8>(size);
+    std::memcpy(e.region.data(), region.data(), size);
+    return e;
+  }
+
+  /* GC stats are recorded as process wide counters, rather than by any one thread. */
+  static void sample_gc()
+  {
+    auto const collections{ GC_get_gc_no() };
+    if(collections != flusher.gc_collections)
+    {
+      flusher.gc_collections = collections;
+      write_event(
+        make_event(event_kind::counter, "gc collections", static_cast<i64>(collections)),
+        0);
+    }
+
+    auto const time_ms{ GC_get_full_gc_total_time() };
+    if(time_ms != flusher.gc_time_ms)
+    {
+      flusher.gc_time_ms = time_ms;
+      write_event(make_event(event_kind::counter, "gc time ms", static_cast<i64>(time_ms)), 0);
+    }
+
+    auto const heap_size{ GC_get_heap_size() };
+    if(heap_size != flusher.gc_heap_size)
+    {
+      flusher.gc_heap_size = heap_size;
+      write_event(
+        make_event(event_kind::counter, "gc heap bytes", static_cast<i64>(heap_size)),
+        0);
+    }
+  }
+
+  static void GC_CALLBACK on_gc_event(GC_EventType const type)
+  {
+    switch(type)
+    {
+      case GC_EVENT_START:
+        gc_start_time = now();
+        break;
+      case GC_EVENT_END:
+        {
+          /* Both ends are pushed together, so a full ring drops the whole slice. */
+          auto const h{ gc_ring.head.load(std::memory_order_relaxed) };
+          if(ring::capacity - (h - gc_ring.tail.load(std::memory_order_acquire)) < 2)
+          {
+            return;
+          }
+          auto enter_event{ make_event(event_kind::enter, "gc", 0) };
+          enter_event.time = gc_start_time;
+          gc_ring.push(enter_event);
+          gc_ring.push(make_event(event_kind::exit, "gc", 0));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  /* Expects the flusher's mutex to be held. */
+  static void drain_rings()
+  {
+    gc_ring.drain([&](event const &e) { write_event(e, 0); });
+    for(auto const &r : flusher.rings)
+    {
+      r->drain([&](event const &e) { write_event(e, r->thread_id); });
+    }
+    std::erase_if(flusher.rings, [](auto const &r) {
+      return r->retired.load(std::memory_order_acquire)
+        && r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed);
+    });
+  }
+
+  static void flush()
+  {
+    std::unique_lock lock{ flusher.mutex };
+    while(!flusher.stopping)
+    {
+      flusher.wake.wait_for(lock, flush_interval);
+      drain_rings();
+      sample_gc();
+    }
+    drain_rings();
+    sample_gc();
+
+    if(opts.profiler_format == profiler_format::chrome_trace)
+    {
+      flusher.output << "\n]}\n";
+    }
+    flusher.output.flush();
+  }
+
+  /* Each thread's ring is registered the first time it records an event. */
+  struct thread_ring
+  {
+    thread_ring()
+      : r{ std::make_shared<ring>() }
+    {
+      std::lock_guard const lock{ flusher.mutex };
+      r->thread_id = flusher.next_thread_id++;
+      flusher.rings.emplace_back(r);
+    }
+
+    ~thread_ring()
+    {
+      r->retired.store(true, std::memory_order_release);
+    }
+
+    std::shared_ptr<ring> r;
+  };
+
+  static void
+  record(event_kind const kind, jtl::immutable_string_view const &region, i64 const value = 0)
+  {
+    thread_local thread_ring const local;
+
+    auto const e{ make_event(kind, region, value) };
+
+    /* If the flusher has fallen behind, we wait for it rather than dropping events, since a
+     * missing enter or exit would throw off every region around it. */
+    while(!local.r->push(e))
+    {
+      flusher.wake.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
   void configure()
   {
     if(opts.profiler_enabled)
     {
-      output.open(opts.profiler_file.data());
-      if(!output.is_open())
+      flusher.output.open(opts.profiler_file.data());
+      if(!flusher.output.is_open())
       {
         opts.profiler_enabled = false;
         util::println(stderr,
                       "Unable to open profile file: {}\nProfiling is now disabled.",
                       opts.profiler_file);
+        return;
       }
+
+      flusher.pid = getpid();
+      if(opts.profiler_format == profiler_format::chrome_trace)
+      {
+        flusher.output << R"({"displayTimeUnit":"ns","traceEvents":[)"
+                       << R"({"name":"process_name","ph":"M","pid":)" << flusher.pid
+                       << R"(,"args":{"name":"jank"}})";
+      }
+
+      GC_set_on_collection_event(&on_gc_event);
+      flusher.thread = std::thread{ flush };
+      enabled.store(true, std::memory_order_relaxed);
+      std::atexit(shutdown);
     }
   }
 
-  bool is_enabled()
+  void shutdown()
   {
-    return opts.profiler_enabled;
+    if(!enabled.exchange(false))
+    {
+      return;
+    }
+
+    {
+      std::lock_guard const lock{ flusher.mutex };
+      flusher.stopping = true;
+    }
+    flusher.wake.notify_one();
+    flusher.thread.join();
+    GC_set_on_collection_event(nullptr);
+    flusher.output.close();
   }
 
   void enter(jtl::immutable_string_view const &region)
   {
-    if(opts.profiler_enabled)
+    if(is_enabled())
     {
-      output << util::format("{} {} enter {}\n", tag, now(), region);
+      record(event_kind::enter, region);
     }
   }
 
   void exit(jtl::immutable_string_view const &region)
   {
-    if(opts.profiler_enabled)
+    if(is_enabled())
     {
-      output << util::format("{} {} exit {}\n", tag, now(), region);
+      record(event_kind::exit, region);
     }
   }
 
   void report(jtl::immutable_string_view const &boundary)
   {
-    if(opts.profiler_enabled)
+    if(is_enabled())
     {
-      output << util::format("{} {} report {}\n", tag, now(), boundary);
+      record(event_kind::report, boundary);
     }
   }
 
-  timer::timer(jtl::immutable_string_view const &region)
-    : region{ region }
+  void counter(jtl::immutable_string_view const &name, i64 const value)
   {
-    enter(region);
+    if(is_enabled())
+    {
+      record(event_kind::counter, name, value);
+    }
   }
 
-  timer::~timer()
-  try
+  u64 next_flow_id()
   {
-    exit(region);
+    return flow_ids.fetch_add(1, std::memory_order_relaxed);
   }
-  catch(...)
+
+  void flow_start(jtl::immutable_string_view const &name, u64 const id)
   {
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg): I need to log without exceptions. */
-    std::printf("Exception caught while destructing timer");
+    if(is_enabled())
+    {
+      record(event_kind::flow_start, name, static_cast<i64>(id));
+    }
+  }
+
+  void flow_end(jtl::immutable_string_view const &name, u64 const id)
+  {
+    if(is_enabled() && id != 0)
+    {
+      record(event_kind::flow_end, name, static_cast<i64>(id));
+    }
   }
 
   void timer::report(jtl::immutable_string_view const &boundary) const
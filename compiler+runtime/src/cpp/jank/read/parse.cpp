@@ -2,6 +2,7 @@
 
 #include <jank/read/parse.hpp>
 #include <jank/error/parse.hpp>
+#include <jank/profile/compile_report.hpp>
 #include <jank/util/escape.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
@@ -155,8 +156,13 @@ namespace jank::read::parse
     return &latest.unwrap();
   }
 
+  /* Forms are read through the iterator, so this is where each one is timed. next() calls
+   * itself for nested forms, so timing within it would time every nested form again. */
   processor::iterator &processor::iterator::operator++()
   {
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::read
+    };
     latest = some(p->next());
     return *this;
   }
@@ -1939,6 +1945,9 @@ namespace jank::read::parse
 
   processor::iterator processor::begin()
   {
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::read
+    };
     return { some(next()), this };
   }
 
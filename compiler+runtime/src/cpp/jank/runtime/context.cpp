@@ -1,7 +1,10 @@
 #include <fstream>
 
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Analysis/ModuleSummaryAnalysis.h>
+#include <llvm/Analysis/ProfileSummaryInfo.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/MC/TargetRegistry.h>
@@ -23,6 +26,7 @@
 #include <jank/analyze/pass/optimize.hpp>
 #include <jank/evaluate.hpp>
 #include <jank/jit/processor.hpp>
+#include <jank/util/arena.hpp>
 #include <jank/util/clang.hpp>
 #include <jank/util/clang_format.hpp>
 #include <jank/util/environment.hpp>
@@ -35,6 +39,7 @@
 #include <jank/error/codegen.hpp>
 #include <jank/error/runtime.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/compile_report.hpp>
 
 namespace jank::runtime
 {
@@ -187,6 +192,7 @@ namespace jank::runtime
   context::eval_string(jtl::immutable_string const &code, read::source_position const &p) const
   {
     profile::timer const timer{ "rt eval_string" };
+    profile::compile_report::frame const report_frame;
     read::lex::processor l_prc{ code, p };
     read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
 
@@ -201,13 +207,29 @@ namespace jank::runtime
       }
 
       no_op = false;
-      analyze::processor an_prc;
-      auto const expr(analyze::pass::optimize(
-        an_prc.analyze(form.expect_ok().unwrap().ptr, analyze::expression_position::statement)
-          .expect_ok()));
-      ret = evaluate::eval(expr);
+      {
+        /* Everything the compiler allocates for this form is garbage once it's evaluated. */
+        util::arena compile_arena;
+        auto const expr{ [&] {
+          profile::compile_report::phase_timer const compile_phase{
+            profile::compile_report::phase::analyze
+          };
+          analyze::processor an_prc;
+          return analyze::pass::optimize(
+            an_prc.analyze(form.expect_ok().unwrap().ptr, analyze::expression_position::statement)
+              .expect_ok());
+        }() };
+        profile::compile_report::phase_timer const compile_phase{
+          profile::compile_report::phase::eval
+        };
+        ret = evaluate::eval(expr);
+      }
 
       forms.emplace_back(form.expect_ok().unwrap().ptr);
+      if(profile::compile_report::is_enabled())
+      {
+        profile::compile_report::record_form(current_ns()->to_string(), forms.back());
+      }
     }
 
     if(no_op)
@@ -238,9 +260,15 @@ namespace jank::runtime
                                     obj::persistent_vector::empty()),
                       make_box<obj::symbol>(name)),
         make_box<obj::symbol>("fn*")) };
-      analyze::processor an_prc;
-      auto const expr(analyze::pass::optimize(
-        an_prc.analyze(form, analyze::expression_position::statement).expect_ok()));
+      util::arena compile_arena;
+      auto const expr{ [&] {
+        profile::compile_report::phase_timer const compile_phase{
+          profile::compile_report::phase::analyze
+        };
+        analyze::processor an_prc;
+        return analyze::pass::optimize(
+          an_prc.analyze(form, analyze::expression_position::statement).expect_ok());
+      }() };
       auto const fn{ static_box_cast<analyze::expr::function>(expr) };
       fn->unique_name = name;
       auto const mod{ ir::create(fn, module, codegen::compilation_target::module) };
@@ -256,7 +284,12 @@ namespace jank::runtime
       }
 
       auto const module_name{ runtime::to_string(current_module_var->deref()) };
-      auto parse_res{ jit_prc.interpreter->Parse({ code.data(), code.size() }) };
+      auto parse_res{ [&] {
+        profile::compile_report::phase_timer const compile_phase{
+          profile::compile_report::phase::clang
+        };
+        return jit_prc.interpreter->Parse({ code.data(), code.size() });
+      }() };
       if(!parse_res)
       {
         /* TODO: Helper to turn an llvm::Error into a string. */
@@ -265,11 +298,12 @@ namespace jank::runtime
         throw error::internal_codegen_failure(res);
       }
       auto &partial_tu{ parse_res.get() };
-      if(util::cli::opts.output_target != util::cli::compilation_target::cpp)
-      {
-        codegen::optimize(partial_tu.TheModule.get(), module_name);
-      }
-      write_module(module_name, code, partial_tu.TheModule.get()).expect_ok();
+      write_module(module_name,
+                   code,
+                   partial_tu.TheModule.get(),
+                   util::cli::opts.output_target != util::cli::compilation_target::cpp)
+        .expect_ok();
+      profile::compile_report::record_module(module_name);
     }
 
     return ret;
@@ -299,7 +333,7 @@ namespace jank::runtime
     if(truthy(compile_files_var->deref()))
     {
       auto module_name{ runtime::to_string(current_module_var->deref()) };
-      write_module(module_name, code, partial_tu.TheModule.get()).expect_ok();
+      write_module(module_name, code, partial_tu.TheModule.get(), false).expect_ok();
     }
 
     auto exec_res(jit_prc.interpreter->Execute(partial_tu));
@@ -513,10 +547,31 @@ namespace jank::runtime
     return ret;
   }
 
+  void context::add_module_dependency(jtl::immutable_string const &module)
+  {
+    auto const requiring_module{ current_module_var->deref() };
+    if(requiring_module.is_nil())
+    {
+      return;
+    }
+
+    auto const requiring{ runtime::to_string(requiring_module) };
+    if(requiring != module)
+    {
+      auto const locked_dependencies{ module_dependencies.wlock() };
+      auto &deps{ (*locked_dependencies)[requiring] };
+      if(std::ranges::find(deps, module) == deps.end())
+      {
+        deps.emplace_back(module);
+      }
+    }
+  }
+
   jtl::result<void, error_ref>
   context::load_module(jtl::immutable_string const &module, module::origin const ori)
   {
     auto const ns(current_ns());
+    add_module_dependency(module);
 
     /* When we load a module, the `*ns*` var is still set to the previous module.
      * In the `clojure.core/ns` macro, `in-ns` is called that sets the value of the
@@ -550,14 +605,35 @@ namespace jank::runtime
     binding_scope const preserve{ obj::persistent_hash_map::create_unique(
       std::make_pair(compile_files_var, jank_true)) };
 
-    return load_module(module, module::origin::latest);
+    auto const res{ load_module(module, module::origin::latest) };
+
+    /* Even if loading failed, we wait for what was queued, so nothing is left half written. */
+    auto const write_res{ wait_for_module_writes() };
+    if(res.is_err())
+    {
+      return res;
+    }
+    if(write_res.is_err())
+    {
+      return error::runtime_unable_to_load_module(write_res.expect_err());
+    }
+    return ok();
   }
 
   object_ref context::eval(object_ref const o)
   {
-    analyze::processor an_prc;
-    auto const expr(
-      analyze::pass::optimize(an_prc.analyze(o, analyze::expression_position::value).expect_ok()));
+    util::arena compile_arena;
+    auto const expr{ [&] {
+      profile::compile_report::phase_timer const compile_phase{
+        profile::compile_report::phase::analyze
+      };
+      analyze::processor an_prc;
+      return analyze::pass::optimize(
+        an_prc.analyze(o, analyze::expression_position::value).expect_ok());
+    }() };
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::eval
+    };
     return evaluate::eval(expr);
   }
 
@@ -585,17 +661,125 @@ namespace jank::runtime
 
     return util::cli::opts.output_module_filename.empty()
       ? util::format("{}/{}.{}",
-                     util::cli::opts.output_dir,
+                     util::cli::module_output_dir(),
                      module::module_to_path(module_name),
                      ext)
       : jtl::immutable_string{ util::cli::opts.output_module_filename };
   }
 
+  static jtl::string_result<void> emit_object_file(llvm::Module &module, std::string const &path)
+  {
+    std::error_code file_error{};
+    llvm::raw_fd_ostream os(path, file_error, llvm::sys::fs::OpenFlags::OF_None);
+    if(file_error)
+    {
+      return err(util::format("Failed to open module file '{}' with error '{}'.",
+                              path,
+                              file_error.message()));
+    }
+    //module.print(llvm::outs(), nullptr);
+
+    auto const target_triple{ util::default_target_triple() };
+    std::string target_error;
+    auto const target{ llvm::TargetRegistry::lookupTarget(target_triple.c_str(), target_error) };
+    if(!target)
+    {
+      return err(target_error);
+    }
+    llvm::TargetOptions const opt;
+    std::unique_ptr<llvm::TargetMachine> const target_machine{
+      target->createTargetMachine(llvm::Triple{ target_triple.c_str() },
+                                  "generic",
+                                  "",
+                                  opt,
+                                  llvm::Reloc::PIC_,
+                                  llvm::CodeModel::Large,
+                                  llvm::CodeGenOptLevel::Default)
+    };
+    if(!target_machine)
+    {
+      return err(util::format("Failed to create target machine for '{}'.", target_triple));
+    }
+    llvm::legacy::PassManager pass;
+
+    if(target_machine->addPassesToEmitFile(pass, os, nullptr, llvm::CodeGenFileType::ObjectFile))
+    {
+      return err(util::format("Failed to write module to object file for '{}'.", target_triple));
+    }
+
+    pass.run(module);
+    return ok();
+  }
+
+  static jtl::string_result<void> emit_bitcode_file(llvm::Module &module, std::string const &path)
+  {
+    std::error_code file_error{};
+    llvm::raw_fd_ostream os(path, file_error, llvm::sys::fs::OpenFlags::OF_None);
+    if(file_error)
+    {
+      return err(util::format("Failed to open module file '{}' with error '{}'.",
+                              path,
+                              file_error.message()));
+    }
+
+    /* ThinLTO uses a summary of each module to decide what to import across modules. */
+    if(util::cli::opts.lto == util::cli::lto_mode::thin)
+    {
+      llvm::ProfileSummaryInfo psi{ module };
+      auto const index{ llvm::buildModuleSummaryIndex(module, nullptr, &psi) };
+      llvm::WriteBitcodeToFile(module, os, false, &index);
+    }
+    else
+    {
+      llvm::WriteBitcodeToFile(module, os);
+    }
+    return ok();
+  }
+
+  /* Runs on a worker thread. The module we were given belongs to the JIT's LLVM context,
+   * which isn't thread-safe, so we get our own copy by way of bitcode. */
+  static jtl::string_result<void> write_object_module(std::string const &module_name,
+                                                      llvm::SmallVector<char, 0> const &bitcode,
+                                                      std::string const &path,
+                                                      bool const optimize)
+  {
+    /* Workers aren't compiling any one form, so this is part of the namespace. */
+    profile::compile_report::frame const report_frame{ jtl::immutable_string{ module_name } };
+    llvm::LLVMContext llvm_ctx;
+    auto parsed{ llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef{ llvm::StringRef{ bitcode.data(), bitcode.size() }, module_name },
+      llvm_ctx) };
+    if(!parsed)
+    {
+      return err(util::format("Failed to copy module '{}' with error '{}'.",
+                              module_name,
+                              llvm::toString(parsed.takeError())));
+    }
+
+    auto &module{ parsed.get() };
+    if(optimize)
+    {
+      profile::compile_report::phase_timer const compile_phase{
+        profile::compile_report::phase::optimize
+      };
+      codegen::optimize(module.get(), jtl::immutable_string{ module_name });
+    }
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::emit
+    };
+    if(util::cli::opts.lto != util::cli::lto_mode::none)
+    {
+      return emit_bitcode_file(*module, path);
+    }
+    return emit_object_file(*module, path);
+  }
+
   jtl::string_result<void> context::write_module(jtl::immutable_string const &module_name,
                                                  jtl::immutable_string const &cpp_code,
-                                                 jtl::ref<llvm::Module> const &module) const
+                                                 jtl::ref<llvm::Module> const &module,
+                                                 bool const optimize) const
   {
-    profile::timer const timer{ util::format("write_module {}", module_name) };
+    profile::timer const timer{ "write_module {}", module_name };
     std::filesystem::path const module_path{ get_output_module_name(module_name).c_str() };
     auto const &module_dir{ module_path.parent_path() };
     if(!module_dir.empty())
@@ -616,6 +800,17 @@ namespace jank::runtime
         }
       case util::cli::compilation_target::llvm_ir:
         {
+          if(optimize)
+          {
+            profile::compile_report::phase_timer const compile_phase{
+              profile::compile_report::phase::optimize
+            };
+            codegen::optimize(module, module_name);
+          }
+
+          profile::compile_report::phase_timer const compile_phase{
+            profile::compile_report::phase::emit
+          };
           std::error_code file_error{};
           llvm::raw_fd_ostream os(module_path.string(),
                                   file_error,
@@ -631,52 +826,80 @@ namespace jank::runtime
         }
       case util::cli::compilation_target::object:
         {
-          /* TODO: Is there a better place for this block of code? */
-          std::error_code file_error{};
-          llvm::raw_fd_ostream os(module_path.string(),
-                                  file_error,
-                                  llvm::sys::fs::OpenFlags::OF_None);
-          if(file_error)
-          {
-            return err(util::format("Failed to open module file '{}' with error '{}'.",
-                                    module_path.c_str(),
-                                    file_error.message()));
-          }
-          //module->print(llvm::outs(), nullptr);
-
-          auto const target_triple{ util::default_target_triple() };
-          std::string target_error;
-          auto const target{ llvm::TargetRegistry::lookupTarget(target_triple.c_str(),
-                                                                target_error) };
-          if(!target)
-          {
-            return err(target_error);
-          }
-          llvm::TargetOptions const opt;
-          auto const target_machine{ target->createTargetMachine(
-            llvm::Triple{ target_triple.c_str() },
-            "generic",
-            "",
-            opt,
-            llvm::Reloc::PIC_,
-            llvm::CodeModel::Large,
-            llvm::CodeGenOptLevel::Default) };
-          if(!target_machine)
+          llvm::SmallVector<char, 0> bitcode;
           {
-            return err(util::format("Failed to create target machine for '{}'.", target_triple));
+            llvm::raw_svector_ostream os{ bitcode };
+            llvm::WriteBitcodeToFile(*module, os);
           }
-          llvm::legacy::PassManager pass;
 
-          if(target_machine->addPassesToEmitFile(pass,
-                                                 os,
-                                                 nullptr,
-                                                 llvm::CodeGenFileType::ObjectFile))
+          std::string const path{ module_path.string() };
+          std::string const name{ module_name.data(), module_name.size() };
+          /* The hash record is built here, since the worker can't touch the loader. */
+          auto const record{ __rt_ctx->module_loader.build_hash_record(module_name) };
+          std::string hash_record{ record.data(), record.size() };
+          u64 generation{};
+          util::thread_pool *pool{};
           {
-            return err(
-              util::format("Failed to write module to object file for '{}'.", target_triple));
+            auto const locked_writes{ pending_module_writes.lock() };
+            if(!locked_writes->pool)
+            {
+              locked_writes->pool = std::make_unique<util::thread_pool>(util::cli::opts.jobs);
+            }
+            pool = locked_writes->pool.get();
+            generation = ++locked_writes->next_generation;
+            locked_writes->latest_generations[path] = generation;
           }
 
-          pass.run(*module);
+          pool->submit([this,
+                        name,
+                        path,
+                        generation,
+                        optimize,
+                        bitcode = std::move(bitcode),
+                        hash_record = std::move(hash_record)]() {
+            /* We write to a temporary file, so an older write of the same module which
+             * finishes later can't clobber this one. */
+            auto const tmp_path{ util::format("{}.{}.tmp", path, generation) };
+            auto const res{ write_object_module(name, bitcode, tmp_path.c_str(), optimize) };
+
+            auto const locked_writes{ pending_module_writes.lock() };
+            std::error_code ec;
+            if(res.is_err())
+            {
+              std::filesystem::remove(tmp_path.c_str(), ec);
+              if(locked_writes->first_error.is_none())
+              {
+                locked_writes->first_error = res.expect_err();
+              }
+            }
+            else if(locked_writes->latest_generations[path] == generation)
+            {
+              /* The old record is removed before the new module takes its place, and the new
+               * record is only moved in afterward, so a crash part way through can't pair a
+               * module with another module's record. At worst, the module is left without a
+               * record, which falls back to comparing modification times. */
+              auto const record_path{ module::hash_record_path(path) };
+              auto const tmp_record_path{ util::format("{}.{}.tmp", record_path, generation) };
+              {
+                std::ofstream ofs{ tmp_record_path.c_str() };
+                ofs << hash_record;
+              }
+              std::filesystem::remove(record_path.c_str(), ec);
+              std::filesystem::rename(tmp_path.c_str(), path, ec);
+              if(ec)
+              {
+                std::filesystem::remove(tmp_record_path.c_str(), ec);
+              }
+              else
+              {
+                std::filesystem::rename(tmp_record_path.c_str(), record_path.c_str(), ec);
+              }
+            }
+            else
+            {
+              std::filesystem::remove(tmp_path.c_str(), ec);
+            }
+          });
           return ok();
         }
       case util::cli::compilation_target::unspecified:
@@ -686,6 +909,32 @@ namespace jank::runtime
     }
   }
 
+  jtl::string_result<void> context::wait_for_module_writes() const
+  {
+    util::thread_pool *pool{};
+    {
+      auto const locked_writes{ pending_module_writes.lock() };
+      pool = locked_writes->pool.get();
+    }
+    if(!pool)
+    {
+      return ok();
+    }
+
+    /* We can't hold the lock while waiting, since each task needs it to finish. */
+    pool->wait();
+
+    auto const locked_writes{ pending_module_writes.lock() };
+    locked_writes->latest_generations.clear();
+    auto const error{ locked_writes->first_error };
+    locked_writes->first_error = none;
+    if(error.is_some())
+    {
+      return err(error.unwrap());
+    }
+    return ok();
+  }
+
   jtl::immutable_string context::unique_namespaced_string() const
   {
     return unique_namespaced_string("G_");
@@ -932,6 +1181,9 @@ namespace jank::runtime
   object_ref context::macroexpand1(object_ref const o)
   {
     profile::timer const timer{ "rt macroexpand1" };
+    profile::compile_report::phase_timer const compile_phase{
+      profile::compile_report::phase::macroexpand
+    };
     return visit_seqable(
       [this](auto const typed_o) -> object_ref {
         using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
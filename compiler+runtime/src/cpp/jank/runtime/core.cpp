@@ -102,6 +102,46 @@ namespace jank::runtime
     return make_box<obj::symbol>(ns, name);
   }
 
+  /* This only ever points to a capture on this thread's stack, so the GC finds its buffers
+   * through the stack, even though it doesn't scan thread locals. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local output_capture *current_capture{};
+
+  output_capture::output_capture()
+    : previous{ current_capture }
+  {
+    current_capture = this;
+  }
+
+  output_capture::~output_capture()
+  {
+    current_capture = previous;
+  }
+
+  output_capture *output_capture::current()
+  {
+    return current_capture;
+  }
+
+  static void write_out(jtl::immutable_string_view const &s, bool const newline)
+  {
+    if(current_capture)
+    {
+      current_capture->out(jtl::immutable_string{ s.data(), s.size() });
+      if(newline)
+      {
+        current_capture->out('\n');
+      }
+      return;
+    }
+
+    std::fwrite(s.data(), 1, s.size(), stdout);
+    if(newline)
+    {
+      std::putc('\n', stdout);
+    }
+  }
+
   object_ref print(object_ref const args)
   {
     visit_object(
@@ -117,7 +157,7 @@ namespace jank::runtime
             buff(' ');
             runtime::to_string(e.erase(), buff);
           }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
+          write_out(buff.view(), false);
         }
         else
         {
@@ -137,7 +177,7 @@ namespace jank::runtime
 
         if constexpr(std::same_as<T, obj::nil>)
         {
-          std::putc('\n', stdout);
+          write_out("", true);
         }
         else if constexpr(behavior::sequenceable<T>)
         {
@@ -148,8 +188,7 @@ namespace jank::runtime
             buff(' ');
             runtime::to_string(e.erase(), buff);
           }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
-          std::putc('\n', stdout);
+          write_out(buff.view(), true);
         }
         else
         {
@@ -176,7 +215,7 @@ namespace jank::runtime
             buff(' ');
             runtime::to_code_string(e.erase(), buff);
           }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
+          write_out(buff.view(), false);
         }
         else
         {
@@ -196,7 +235,7 @@ namespace jank::runtime
 
         if constexpr(std::same_as<T, obj::nil>)
         {
-          std::putc('\n', stdout);
+          write_out("", true);
         }
         else if constexpr(behavior::sequenceable<T>)
         {
@@ -207,8 +246,7 @@ namespace jank::runtime
             buff(' ');
             runtime::to_code_string(e.erase(), buff);
           }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
-          std::putc('\n', stdout);
+          write_out(buff.view(), true);
         }
         else
         {
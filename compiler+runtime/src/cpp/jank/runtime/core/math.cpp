@@ -394,13 +394,32 @@ namespace jank::runtime
       r);
   }
 
+  void throw_integer_overflow(char const * const op, i64 const l)
+  {
+    throw std::runtime_error{ util::format("Integer overflow in ({} {}).", op, l) };
+  }
+
+  void throw_integer_overflow(char const * const op, i64 const l, i64 const r)
+  {
+    throw std::runtime_error{ util::format("Integer overflow in ({} {} {}).", op, l, r) };
+  }
+
   object_ref inc(object_ref const l)
   {
     return visit_number_like(
       [](auto const typed_l) -> object_ref {
-        auto const ret{ make_box(typed_l->data + 1ll) };
-        object_ref r{ ret };
-        return r;
+        using T = typename decltype(typed_l)::value_type;
+
+        if constexpr(std::same_as<T, obj::integer>)
+        {
+          return make_box(runtime::inc(typed_l->data));
+        }
+        else
+        {
+          auto const ret{ make_box(typed_l->data + 1ll) };
+          object_ref r{ ret };
+          return r;
+        }
       },
       l);
   }
@@ -434,7 +453,18 @@ namespace jank::runtime
   object_ref dec(object_ref const l)
   {
     return visit_number_like(
-      [](auto const typed_l) -> object_ref { return make_box(typed_l->data - 1ll).erase(); },
+      [](auto const typed_l) -> object_ref {
+        using T = typename decltype(typed_l)::value_type;
+
+        if constexpr(std::same_as<T, obj::integer>)
+        {
+          return make_box(runtime::dec(typed_l->data));
+        }
+        else
+        {
+          return make_box(typed_l->data - 1ll).erase();
+        }
+      },
       l);
   }
 
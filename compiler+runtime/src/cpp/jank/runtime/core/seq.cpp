@@ -575,6 +575,67 @@ namespace jank::runtime
     return m->get(key, fallback);
   }
 
+  /* Returns none if the key isn't found or if the source isn't a map we handle here. The
+   * caller is expected to check the type to know the difference. */
+  static jtl::option<object_ref> keyword_find(object_ref const m, obj::keyword_ref const key)
+  {
+    if(m->type == object_type::persistent_array_map)
+    {
+      /* This already compares keywords by identity. */
+      return expect_object<obj::persistent_array_map>(m)->data.find(key);
+    }
+
+    auto const res{ expect_object<obj::persistent_hash_map>(m)->data.find(key) };
+    if(res)
+    {
+      return *res;
+    }
+    return none;
+  }
+
+  static bool is_keyword_map(object_ref const m)
+  {
+    return m->type == object_type::persistent_array_map
+      || m->type == object_type::persistent_hash_map;
+  }
+
+  object_ref keyword_get(object_ref const m, obj::keyword_ref const key)
+  {
+    if(is_keyword_map(m))
+    {
+      return keyword_find(m, key).unwrap_or(jank_nil);
+    }
+    return m->get(key);
+  }
+
+  object_ref keyword_get(object_ref const m, obj::keyword_ref const key, object_ref const fallback)
+  {
+    if(is_keyword_map(m))
+    {
+      return keyword_find(m, key).unwrap_or(fallback);
+    }
+    return m->get(key, fallback);
+  }
+
+  object_ref keyword_call(object_ref const source, obj::keyword_ref const key)
+  {
+    if(is_keyword_map(source))
+    {
+      return keyword_find(source, key).unwrap_or(jank_nil);
+    }
+    return dynamic_call(source, key);
+  }
+
+  object_ref
+  keyword_call(object_ref const source, obj::keyword_ref const key, object_ref const fallback)
+  {
+    if(is_keyword_map(source))
+    {
+      return keyword_find(source, key).unwrap_or(fallback);
+    }
+    return dynamic_call(source, key, fallback);
+  }
+
   object_ref get_in(object_ref const m, object_ref const keys)
   {
     if(m->has_behavior(object_behavior::get))
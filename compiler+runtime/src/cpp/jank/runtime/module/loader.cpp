@@ -8,6 +8,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <charconv>
 #include <filesystem>
 #include <fstream>
 #include <regex>
@@ -15,6 +16,8 @@
 #include <jankzip.h>
 
 #include <jank/type.hpp>
+#include <jank/hash.hpp>
+#include <jank/aot/resource.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/truthy.hpp>
@@ -32,6 +35,7 @@
 #include <jank/error/runtime.hpp>
 #include <jank/error/report.hpp>
 #include <jank/util/path.hpp>
+#include <jank/util/sha256.hpp>
 #include <jank/util/environment.hpp>
 #include <jank/util/fmt/print.hpp>
 
@@ -57,6 +61,11 @@ namespace jank::runtime::module
     return ret;
   }
 
+  jtl::immutable_string hash_record_path(jtl::immutable_string const &compiled_path)
+  {
+    return util::format("{}.sha256", compiled_path);
+  }
+
   jtl::immutable_string module_to_path(jtl::immutable_string const &module)
   {
     static jtl::immutable_string const dot{ "\\." };
@@ -214,6 +223,7 @@ namespace jank::runtime::module
                                                             "clojure.string-native",
                                                             "clojure.walk",
                                                             "jank.perf-native",
+                                                            "jank.gc-native",
                                                             "jank.compiler-native",
                                                             "jank.nrepl.server.inspect",
                                                             "jank.nrepl.server.core",
@@ -222,7 +232,6 @@ namespace jank::runtime::module
                                                             "jank.nrepl.server.capture",
                                                             "jank.nrepl.server.util",
                                                             "jank.nrepl.server.eval",
-                                                            "jank.nrepl.server.parsec",
                                                             "jank.nrepl.server.handler.close",
                                                             "jank.nrepl.server.handler.clone",
                                                             "jank.nrepl.server.handler.describe",
@@ -382,17 +391,187 @@ namespace jank::runtime::module
     }
   }
 
-  static void register_jar(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                           jtl::immutable_string const &path)
+  /* Opening every JAR on the module path, just to list its entries, dominates startup once
+   * there are many JARs. Since we treat JARs as immutable, we cache the entry names of each
+   * JAR within the user cache dir, keyed by the JAR's path, size, and modification time.
+   * A JAR which has changed in any of those ways is just listed again.
+   *
+   * The same records can be embedded into AOT executables, as the `module-index` resource.
+   * Each record has a header line, followed by one line per entry:
+   *
+   *   jar <size> <mtime> <path>
+   *   +<entry> */
+  struct jar_stamp
+  {
+    bool operator==(jar_stamp const &) const = default;
+
+    u64 size{};
+    i64 mtime{};
+  };
+
+  struct jar_index
+  {
+    jar_stamp stamp;
+    native_vector<jtl::immutable_string> entries;
+  };
+
+  static jtl::option<jar_stamp> stamp_jar(jtl::immutable_string const &path)
+  {
+    std::error_code ec;
+    auto const size{ std::filesystem::file_size(path.c_str(), ec) };
+    if(ec)
+    {
+      return none;
+    }
+    auto const mtime{ std::filesystem::last_write_time(path.c_str(), ec) };
+    if(ec)
+    {
+      return none;
+    }
+    return jar_stamp{ size, static_cast<i64>(mtime.time_since_epoch().count()) };
+  }
+
+  static void write_jar_index(jtl::string_builder &sb,
+                              jtl::immutable_string const &path,
+                              jar_index const &index)
+  {
+    util::format_to(sb, "jar {} {} {}\n", index.stamp.size, index.stamp.mtime, path);
+    for(auto const &entry : index.entries)
+    {
+      sb('+')(entry)('\n');
+    }
+  }
+
+  template <typename T>
+  static bool parse_index_number(std::string_view &line, T &out)
+  {
+    auto const res{ std::from_chars(line.data(), line.data() + line.size(), out) };
+    if(res.ec != std::errc{} || res.ptr == line.data() + line.size() || *res.ptr != ' ')
+    {
+      return false;
+    }
+    line.remove_prefix(res.ptr - line.data() + 1);
+    return true;
+  }
+
+  static native_unordered_map<jtl::immutable_string, jar_index>
+  parse_jar_indices(std::string_view data)
+  {
+    native_unordered_map<jtl::immutable_string, jar_index> ret;
+    jar_index *current{};
+    while(!data.empty())
+    {
+      auto const newline{ data.find('\n') };
+      auto line{ data.substr(0, newline) };
+      data.remove_prefix(newline == std::string_view::npos ? data.size() : newline + 1);
+
+      if(line.starts_with('+'))
+      {
+        if(current)
+        {
+          current->entries.emplace_back(line.data() + 1, line.size() - 1);
+        }
+      }
+      else if(line.starts_with("jar "))
+      {
+        line.remove_prefix(4);
+        jar_stamp stamp;
+        if(!parse_index_number(line, stamp.size) || !parse_index_number(line, stamp.mtime))
+        {
+          current = nullptr;
+          continue;
+        }
+        current = &ret[jtl::immutable_string{ line.data(), line.size() }];
+        *current = { stamp, {} };
+      }
+    }
+    return ret;
+  }
+
+  static jtl::immutable_string jar_index_cache_path(jtl::immutable_string const &path)
+  {
+    return util::format("{}/module-index/{}.idx",
+                        util::user_cache_dir(util::binary_version()),
+                        hash::string(path));
+  }
+
+  static jtl::option<jar_index>
+  find_jar_index(jtl::immutable_string const &path, jar_stamp const &stamp)
+  {
+    static auto const embedded{ []() {
+      auto const resource{ aot::find_resource("module-index") };
+      if(resource.is_none())
+      {
+        return native_unordered_map<jtl::immutable_string, jar_index>{};
+      }
+      return parse_jar_indices({ resource.unwrap().data(), resource.unwrap().size() });
+    }() };
+
+    auto const embedded_found{ embedded.find(path) };
+    if(embedded_found != embedded.end() && embedded_found->second.stamp == stamp)
+    {
+      return embedded_found->second;
+    }
+
+    std::ifstream ifs{ jar_index_cache_path(path).c_str(), std::ios::binary };
+    if(!ifs)
+    {
+      return none;
+    }
+    std::string const data{ std::istreambuf_iterator<char>{ ifs },
+                            std::istreambuf_iterator<char>{} };
+
+    /* The cache file name is only a hash of the path, so we need to check the path too. */
+    auto indices{ parse_jar_indices(data) };
+    auto const found{ indices.find(path) };
+    if(found == indices.end() || found->second.stamp != stamp)
+    {
+      return none;
+    }
+    return std::move(found->second);
+  }
+
+  static void cache_jar_index(jtl::immutable_string const &path, jar_index const &index)
+  {
+    std::filesystem::path const cache_path{ jar_index_cache_path(path).c_str() };
+    std::error_code ec;
+    std::filesystem::create_directories(cache_path.parent_path(), ec);
+    if(ec)
+    {
+      return;
+    }
+
+    jtl::string_builder sb;
+    write_jar_index(sb, path, index);
+
+    /* We write to a temporary file first, so other jank processes never see a partial index. */
+    auto tmp_path{ cache_path };
+    tmp_path += util::format(".{}", getpid()).c_str();
+    {
+      std::ofstream ofs{ tmp_path, std::ios::binary | std::ios::trunc };
+      ofs.write(sb.data(), static_cast<std::streamsize>(sb.size()));
+      if(!ofs)
+      {
+        ofs.close();
+        std::filesystem::remove(tmp_path, ec);
+        return;
+      }
+    }
+    std::filesystem::rename(tmp_path, cache_path, ec);
+  }
+
+  static jtl::option<native_vector<jtl::immutable_string>>
+  list_jar_entries(jtl::immutable_string const &path)
   {
     int ziperr{};
     zip_ptr const zip{ zip_openwitherror(path.c_str(), 0, 'r', &ziperr), &zip_close };
     if(ziperr < 0)
     {
       //util::println(stderr, "Failed to open jar on module path: {}\n", path);
-      return;
+      return none;
     }
 
+    native_vector<jtl::immutable_string> ret;
     auto const entry_count{ zip_entries_total(zip.get()) };
     for(ssize i{}; i < entry_count; ++i)
     {
@@ -403,10 +582,54 @@ namespace jank::runtime::module
 
         if(!is_dir)
         {
-          register_entry(entries, entry_name, { path, entry_name });
+          ret.emplace_back(entry_name);
         }
       }
     }
+    return ret;
+  }
+
+  /* Finds the index for a JAR, either from what's embedded, what's cached, or by listing
+   * the JAR and then caching the result. */
+  static jtl::option<jar_index> index_jar(jtl::immutable_string const &path)
+  {
+    auto const stamp{ stamp_jar(path) };
+    if(stamp.is_some())
+    {
+      auto cached{ find_jar_index(path, stamp.unwrap()) };
+      if(cached.is_some())
+      {
+        return cached;
+      }
+    }
+
+    auto entries{ list_jar_entries(path) };
+    if(entries.is_none())
+    {
+      return none;
+    }
+
+    jar_index ret{ stamp.unwrap_or(jar_stamp{}), std::move(entries.unwrap()) };
+    if(stamp.is_some())
+    {
+      cache_jar_index(path, ret);
+    }
+    return ret;
+  }
+
+  static void register_jar(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
+                           jtl::immutable_string const &path)
+  {
+    auto const index{ index_jar(path) };
+    if(index.is_none())
+    {
+      return;
+    }
+
+    for(auto const &entry_name : index.unwrap().entries)
+    {
+      register_entry(entries, native_transient_string{ entry_name }, { path, entry_name });
+    }
   }
 
   static void register_path(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
@@ -428,7 +651,7 @@ namespace jank::runtime::module
     }
     else if(p.extension().string() == ".jar")
     {
-      register_jar(entries, path);
+      register_jar(entries, p.string());
     }
     /* If it's not a JAR or a directory, we just add it as a direct file entry. I don't think the
      * JVM supports this, but I like that it allows us to put specific files in the path. */
@@ -498,8 +721,19 @@ namespace jank::runtime::module
     auto const locked_state{ state.lock() };
     locked_state->paths = paths;
 
+    /* We don't register the module path until the first module is found. This keeps
+     * startup quick and it gives AOT executables the chance to register their embedded
+     * module index first. */
     //util::println("module paths: {}", paths);
-    register_module_path(locked_state->entries, paths, false);
+  }
+
+  static void ensure_indexed(loader::mutable_state &state)
+  {
+    if(!state.indexed)
+    {
+      register_module_path(state.entries, state.paths, false);
+      state.indexed = true;
+    }
   }
 
   object_ref file_entry::to_runtime_data() const
@@ -865,6 +1099,7 @@ namespace jank::runtime::module
     jtl::option<loader::entry> found;
     {
       auto const locked_state{ state.lock() };
+      ensure_indexed(*locked_state);
       found = find_module(locked_state->entries, locked_state->paths, patched_module);
     }
 
@@ -940,11 +1175,14 @@ namespace jank::runtime::module
     }
 
     /* We now have the latest compiled entry. If it's up to date with
-     * the source, we can use it. Otherwise, we'll use the source. */
+     * the source, we can use it. Otherwise, we'll use the source. We prefer to know that
+     * by way of the compiled module's hash record, but older artifacts won't have one. */
     if(compiled_entry.is_some())
     {
       auto const &c_entry{ compiled_entry.unwrap() };
-      if(get_mod_time(c_entry) >= source_entry.unwrap().last_modified_at())
+      auto const matches_hashes{ matches_hash_record(patched_module, c_entry) };
+      if(matches_hashes.is_some() ? matches_hashes.unwrap()
+                                  : get_mod_time(c_entry) >= source_entry.unwrap().last_modified_at())
       {
         return find_result{ entry, compiled_type };
       }
@@ -953,6 +1191,176 @@ namespace jank::runtime::module
     return find_result{ entry, source_type };
   }
 
+  /* Identifies the current version of a source file, without reading it. For a file within
+   * a JAR, this is the JAR itself. */
+  static jtl::option<loader::source_stamp> stamp_source(file_entry const &entry)
+  {
+    std::error_code ec;
+    native_transient_string const path{ entry.archive_path.unwrap_or(entry.path) };
+    auto const modified_at{ std::filesystem::last_write_time(path, ec) };
+    if(ec)
+    {
+      return none;
+    }
+    auto const size{ std::filesystem::file_size(path, ec) };
+    if(ec)
+    {
+      return none;
+    }
+    return loader::source_stamp{ entry.archive_path.unwrap_or(""), entry.path, modified_at, size };
+  }
+
+  jtl::option<jtl::immutable_string> loader::source_hash(jtl::immutable_string const &module)
+  {
+    auto const found_module{ find(module, origin::source) };
+    if(found_module.is_err())
+    {
+      return none;
+    }
+    auto const &sources{ found_module.expect_ok().sources };
+    auto const &source{ found_module.expect_ok().to_load.unwrap() == module_type::cljc
+                          ? sources.cljc.unwrap()
+                          : sources.jank.unwrap() };
+    auto const stamp{ stamp_source(source) };
+    if(stamp.is_some())
+    {
+      auto const locked_state{ state.lock() };
+      auto const found{ locked_state->source_hashes.find(module) };
+      if(found != locked_state->source_hashes.end() && found->second.first == stamp.unwrap())
+      {
+        return found->second.second;
+      }
+    }
+
+    auto const file{ read_module(module) };
+    if(file.is_err())
+    {
+      return none;
+    }
+
+    auto const hash{ util::sha256(jtl::immutable_string{ file.expect_ok().view() }) };
+    /* A file which we couldn't stamp is hashed on every lookup. */
+    if(stamp.is_some())
+    {
+      auto const locked_state{ state.lock() };
+      locked_state->source_hashes.insert_or_assign(module, std::make_pair(stamp.unwrap(), hash));
+    }
+    return hash;
+  }
+
+  /* The hash record looks like this, with one line per transitive dependency which has
+   * a source:
+   *
+   *   binary-version <version>
+   *   source <hash>
+   *   dep <module> <hash> */
+  jtl::immutable_string loader::build_hash_record(jtl::immutable_string const &module)
+  {
+    jtl::string_builder sb;
+    util::format_to(sb, "binary-version {}\n", util::binary_version());
+    util::format_to(sb, "source {}\n", source_hash(module).unwrap_or(""));
+
+    native_set<jtl::immutable_string> visited{ module };
+    native_vector<jtl::immutable_string> pending{ module };
+    while(!pending.empty())
+    {
+      auto const current{ pending.back() };
+      pending.pop_back();
+
+      native_vector<jtl::immutable_string> deps;
+      {
+        auto const locked_dependencies{ __rt_ctx->module_dependencies.rlock() };
+        auto const found{ locked_dependencies->find(current) };
+        if(found == locked_dependencies->end())
+        {
+          continue;
+        }
+        deps = found->second;
+      }
+
+      for(auto const &dep : deps)
+      {
+        if(!visited.emplace(dep).second)
+        {
+          continue;
+        }
+        pending.emplace_back(dep);
+
+        auto const dep_hash{ source_hash(dep) };
+        if(dep_hash.is_some())
+        {
+          util::format_to(sb, "dep {} {}\n", dep, dep_hash.unwrap());
+        }
+      }
+    }
+
+    return sb.release();
+  }
+
+  jtl::option<bool>
+  loader::matches_hash_record(jtl::immutable_string const &module, file_entry const &compiled)
+  {
+    if(compiled.archive_path.is_some())
+    {
+      return none;
+    }
+
+    std::ifstream ifs{ hash_record_path(compiled.path).c_str() };
+    if(!ifs)
+    {
+      return none;
+    }
+
+    auto const matches{ [](std::string_view const recorded, jtl::immutable_string const &hash) {
+      return recorded == std::string_view{ hash.data(), hash.size() };
+    } };
+
+    std::string line;
+    while(std::getline(ifs, line))
+    {
+      std::string_view view{ line };
+      auto const separator{ view.find(' ') };
+      if(separator == std::string_view::npos)
+      {
+        return false;
+      }
+      auto const kind{ view.substr(0, separator) };
+      view.remove_prefix(separator + 1);
+
+      if(kind == "binary-version")
+      {
+        if(!matches(view, util::binary_version()))
+        {
+          return false;
+        }
+      }
+      else if(kind == "source")
+      {
+        auto const hash{ source_hash(module) };
+        if(hash.is_none() || !matches(view, hash.unwrap()))
+        {
+          return false;
+        }
+      }
+      else if(kind == "dep")
+      {
+        auto const dep_separator{ view.find(' ') };
+        if(dep_separator == std::string_view::npos)
+        {
+          return false;
+        }
+        jtl::immutable_string const dep{ view.data(), dep_separator };
+        auto const hash{ source_hash(dep) };
+        if(hash.is_none() || !matches(view.substr(dep_separator + 1), hash.unwrap()))
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
   bool loader::is_loaded(jtl::immutable_string const &module)
   {
     auto const atom{
@@ -1060,8 +1468,18 @@ namespace jank::runtime::module
     util::println("Loading module '{}' from a managed load fn.", module);
   }
 
+  /* Feeds the profiler's counter track of loaded modules. */
+  static void count_module_load()
+  {
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    static std::atomic<i64> loaded;
+    profile::counter("modules loaded", ++loaded);
+  }
+
   jtl::result<void, error_ref> loader::load(jtl::immutable_string const &module, origin const ori)
   {
+    profile::timer const timer{ "load module {}", module };
+
     {
       /* If a load fn has been provided for this module already, just skip right to
        * calling it. */
@@ -1072,6 +1490,7 @@ namespace jank::runtime::module
         //log_managed_load(module);
         (*managed_load_fn->second)();
         set_is_loaded(module);
+        count_module_load();
         return ok();
       }
     }
@@ -1114,6 +1533,7 @@ namespace jank::runtime::module
     }
 
     set_is_loaded(module);
+    count_module_load();
 
     return ok();
   }
@@ -1121,7 +1541,7 @@ namespace jank::runtime::module
   jtl::result<void, error_ref>
   loader::load_o(jtl::immutable_string const &module, file_entry const &entry) const
   {
-    profile::timer const timer{ util::format("load object {}", module) };
+    profile::timer const timer{ "load object {}", module };
 
     /* While loading an object, if the main ns loading symbol exists, then
      * we don't need to load the object file again.
@@ -1201,7 +1621,56 @@ namespace jank::runtime::module
     sb(module_separator);
     sb(path);
     locked_state->paths = sb.release();
-    register_path(locked_state->entries, path);
+
+    /* If we haven't indexed yet, this path will be registered along with the rest. */
+    if(locked_state->indexed)
+    {
+      register_path(locked_state->entries, path);
+    }
+  }
+
+  jtl::immutable_string loader::build_jar_index()
+  {
+    jtl::immutable_string paths;
+    {
+      auto const locked_state{ state.lock() };
+      paths = locked_state->paths;
+    }
+
+    /* This header just ensures the index is never empty, which is easier to embed. */
+    jtl::string_builder sb;
+    sb("jank-module-index\n");
+
+    std::string_view remaining{ paths.data(), paths.size() };
+    while(!remaining.empty())
+    {
+      auto const separator{ remaining.find(module_separator) };
+      auto const path{ remaining.substr(0, separator) };
+      remaining.remove_prefix(separator == std::string_view::npos ? remaining.size()
+                                                                  : separator + 1);
+
+      std::error_code ec;
+      if(!path.ends_with(".jar") || !std::filesystem::exists(path, ec))
+      {
+        continue;
+      }
+
+      jtl::immutable_string const canonical_path{
+        std::filesystem::canonical(path, ec).lexically_normal().string()
+      };
+      if(ec)
+      {
+        continue;
+      }
+
+      auto const index{ index_jar(canonical_path) };
+      if(index.is_some())
+      {
+        write_jar_index(sb, canonical_path, index.unwrap());
+      }
+    }
+
+    return sb.release();
   }
 
   void loader::add_load_fn(jtl::immutable_string const &module, jtl::ref<void()> const fn)
@@ -1213,6 +1682,8 @@ namespace jank::runtime::module
   object_ref loader::to_runtime_data() const
   {
     auto const locked_state{ state.lock() };
+    /* Until the module path is indexed, there would be no entries to show. */
+    ensure_indexed(*locked_state);
     runtime::object_ref entry_maps(make_box<runtime::obj::persistent_array_map>());
     for(auto const &e : locked_state->entries)
     {
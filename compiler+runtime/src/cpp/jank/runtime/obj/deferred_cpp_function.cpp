@@ -10,6 +10,7 @@
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/call.hpp>
 #include <jank/util/fmt/print.hpp>
+#include <jank/profile/time.hpp>
 
 namespace jank::runtime::obj
 {
@@ -27,6 +28,11 @@ namespace jank::runtime::obj
     , base_name{ base_name }
     , arities{ arities }
   {
+    if(profile::is_enabled())
+    {
+      flow_id = profile::next_flow_id();
+      profile::flow_start("deferred compile", flow_id);
+    }
   }
 
   void deferred_cpp_function::to_string(jtl::string_builder &buff) const
@@ -42,13 +48,18 @@ namespace jank::runtime::obj
 
   object_ref deferred_cpp_function::call(object_ref const args) const
   {
-    std::lock_guard<std::recursive_mutex> const lock{ compilation_mutex };
     /* It's possible that we're called again, even after we've compiled our actual function.
      * This can happen if the value of this function is captured, rather than used directly
      * through a var. In that case, we just proxy the args on to the compiled fn. */
+    return apply_to(compile(), args);
+  }
+
+  jit_function_ref deferred_cpp_function::compile() const
+  {
+    std::lock_guard<std::recursive_mutex> const lock{ compilation_mutex };
     if(compiled_fn.is_some())
     {
-      return apply_to(compiled_fn, args);
+      return compiled_fn;
     }
 
     // auto const name(meta->get(__rt_ctx->intern_keyword("name").expect_ok()));
@@ -56,8 +67,11 @@ namespace jank::runtime::obj
     //  "lazily creating {}",
     //  (name->type == object_type::nil ? "unknown" : try_object<persistent_string>(name)->data));
 
-    /* On the first invocation, we don't have a compiled_fn. We compile our C++ code, get a fn,
-     * rebind the root of the var, and then apply our args to the new fn.*/
+    profile::timer const timer{ "deferred compile {}", base_name };
+    profile::flow_end("deferred compile", flow_id);
+
+    /* On the first invocation, we don't have a compiled_fn. We compile our C++ code, get a fn
+     * and rebind the root of the var. */
     __rt_ctx->jit_prc.eval_string(declaration_code);
     compiled_fn = __rt_ctx->jit_prc.create_function(arity_flags, base_name, arities);
     compiled_fn->meta = meta;
@@ -66,7 +80,7 @@ namespace jank::runtime::obj
     /* Clear these just to free up some memory. */
     declaration_code = "";
 
-    return apply_to(compiled_fn, args);
+    return compiled_fn;
   }
 
   callable_arity_flags deferred_cpp_function::get_arity_flags() const
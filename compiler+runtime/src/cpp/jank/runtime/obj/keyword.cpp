@@ -13,6 +13,7 @@ namespace jank::runtime::obj
   keyword::keyword(runtime::detail::must_be_interned, jtl::immutable_string_view const &s)
     : object{ obj_type, obj_behaviors }
     , sym{ make_box<obj::symbol>(s) }
+    , hash{ sym->to_hash() + hash_magic }
   {
   }
 
@@ -21,6 +22,7 @@ namespace jank::runtime::obj
                    jtl::immutable_string_view const &n)
     : object{ obj_type, obj_behaviors }
     , sym{ make_box<obj::symbol>(ns, n) }
+    , hash{ sym->to_hash() + hash_magic }
   {
   }
 
@@ -44,7 +46,7 @@ namespace jank::runtime::obj
 
   uhash keyword::to_hash() const
   {
-    return sym->to_hash() + 0x9e3779b9;
+    return hash;
   }
 
   i64 keyword::compare(object const &o) const
@@ -7,12 +7,18 @@
 
 namespace jank::runtime::obj
 {
+  /* UUIDs are just bytes, so there's no need for the GC to scan them. */
+  static jtl::ref<uuids::uuid> make_uuid(uuids::uuid const &value)
+  {
+    return new(PointerFreeGC) uuids::uuid{ value };
+  }
+
   static jtl::ref<uuids::uuid> random()
   {
     static std::random_device rd;
     std::mt19937 g(rd());
     uuids::uuid_random_generator gen{ g };
-    return jtl::make_ref<uuids::uuid>(gen());
+    return make_uuid(gen());
   }
 
   static jtl::ref<uuids::uuid> from_string(jtl::immutable_string const &s)
@@ -20,7 +26,7 @@ namespace jank::runtime::obj
     auto const result{ uuids::uuid::from_string(s.c_str()) };
     if(result)
     {
-      return jtl::make_ref<uuids::uuid>(result.value());
+      return make_uuid(result.value());
     }
     else
     {
@@ -1,36 +1,554 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <ranges>
+
 #include <nanobench.h>
 
+#include <jtl/string_builder.hpp>
+
+#include <jank/gc.hpp>
 #include <jank/runtime/perf.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/math.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/module/loader.hpp>
+#include <jank/profile/allocations.hpp>
+#include <jank/profile/sampler.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/escape.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime::perf
 {
+  struct time_unit
+  {
+    char const *name;
+    std::chrono::duration<f64> duration;
+  };
+
+  static time_unit parse_unit(jtl::immutable_string const &name)
+  {
+    using namespace std::chrono;
+    if(name == "ns")
+    {
+      return { "ns", nanoseconds{ 1 } };
+    }
+    else if(name == "us")
+    {
+      return { "us", microseconds{ 1 } };
+    }
+    else if(name == "ms")
+    {
+      return { "ms", milliseconds{ 1 } };
+    }
+    else if(name == "s")
+    {
+      return { "s", seconds{ 1 } };
+    }
+    throw std::runtime_error{ util::format("Invalid benchmark unit '{}'.", name) };
+  }
+
+  /* Units can be given as keywords, like :ns, or as strings. */
+  static time_unit unit_of(object_ref const unit)
+  {
+    if(unit.is_nil())
+    {
+      return parse_unit("ms");
+    }
+    if(unit->type == object_type::keyword)
+    {
+      return parse_unit(expect_object<obj::keyword>(unit)->sym->name);
+    }
+    return parse_unit(to_string(unit));
+  }
+
+  static obj::keyword_ref kw(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  static object_ref get_opt(object_ref const opts, char const * const name)
+  {
+    return get(opts, kw(name));
+  }
+
+  static i64 get_int_opt(object_ref const opts, char const * const name, i64 const fallback)
+  {
+    auto const value{ get_opt(opts, name) };
+    return value.is_nil() ? fallback : to_int(value);
+  }
+
+  /* Linearly interpolates between the closest ranks, so small sample counts still give a
+   * sensible answer. Expects sorted samples. */
+  static f64 percentile(std::vector<f64> const &samples, f64 const p)
+  {
+    auto const rank{ p * static_cast<f64>(samples.size() - 1) };
+    auto const lower{ static_cast<usize>(std::floor(rank)) };
+    auto const upper{ std::min(lower + 1, samples.size() - 1) };
+    return samples[lower] + ((rank - static_cast<f64>(lower)) * (samples[upper] - samples[lower]));
+  }
+
+  /* Outliers are classified like criterium does, using Tukey's fences: anything more than
+   * 1.5 IQRs past the quartiles is mild and more than 3 IQRs is severe. */
+  static object_ref classify_outliers(std::vector<f64> const &samples)
+  {
+    auto const q1{ percentile(samples, 0.25) };
+    auto const q3{ percentile(samples, 0.75) };
+    auto const iqr{ q3 - q1 };
+    i64 low_severe{}, low_mild{}, high_mild{}, high_severe{};
+    for(auto const s : samples)
+    {
+      if(s < q1 - (3 * iqr))
+      {
+        ++low_severe;
+      }
+      else if(s < q1 - (1.5 * iqr))
+      {
+        ++low_mild;
+      }
+      else if(s > q3 + (3 * iqr))
+      {
+        ++high_severe;
+      }
+      else if(s > q3 + (1.5 * iqr))
+      {
+        ++high_mild;
+      }
+    }
+
+    runtime::detail::native_transient_hash_map ret;
+    ret.set(kw("low-severe"), make_box(low_severe));
+    ret.set(kw("low-mild"), make_box(low_mild));
+    ret.set(kw("high-mild"), make_box(high_mild));
+    ret.set(kw("high-severe"), make_box(high_severe));
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  static f64 unit_scale(object_ref const result)
+  {
+    return unit_of(get_opt(result, "unit")).duration.count();
+  }
+
+  static object_ref load_baseline(object_ref const baseline)
+  {
+    if(baseline->type != object_type::persistent_string)
+    {
+      return baseline;
+    }
+
+    auto const path{ expect_object<obj::persistent_string>(baseline)->data };
+    auto const file{ module::loader::read_file(path) };
+    if(file.is_err())
+    {
+      throw file.expect_err();
+    }
+    return __rt_ctx->read_string(jtl::immutable_string{ file.expect_ok().data(),
+                                                        file.expect_ok().size() });
+  }
+
+  /* Baselines are compared by their medians, since they're the least sensitive to noise.
+   * The baseline may have been recorded with another unit. */
+  static object_ref compare_to_baseline(object_ref const opts, object_ref const result)
+  {
+    auto const baseline{ load_baseline(get_opt(opts, "baseline")) };
+    auto const threshold_opt{ get_opt(opts, "threshold") };
+    auto const threshold{ threshold_opt.is_nil() ? 0.05 : to_real(threshold_opt) };
+
+    auto const median{ to_real(get_opt(result, "median")) * unit_scale(result) };
+    auto const baseline_median{ to_real(get_opt(baseline, "median")) * unit_scale(baseline) };
+    auto const change{ (median / baseline_median) - 1.0 };
+
+    runtime::detail::native_transient_hash_map ret;
+    ret.set(kw("median"), get_opt(baseline, "median"));
+    ret.set(kw("unit"), get_opt(baseline, "unit"));
+    ret.set(kw("change"), make_box(change));
+    ret.set(kw("regression?"), make_box(change > threshold));
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  static void write_json(std::ostream &out, object_ref const o)
+  {
+    switch(o->type)
+    {
+      case object_type::nil:
+        out << "null";
+        return;
+      case object_type::boolean:
+      case object_type::integer:
+        out << to_string(o);
+        return;
+      case object_type::real:
+        {
+          auto const d{ expect_object<obj::real>(o)->data };
+          if(std::isfinite(d))
+          {
+            out << to_string(o);
+          }
+          else
+          {
+            out << "null";
+          }
+          return;
+        }
+      case object_type::keyword:
+        {
+          auto const &name{ expect_object<obj::keyword>(o)->sym->name };
+          util::write_json_string(out, { name.data(), name.size() });
+          return;
+        }
+      default:
+        break;
+    }
+
+    if(is_map(o))
+    {
+      out << '{';
+      bool first_entry{ true };
+      for(auto it{ seq(o) }; it.is_some(); it = next(it))
+      {
+        auto const entry{ first(it) };
+        if(!first_entry)
+        {
+          out << ',';
+        }
+        first_entry = false;
+        write_json(out, first(entry));
+        out << ':';
+        write_json(out, second(entry));
+      }
+      out << '}';
+      return;
+    }
+
+    auto const s{ to_string(o) };
+    util::write_json_string(out, { s.data(), s.size() });
+  }
+
+  /* A pipe would end the cell and a newline would end the row, so neither can be left as
+   * they are. */
+  static jtl::immutable_string markdown_cell(object_ref const o)
+  {
+    jtl::string_builder sb;
+    for(auto const c : to_string(o))
+    {
+      if(c == '|')
+      {
+        sb("\\|");
+      }
+      else if(c == '\n' || c == '\r')
+      {
+        sb(' ');
+      }
+      else
+      {
+        sb(c);
+      }
+    }
+    return sb.release();
+  }
+
+  static void write_markdown(std::ostream &out, object_ref const result)
+  {
+    auto const outliers{ get_opt(result, "outliers") };
+    out << "| label | unit | mean | median | p99 | stddev | outliers | bytes/op |\n"
+        << "|---|---|---:|---:|---:|---:|---:|---:|\n";
+    out << util::format("| {} | {} | {} | {} | {} | {} | {} | {} |\n",
+                        markdown_cell(get_opt(result, "label")),
+                        markdown_cell(get_opt(result, "unit")),
+                        to_string(get_opt(result, "mean")),
+                        to_string(get_opt(result, "median")),
+                        to_string(get_opt(result, "p99")),
+                        to_string(get_opt(result, "stddev")),
+                        to_int(get_opt(outliers, "low-severe"))
+                          + to_int(get_opt(outliers, "low-mild"))
+                          + to_int(get_opt(outliers, "high-mild"))
+                          + to_int(get_opt(outliers, "high-severe")),
+                        to_string(get_opt(result, "bytes-per-op")));
+  }
+
+  /* The format is picked from the extension. EDN output can be given back as a baseline. */
+  static void write_output(jtl::immutable_string const &path, object_ref const result)
+  {
+    std::ofstream out{ path.c_str() };
+    if(!out)
+    {
+      throw std::runtime_error{ util::format("Unable to open benchmark output file '{}'.",
+                                             path) };
+    }
+
+    if(path.ends_with(".edn"))
+    {
+      out << to_code_string(result) << '\n';
+    }
+    else if(path.ends_with(".json"))
+    {
+      write_json(out, result);
+      out << '\n';
+    }
+    else if(path.ends_with(".md"))
+    {
+      write_markdown(out, result);
+    }
+    else
+    {
+      throw std::runtime_error{ util::format(
+        "Unknown benchmark output format for '{}'. Expected .edn, .json, or .md.",
+        path) };
+    }
+  }
+
   object_ref benchmark(object_ref const opts, object_ref const f)
   {
-    auto const label(get(opts, __rt_ctx->intern_keyword("label").expect_ok()));
+    auto const label(get_opt(opts, "label"));
     auto const label_str(to_string(label));
-    ankerl::nanobench::Config config;
-    config.mOut = &std::cout;
-
-    /* Larger things. */
-    config.mTimeUnitName = "ms";
-    config.mTimeUnit = std::chrono::milliseconds{ 1 };
-    config.mMinEpochIterations = 20;
-    config.mWarmup = 10;
-
-    /* Smaller things. */
-    //config.mTimeUnitName = "ns";
-    //config.mTimeUnit = std::chrono::nanoseconds{ 1 };
-    //config.mMinEpochIterations = 1000000;
-    //config.mWarmup = 1000;
-
-    ankerl::nanobench::Bench().config(config).run(static_cast<std::string>(label_str), [&] {
+    auto const unit{ unit_of(get_opt(opts, "unit")) };
+    auto const samples{ get_int_opt(opts, "samples", 11) };
+    auto const target_ms{ get_int_opt(opts, "target-ms", 0) };
+
+    ankerl::nanobench::Bench bench;
+    bench.timeUnit(unit.duration, unit.name)
+      .warmup(static_cast<u64>(get_int_opt(opts, "warmup", 10)))
+      .epochs(static_cast<usize>(std::max<i64>(samples, 1)))
+      .minEpochIterations(static_cast<u64>(get_int_opt(opts, "min-iterations", 20)))
+      .output(truthy(get_opt(opts, "quiet?")) ? nullptr : &std::cout);
+    if(target_ms > 0)
+    {
+      /* The target is for the whole benchmark, so it's split across the samples. */
+      bench.minEpochTime(std::chrono::milliseconds{ target_ms } / std::max<i64>(samples, 1));
+    }
+
+    bench.run(static_cast<std::string>(label_str), [&] {
       auto const res(f->call());
       ankerl::nanobench::doNotOptimizeAway(res);
     });
-    return {};
+
+    /* Each sample is the mean time of one op within an epoch, in seconds. */
+    auto const &measured{ bench.results().back() };
+    auto const scale{ 1.0 / unit.duration.count() };
+    std::vector<f64> sorted;
+    f64 total_iterations{};
+    for(usize i{}; i < measured.size(); ++i)
+    {
+      sorted.emplace_back(measured.get(i, ankerl::nanobench::Result::Measure::elapsed) * scale);
+      total_iterations += measured.get(i, ankerl::nanobench::Result::Measure::iterations);
+    }
+    std::ranges::sort(sorted);
+
+    f64 sum{};
+    for(auto const s : sorted)
+    {
+      sum += s;
+    }
+    auto const mean{ sum / static_cast<f64>(sorted.size()) };
+    f64 variance{};
+    for(auto const s : sorted)
+    {
+      variance += (s - mean) * (s - mean);
+    }
+    variance /= static_cast<f64>(std::max<usize>(sorted.size() - 1, 1));
+
+    /* Allocations are measured in a separate run, so the benchmark's own bookkeeping and
+     * warmup aren't counted. */
+    auto const alloc_iterations{ std::max<i64>(
+      static_cast<i64>(total_iterations / static_cast<f64>(sorted.size())),
+      1) };
+    auto const bytes_before{ GC_get_total_bytes() };
+    auto const collections_before{ GC_get_gc_no() };
+    for(i64 i{}; i < alloc_iterations; ++i)
+    {
+      ankerl::nanobench::doNotOptimizeAway(f->call());
+    }
+    auto const bytes_per_op{ static_cast<f64>(GC_get_total_bytes() - bytes_before)
+                             / static_cast<f64>(alloc_iterations) };
+    auto const collections{ GC_get_gc_no() - collections_before };
+
+    runtime::detail::native_transient_hash_map ret;
+    ret.set(kw("label"), make_box(label_str));
+    ret.set(kw("unit"), make_box(unit.name));
+    ret.set(kw("samples"), make_box(static_cast<i64>(sorted.size())));
+    ret.set(kw("iterations"), make_box(static_cast<i64>(total_iterations)));
+    ret.set(kw("mean"), make_box(mean));
+    ret.set(kw("median"), make_box(percentile(sorted, 0.5)));
+    ret.set(kw("p99"), make_box(percentile(sorted, 0.99)));
+    ret.set(kw("stddev"), make_box(std::sqrt(variance)));
+    ret.set(kw("min"), make_box(sorted.front()));
+    ret.set(kw("max"), make_box(sorted.back()));
+    ret.set(kw("outliers"), classify_outliers(sorted));
+    ret.set(kw("bytes-per-op"), make_box(bytes_per_op));
+    ret.set(kw("collections"), make_box(static_cast<i64>(collections)));
+    object_ref result{ make_box<obj::persistent_hash_map>(ret.persistent()) };
+
+    if(!get_opt(opts, "baseline").is_nil())
+    {
+      auto const comparison{ compare_to_baseline(opts, result) };
+      result = assoc(result, kw("baseline"), comparison);
+
+      if(truthy(get_opt(comparison, "regression?"))
+         && truthy(get_opt(opts, "fail-on-regression?")))
+      {
+        throw std::runtime_error{ util::format(
+          "Benchmark '{}' regressed by {}% against its baseline.",
+          label_str,
+          std::round(to_real(get_opt(comparison, "change")) * 100)) };
+      }
+    }
+
+    auto const output{ get_opt(opts, "output") };
+    if(!output.is_nil())
+    {
+      write_output(to_string(output), result);
+    }
+
+    return result;
+  }
+
+  object_ref start_sampling(object_ref const opts)
+  {
+    auto const hz{ get_int_opt(opts, "hz", util::cli::opts.sample_rate) };
+    if(hz < 1 || hz > std::numeric_limits<u32>::max())
+    {
+      throw std::runtime_error{ util::format("Invalid sample rate '{}'.", hz) };
+    }
+
+    auto const res{ profile::sampler::start(static_cast<u32>(hz)) };
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err() };
+    }
+    return jank_nil;
+  }
+
+  object_ref stop_sampling()
+  {
+    profile::sampler::stop();
+    return folded_stacks();
+  }
+
+  object_ref is_sampling()
+  {
+    return make_box(profile::sampler::is_running());
+  }
+
+  object_ref folded_stacks()
+  {
+    return make_box(profile::sampler::folded_stacks());
+  }
+
+  object_ref clear_samples()
+  {
+    profile::sampler::clear();
+    return jank_nil;
+  }
+
+  object_ref start_allocation_profile(object_ref const opts)
+  {
+    auto const interval{ get_int_opt(opts, "interval", util::cli::opts.alloc_sample_interval) };
+    if(interval < 1 || interval > std::numeric_limits<u32>::max())
+    {
+      throw std::runtime_error{ util::format("Invalid allocation sample interval '{}'.",
+                                             interval) };
+    }
+
+    auto const res{ profile::allocations::start(static_cast<u32>(interval)) };
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err() };
+    }
+    return jank_nil;
+  }
+
+  object_ref stop_allocation_profile()
+  {
+    profile::allocations::stop();
+    return jank_nil;
+  }
+
+  object_ref allocation_sites(object_ref const opts)
+  {
+    /* Sites already come with the most bytes first. */
+    auto sites{ profile::allocations::sites() };
+    auto const sort_by{ get_opt(opts, "sort-by") };
+    if(equal(sort_by, kw("count")))
+    {
+      std::ranges::stable_sort(sites, [](auto const &lhs, auto const &rhs) {
+        return lhs.count > rhs.count;
+      });
+    }
+    else if(!sort_by.is_nil() && !equal(sort_by, kw("bytes")))
+    {
+      throw std::runtime_error{ util::format(
+        "Invalid allocation site sort '{}'. Expected :bytes or :count.",
+        to_code_string(sort_by)) };
+    }
+    auto const limit{ get_int_opt(opts, "limit", 20) };
+    if(limit < 0)
+    {
+      throw std::runtime_error{ util::format("Invalid allocation site limit '{}'.", limit) };
+    }
+
+    auto const seconds{ std::max(profile::allocations::elapsed_seconds(), 1e-9) };
+    runtime::detail::native_transient_vector ret;
+    for(auto const &site : sites | std::views::take(limit))
+    {
+      runtime::detail::native_transient_hash_map entry;
+      entry.set(kw("type"), kw(object_type_str(site.type)));
+      object_ref fn{};
+      if(site.jank_fn.is_some())
+      {
+        fn = make_box(site.jank_fn.unwrap());
+      }
+      entry.set(kw("fn"), fn);
+      entry.set(kw("caller"), make_box(site.caller));
+      entry.set(kw("address"), make_box(static_cast<i64>(site.address)));
+      entry.set(kw("count"), make_box(static_cast<i64>(site.count)));
+      entry.set(kw("bytes"), make_box(static_cast<i64>(site.bytes)));
+      entry.set(kw("bytes-per-second"), make_box(static_cast<f64>(site.bytes) / seconds));
+      ret.push_back(make_box<obj::persistent_hash_map>(entry.persistent()));
+    }
+    return make_box<obj::persistent_vector>(ret.persistent());
+  }
+
+  object_ref allocation_types()
+  {
+    std::map<object_type, std::pair<u64, u64>> by_type;
+    for(auto const &site : profile::allocations::sites())
+    {
+      auto &[count, bytes]{ by_type[site.type] };
+      count += site.count;
+      bytes += site.bytes;
+    }
+
+    auto const seconds{ std::max(profile::allocations::elapsed_seconds(), 1e-9) };
+    runtime::detail::native_transient_hash_map ret;
+    for(auto const &[type, totals] : by_type)
+    {
+      ret.set(kw(object_type_str(type)),
+              obj::persistent_hash_map::create_unique(
+                std::make_pair(kw("count"), make_box(static_cast<i64>(totals.first))),
+                std::make_pair(kw("bytes"), make_box(static_cast<i64>(totals.second))),
+                std::make_pair(kw("bytes-per-second"),
+                               make_box(static_cast<f64>(totals.second) / seconds))));
+    }
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  object_ref clear_allocations()
+  {
+    profile::allocations::clear();
+    return jank_nil;
   }
 }
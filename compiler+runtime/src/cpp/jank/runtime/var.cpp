@@ -100,6 +100,7 @@ namespace jank::runtime
   {
     profile::timer const timer{ "var bind_root" };
     *root.wlock() = r;
+    ++root_version;
     return this;
   }
 
@@ -107,6 +108,7 @@ namespace jank::runtime
   {
     auto locked_root(root.wlock());
     *locked_root = apply_to(f, cons(*locked_root, args));
+    ++root_version;
     return *locked_root;
   }
 
@@ -132,6 +134,7 @@ namespace jank::runtime
   var_ref var::set_dynamic(bool const dyn)
   {
     dynamic.store(dyn);
+    ++root_version;
     return this;
   }
 
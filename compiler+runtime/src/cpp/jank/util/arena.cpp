@@ -0,0 +1,65 @@
+#include <jank/gc.hpp>
+#include <jank/util/arena.hpp>
+
+namespace jank::util
+{
+  /* This only ever points to an arena on this thread's stack, so the GC finds the chunks
+   * through the stack, even though it doesn't scan thread locals. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local arena *current_arena{};
+
+  arena::arena()
+    : active{ GC_get_all_interior_pointers() != 0 }
+  {
+    if(active)
+    {
+      previous = current_arena;
+      current_arena = this;
+    }
+  }
+
+  arena::~arena()
+  {
+    if(active)
+    {
+      current_arena = previous;
+    }
+  }
+
+  arena *arena::current()
+  {
+    return current_arena;
+  }
+
+  static char *align_up(char * const p, usize const alignment)
+  {
+    auto const addr{ reinterpret_cast<uptr>(p) };
+    return reinterpret_cast<char *>((addr + alignment - 1) & ~(alignment - 1));
+  }
+
+  void *arena::allocate(usize const size, usize const alignment)
+  {
+    auto aligned{ align_up(pos, alignment) };
+    if(!pos || aligned + size > end)
+    {
+      if(size > max_inline_size)
+      {
+        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
+        return GC_malloc(size);
+      }
+
+      /* Earlier chunks aren't linked from the new one. Each is kept alive only by the
+       * allocations within it which are still referenced, so a chunk whose allocations are
+       * all garbage can be collected while the arena carries on. */
+      /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
+      auto const next{ static_cast<char *>(GC_malloc(chunk_size)) };
+      chunk = next;
+      pos = next;
+      end = next + chunk_size;
+      aligned = align_up(pos, alignment);
+    }
+
+    pos = aligned + size;
+    return aligned;
+  }
+}
@@ -1,3 +1,8 @@
+#include <charconv>
+#include <filesystem>
+#include <limits>
+#include <string_view>
+
 #include <jank/util/cli.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/runtime/module/loader.hpp>
@@ -121,20 +126,82 @@ OPTIONS
           --profile           Enable compiler and runtime profiling.
           --profile-output <path> [default: jank.profile]
                               The file to write profile entries (will be overwritten).
+          --profile-format <text, chrome-trace> [default: chrome-trace]
+                              The format of the profile. Chrome traces can be opened in
+                              ui.perfetto.dev or chrome://tracing.
+          --compile-report <path>
+                              Time each compiler phase for every top-level form and
+                              namespace. Writes JSON to the path, or prints a table for -.
+          --compile-report-slowest <n> [default: 10]
+                              The number of slowest forms to list in the compile report.
+          --sample-profile <path>
+                              Sample every thread's stack while running and write them to
+                              the path at exit, as folded stacks for flame graphs.
+          --sample-rate <hz> [default: 99]
+                              How often the sampling profiler samples, per CPU second.
+          --alloc-profile <path>
+                              Sample the boxes allocated while running and write the
+                              busiest allocation sites to the path at exit, or print them
+                              for -.
+          --alloc-sample-interval <n> [default: 1024]
+                              On average, how many boxes are allocated per sample.
           --perf              Enable Linux perf event sampling.
           --gc-incremental    Enable incremental GC collection.
+          --gc-markers <n> [default: 0]
+                              The number of threads which mark in parallel during a
+                              collection. Zero uses one per hardware thread.
+          --gc-initial-heap <size>
+                              The initial GC heap size, in bytes. Supports k, m, and g
+                              suffixes, such as 512m.
+          --gc-max-heap <size>
+                              The max GC heap size, in bytes. Supports k, m, and g suffixes.
+          --gc-free-space-divisor <n> [default: 3]
+                              The GC grows the heap rather than collecting once less than
+                              1/n of it is free. Higher values use less memory but collect
+                              more often.
+          --gc-no-interior-pointers
+                              Only pointers to the start of an allocation keep it alive.
+                              This speeds up marking, but it's only safe if no native code
+                              holds only interior pointers into GC allocations.
           --debug             Enable debug symbol generation for generated code.
           --direct-call       Elides the dereferencing of vars for improved performance.
+                              Calls to non-dynamic vars holding jank fns are linked
+                              directly, so they won't see redefinitions unless the var
+                              is marked ^:redef.
   -O,     --optimization <0 - 3>
                               The optimization level to use for AOT compilation.
           --eagerness <lazy, eager> [default: lazy]
                               How eagerly to JIT compile functions.
+          --hoist-var-derefs <none, checked, unchecked> [default: checked]
+                              How to hoist loop-invariant var derefs out of loops. Checked
+                              hoisting still picks up var redefinitions between iterations.
+          --inline-threshold <n> [default: 0]
+                              Inline calls to small fns with up to this many expressions
+                              in their body. Zero disables automatic inlining. Fns marked
+                              ^:no-inline are never inlined.
+  -j,     --jobs <n> [default: 0]
+                              The number of threads used to emit compiled modules in
+                              parallel. Zero uses one thread per hardware thread.
+          --lto <none, thin, full> [default: none]
+                              Write compiled modules as bitcode and link with LTO. For
+                              clojure.core to take part, jank needs to be built with
+                              -Djank_lto=on.
+          --profile-generate  Instrument AOT compiled code, so running it writes a raw
+                              profile for llvm-profdata. Compiled modules are written to
+                              <output-dir>-profile-generate, so the JIT never loads them.
+          --profile-use <path>
+                              Optimize JIT and AOT compiled code using an indexed profile.
   -o,     --output <path>
                               The name of the output file.
           --output-dir <path> [default: target]
                               The prefix to use for object files.
           --output-target <cpp, llvm-ir, object> [default: object]
                               The target of each compiled module artifact.
+          --tree-shake        Only link the namespaces which the entrypoint module requires,
+                              directly or transitively, and internalize each compiled module
+                              so unused code is dropped. Namespaces which are only resolved
+                              dynamically must be marked ^:keep, on the ns or on one of
+                              its vars.
   -I,     --include-dir <path>
                               Absolute or relative path to the directory for includes
                               resolution. Can be specified multiple times.
@@ -150,6 +217,81 @@ OPTIONS
     std::exit(1);
   }
 
+  static bool parse_u32(std::string_view const value, u32 &out)
+  {
+    auto const parsed{ std::from_chars(value.data(), value.data() + value.size(), out) };
+    return parsed.ec == std::errc{} && parsed.ptr == value.data() + value.size();
+  }
+
+  /* Sizes are in bytes, with an optional k, m, or g suffix for the binary multiple. */
+  static bool parse_size(std::string_view const value, usize &out)
+  {
+    auto const parsed{ std::from_chars(value.data(), value.data() + value.size(), out) };
+    if(parsed.ec != std::errc{})
+    {
+      return false;
+    }
+
+    auto const suffix{ value.substr(parsed.ptr - value.data()) };
+    if(suffix.empty())
+    {
+      return true;
+    }
+    else if(suffix.size() != 1)
+    {
+      return false;
+    }
+
+    usize shift{};
+    switch(suffix[0])
+    {
+      case 'k':
+      case 'K':
+        shift = 10;
+        break;
+      case 'm':
+      case 'M':
+        shift = 20;
+        break;
+      case 'g':
+      case 'G':
+        shift = 30;
+        break;
+      default:
+        return false;
+    }
+    if(out > (std::numeric_limits<usize>::max() >> shift))
+    {
+      return false;
+    }
+    out <<= shift;
+    return true;
+  }
+
+  void parse_gc_init_opts(int const argc, char const **argv)
+  {
+    for(int i{ 1 }; i < argc; ++i)
+    {
+      std::string_view const flag{ argv[i] };
+      if(flag == "--")
+      {
+        break;
+      }
+      else if(flag == "--gc-no-interior-pointers")
+      {
+        opts.gc_all_interior_pointers = false;
+      }
+      else if(flag == "--gc-markers" && i + 1 < argc)
+      {
+        u32 markers{};
+        if(parse_u32(argv[++i], markers))
+        {
+          opts.gc_markers = markers;
+        }
+      }
+    }
+  }
+
   jtl::result<void, int> parse_opts(int const argc, char const **argv)
   {
     auto const flags{ parse_into_vector(argc, argv) };
@@ -207,10 +349,96 @@ OPTIONS
         {
           opts.profiler_file = value;
         }
+        else if(check_flag(it, end, value, "--profile-format", true))
+        {
+          if(value == "text")
+          {
+            opts.profiler_format = profiler_format::text;
+          }
+          else if(value == "chrome-trace")
+          {
+            opts.profiler_format = profiler_format::chrome_trace;
+          }
+          else
+          {
+            throw util::format("Invalid profile format '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--compile-report", true))
+        {
+          opts.compile_report_file = value;
+        }
+        else if(check_flag(it, end, value, "--compile-report-slowest", true))
+        {
+          if(!parse_u32({ value.data(), value.size() }, opts.compile_report_slowest))
+          {
+            throw util::format("Invalid compile report form count '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--sample-profile", true))
+        {
+          opts.sample_profile_file = value;
+        }
+        else if(check_flag(it, end, value, "--sample-rate", true))
+        {
+          if(!parse_u32({ value.data(), value.size() }, opts.sample_rate) || opts.sample_rate == 0)
+          {
+            throw util::format("Invalid sample rate '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--alloc-profile", true))
+        {
+          opts.alloc_profile_file = value;
+        }
+        else if(check_flag(it, end, value, "--alloc-sample-interval", true))
+        {
+          if(!parse_u32({ value.data(), value.size() }, opts.alloc_sample_interval)
+             || opts.alloc_sample_interval == 0)
+          {
+            throw util::format("Invalid allocation sample interval '{}'.", value);
+          }
+        }
         else if(check_flag(it, end, value, "--perf", false))
         {
           opts.perf_profiling_enabled = true;
         }
+        else if(check_flag(it, end, value, "--gc-incremental", false))
+        {
+          opts.gc_incremental = true;
+        }
+        else if(check_flag(it, end, value, "--gc-markers", true))
+        {
+          if(!parse_u32({ value.data(), value.size() }, opts.gc_markers))
+          {
+            throw util::format("Invalid GC marker count '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--gc-initial-heap", true))
+        {
+          if(!parse_size({ value.data(), value.size() }, opts.gc_initial_heap_size))
+          {
+            throw util::format("Invalid GC heap size '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--gc-max-heap", true))
+        {
+          if(!parse_size({ value.data(), value.size() }, opts.gc_max_heap_size))
+          {
+            throw util::format("Invalid GC heap size '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--gc-free-space-divisor", true))
+        {
+          if(!parse_u32({ value.data(), value.size() }, opts.gc_free_space_divisor)
+             || opts.gc_free_space_divisor == 0)
+          {
+            throw util::format("Invalid GC free space divisor '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--gc-no-interior-pointers", false))
+        {
+          opts.gc_all_interior_pointers = false;
+        }
         else if(check_flag(it, end, value, "--debug", false))
         {
           opts.debug = true;
@@ -257,6 +485,74 @@ OPTIONS
             throw util::format("Invalid eagerness type '{}'.", value);
           }
         }
+        else if(check_flag(it, end, value, "--hoist-var-derefs", true))
+        {
+          if(value == "none")
+          {
+            opts.hoist_var_derefs = var_hoisting::none;
+          }
+          else if(value == "checked")
+          {
+            opts.hoist_var_derefs = var_hoisting::checked;
+          }
+          else if(value == "unchecked")
+          {
+            opts.hoist_var_derefs = var_hoisting::unchecked;
+          }
+          else
+          {
+            throw util::format("Invalid var hoisting type '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--inline-threshold", true))
+        {
+          auto const parsed{ std::from_chars(value.data(), value.data() + value.size(),
+                                             opts.inline_threshold) };
+          if(parsed.ec != std::errc{} || parsed.ptr != value.data() + value.size())
+          {
+            throw util::format("Invalid inline threshold '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "-j", "--jobs", true))
+        {
+          auto const parsed{ std::from_chars(value.data(), value.data() + value.size(),
+                                             opts.jobs) };
+          if(parsed.ec != std::errc{} || parsed.ptr != value.data() + value.size())
+          {
+            throw util::format("Invalid job count '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--lto", true))
+        {
+          if(value == "none")
+          {
+            opts.lto = lto_mode::none;
+          }
+          else if(value == "thin")
+          {
+            opts.lto = lto_mode::thin;
+          }
+          else if(value == "full")
+          {
+            opts.lto = lto_mode::full;
+          }
+          else
+          {
+            throw util::format("Invalid LTO mode '{}'.", value);
+          }
+        }
+        else if(check_flag(it, end, value, "--profile-generate", false))
+        {
+          opts.profile_generate = true;
+        }
+        else if(check_flag(it, end, value, "--profile-use", true))
+        {
+          opts.profile_use = value;
+        }
+        else if(check_flag(it, end, value, "--tree-shake", false))
+        {
+          opts.tree_shake = true;
+        }
         else if(check_flag(it, end, value, "-I", "--include-dir", true))
         {
           opts.include_dirs.emplace_back(value);
@@ -416,6 +712,21 @@ OPTIONS
     return ok();
   }
 
+  jtl::immutable_string module_output_dir()
+  {
+    if(!opts.profile_generate)
+    {
+      return opts.output_dir;
+    }
+
+    auto dir{ std::filesystem::path{ opts.output_dir.c_str() }.lexically_normal() };
+    if(!dir.has_filename())
+    {
+      dir = dir.parent_path();
+    }
+    return util::format("{}-profile-generate", dir.string());
+  }
+
   native_vector<jtl::immutable_string> parse_into_vector(int const argc, char const **argv)
   {
     native_vector<jtl::immutable_string> ret;
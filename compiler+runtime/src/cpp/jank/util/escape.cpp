@@ -1,3 +1,5 @@
+#include <ostream>
+
 #include <jtl/string_builder.hpp>
 
 #include <jank/util/escape.hpp>
@@ -124,4 +126,32 @@ namespace jank::util
 
     return sb.release();
   }
+
+  void write_json_string(std::ostream &out, std::string_view const s)
+  {
+    out << '"';
+    for(auto const c : s)
+    {
+      switch(c)
+      {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        default:
+          if(static_cast<unsigned char>(c) < 0x20)
+          {
+            static constexpr char const *hex{ "0123456789abcdef" };
+            out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+          }
+          else
+          {
+            out << c;
+          }
+      }
+    }
+    out << '"';
+  }
 }
@@ -0,0 +1,82 @@
+#include <jank/gc.hpp>
+
+#include <jank/util/thread_pool.hpp>
+#include <jank/util/scope_exit.hpp>
+
+namespace jank::util
+{
+  thread_pool::thread_pool(usize thread_count)
+  {
+    if(thread_count == 0)
+    {
+      thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    threads.reserve(thread_count);
+    for(usize i{}; i < thread_count; ++i)
+    {
+      threads.emplace_back([this]() { work(); });
+    }
+  }
+
+  thread_pool::~thread_pool()
+  {
+    {
+      std::lock_guard const lock{ mutex };
+      stopping = true;
+    }
+    task_ready.notify_all();
+
+    for(auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  void thread_pool::submit(task_type &&task)
+  {
+    {
+      std::lock_guard const lock{ mutex };
+      tasks.emplace_back(std::move(task));
+    }
+    task_ready.notify_one();
+  }
+
+  void thread_pool::wait()
+  {
+    std::unique_lock lock{ mutex };
+    tasks_done.wait(lock, [this]() { return tasks.empty() && running == 0; });
+  }
+
+  void thread_pool::work()
+  {
+    GC_stack_base sb{};
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+    util::scope_exit const unregister{ []() { GC_unregister_my_thread(); } };
+
+    while(true)
+    {
+      task_type task;
+      {
+        std::unique_lock lock{ mutex };
+        task_ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        if(tasks.empty())
+        {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        ++running;
+      }
+
+      task();
+
+      {
+        std::lock_guard const lock{ mutex };
+        --running;
+      }
+      tasks_done.notify_all();
+    }
+  }
+}
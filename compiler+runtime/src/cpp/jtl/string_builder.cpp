@@ -15,8 +15,11 @@ namespace jtl
   static void realloc(string_builder &sb, usize const required)
   {
     auto const new_capacity{ std::bit_ceil(required) };
-    /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-    auto const new_data{ reinterpret_cast<char *>(GC_realloc(sb.buffer, new_capacity)) };
+    /* The buffer is often released into a string which shares it, so it's allocated as
+     * pointer free, same as strings. Reallocating keeps the kind of the original. */
+    auto const new_data{ reinterpret_cast<char *>(
+      /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
+      sb.buffer ? GC_realloc(sb.buffer, new_capacity) : GC_malloc_atomic(new_capacity)) };
     sb.buffer = new_data;
     sb.capacity = new_capacity;
   }
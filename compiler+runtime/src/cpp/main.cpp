@@ -21,6 +21,9 @@
 #include <jank/jit/processor.hpp>
 #include <jank/aot/processor.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/compile_report.hpp>
+#include <jank/profile/allocations.hpp>
+#include <jank/profile/sampler.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/string.hpp>
 #include <jank/util/fmt/print.hpp>
@@ -31,6 +34,7 @@
 
 #include <jank/compiler_native.hpp>
 #include <jank/perf_native.hpp>
+#include <jank/gc_native.hpp>
 #include <clojure/core_native.hpp>
 #include <clojure/string_native.hpp>
 
@@ -45,7 +49,6 @@ extern "C" void jank_load_jank_nrepl_server_bencode();
 extern "C" void jank_load_jank_nrepl_server_capture();
 extern "C" void jank_load_jank_nrepl_server_util();
 extern "C" void jank_load_jank_nrepl_server_eval();
-extern "C" void jank_load_jank_nrepl_server_parsec();
 extern "C" void jank_load_jank_nrepl_server_handler_close();
 extern "C" void jank_load_jank_nrepl_server_handler_clone();
 extern "C" void jank_load_jank_nrepl_server_handler_describe();
@@ -74,22 +77,6 @@ namespace jank
       profile::timer const timer{ "eval user code" };
       __rt_ctx->eval_file(util::cli::opts.target_file);
     }
-
-    //ankerl::nanobench::Config config;
-    //config.mMinEpochIterations = 1000000;
-    //config.mOut = &std::cout;
-    //config.mWarmup = 10000;
-
-
-    //ankerl::nanobench::Bench().config(config).run
-    //(
-    //  "thing",
-    //  [&]
-    //  {
-    //    auto const ret();
-    //    ankerl::nanobench::doNotOptimizeAway(ret);
-    //  }
-    //);
   }
 
   static void run_main()
@@ -386,6 +373,8 @@ int main(int const argc, char const **argv)
   using namespace jank;
   using namespace jank::runtime;
 
+  util::cli::parse_gc_init_opts(argc, argv);
+
   return jank_init(argc, argv, /*init_default_ctx=*/false, [](int const argc, char const **argv) {
     auto const parse_result(util::cli::parse_opts(argc, argv));
     if(parse_result.is_err())
@@ -397,8 +386,23 @@ int main(int const argc, char const **argv)
     {
       GC_enable_incremental();
     }
+    if(jank::util::cli::opts.gc_free_space_divisor != 0)
+    {
+      GC_set_free_space_divisor(jank::util::cli::opts.gc_free_space_divisor);
+    }
+    if(jank::util::cli::opts.gc_max_heap_size != 0)
+    {
+      GC_set_max_heap_size(jank::util::cli::opts.gc_max_heap_size);
+    }
+    if(jank::util::cli::opts.gc_initial_heap_size > GC_get_heap_size())
+    {
+      GC_expand_hp(jank::util::cli::opts.gc_initial_heap_size - GC_get_heap_size());
+    }
 
     profile::configure();
+    profile::compile_report::configure();
+    profile::sampler::configure();
+    profile::allocations::configure();
     profile::timer const timer{ "main" };
 
     if(util::cli::opts.command == util::cli::command::check_health)
@@ -412,6 +416,7 @@ int main(int const argc, char const **argv)
 
     __rt_ctx->module_loader.add_load_fn("jank.compiler-native", &jank_load_jank_compiler_native);
     __rt_ctx->module_loader.add_load_fn("jank.perf-native", &jank_load_jank_perf_native);
+    __rt_ctx->module_loader.add_load_fn("jank.gc-native", &jank_load_jank_gc_native);
 
 #ifdef JANK_PHASE_2
     __rt_ctx->module_loader.add_load_fn("clojure.core", &jank_load_clojure_core);
@@ -431,8 +436,6 @@ int main(int const argc, char const **argv)
                                         &jank_load_jank_nrepl_server_util);
     __rt_ctx->module_loader.add_load_fn("jank.nrepl.server.eval",
                                         &jank_load_jank_nrepl_server_eval);
-    __rt_ctx->module_loader.add_load_fn("jank.nrepl.server.parsec",
-                                        &jank_load_jank_nrepl_server_parsec);
     __rt_ctx->module_loader.add_load_fn("jank.nrepl.server.handler.close",
                                         &jank_load_jank_nrepl_server_handler_close);
     __rt_ctx->module_loader.add_load_fn("jank.nrepl.server.handler.clone",
@@ -0,0 +1,84 @@
+#include <jank/aot/image.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/util/environment.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::aot
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("aot image")
+  {
+    TEST_CASE("restores only the program's modules")
+    {
+      native_vector<image_var> const vars{
+        { "jank.test.image-a", "foo", false },
+        { "jank.test.image-a", "bar", true },
+        { "clojure.core", "map", false }
+      };
+      native_vector<jtl::immutable_string> const keywords{ "jank.test.image-a/kw", "plain" };
+      auto const fingerprint{ record_module("jank.test.image-a", vars, keywords) };
+      auto const other_fingerprint{ record_module("jank.test.image-b", vars, keywords) };
+
+      auto const image{ build_startup_image({ "jank.test.image-a" }) };
+      CHECK(image.contains("module jank.test.image-a "));
+      CHECK(!image.contains("jank.test.image-b"));
+      REQUIRE(load_startup_image(image).is_ok());
+
+      var_ref foo, bar, map;
+      var_ref * const var_slots[]{ &foo, &bar, &map };
+      obj::keyword_ref kw, plain;
+      obj::keyword_ref * const keyword_slots[]{ &kw, &plain };
+
+      CHECK(
+        !restore_module("jank.test.image-b", other_fingerprint, var_slots, 3, keyword_slots, 2));
+      CHECK(!restore_module("jank.test.image-a", fingerprint + 1, var_slots, 3, keyword_slots, 2));
+      CHECK(!restore_module("jank.test.image-a", fingerprint, var_slots, 2, keyword_slots, 2));
+
+      /* Nothing is interned until the module's load function asks for it. */
+      auto const ns_sym{ make_box<obj::symbol>("jank.test.image-a") };
+      CHECK(__rt_ctx->find_ns(ns_sym).is_nil());
+
+      REQUIRE(restore_module("jank.test.image-a", fingerprint, var_slots, 3, keyword_slots, 2));
+      auto const n{ __rt_ctx->find_ns(ns_sym) };
+      REQUIRE(n.is_some());
+      CHECK_EQ(foo, __rt_ctx->find_var("jank.test.image-a", "foo"));
+      CHECK_EQ(foo->n, n);
+      CHECK_EQ(bar, __rt_ctx->find_var("jank.test.image-a", "bar"));
+      CHECK_EQ(map, __rt_ctx->find_var("clojure.core", "map"));
+      CHECK_EQ(kw, __rt_ctx->intern_keyword("jank.test.image-a", "kw", true).expect_ok());
+      CHECK_EQ(plain, __rt_ctx->intern_keyword("plain").expect_ok());
+
+      /* Restoring again, as a reloaded module would, finds the same vars. */
+      var_ref foo_again, bar_again, map_again;
+      var_ref * const again_slots[]{ &foo_again, &bar_again, &map_again };
+      REQUIRE(
+        restore_module("jank.test.image-a", fingerprint, again_slots, 3, keyword_slots, 2));
+      CHECK_EQ(foo_again, foo);
+      CHECK_EQ(bar_again, bar);
+    }
+
+    TEST_CASE("names with newlines aren't recorded")
+    {
+      native_vector<image_var> const vars{
+        { "jank.test.image-c", "foo\nbar", false }
+      };
+      CHECK_EQ(record_module("jank.test.image-c", vars, {}), 0);
+      CHECK(!build_startup_image({ "jank.test.image-c" }).contains("jank.test.image-c"));
+    }
+
+    TEST_CASE("rejects images from other versions")
+    {
+      CHECK(load_startup_image("jank-image 2 not-this-version\n").is_err());
+      CHECK(load_startup_image("").is_err());
+      CHECK(load_startup_image(util::format("jank-image 2 {}\nmodule a b\n",
+                                            util::binary_version()))
+              .is_err());
+    }
+  }
+}
@@ -0,0 +1,84 @@
+#include <gc/gc.h>
+
+#include <jank/analyze/processor.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/codegen/cpp_processor.hpp>
+#include <jank/ir/processor.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::codegen
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("codegen")
+  {
+    TEST_CASE("module constants")
+    {
+      jtl::immutable_string const module_name{ "jank.test.codegen-module-constants" };
+      auto const load_function{ module::module_to_load_function(module_name) };
+      auto const native_ns{ module::module_to_native_ns(module_name) };
+      context::binding_scope const _{ obj::persistent_hash_map::create_unique(
+        std::make_pair(__rt_ctx->current_ns_var, __rt_ctx->intern_ns(module_name))) };
+
+      /* This is the same shape of load function which compiling a module generates. */
+      auto const form{ __rt_ctx->forcefully_read_string(
+        util::format("(fn* {} [] (def i 42) (def r 1.5) (def k :kw) (def v [1 2]))",
+                     load_function)) };
+      analyze::processor an_prc;
+      auto const fn{ static_box_cast<analyze::expr::function>(
+        an_prc.analyze(form, analyze::expression_position::statement).expect_ok()) };
+      fn->unique_name = load_function;
+      auto const mod{ ir::create(fn, module_name, compilation_target::module) };
+      auto const code{ gen_cpp(mod).declaration };
+
+      /* Only the vector needs to be a GC root. The rooted constants are declared last, so
+       * none of the others can be within the range which is registered. */
+      jtl::immutable_string first_rooted;
+      for(auto const &c : mod.lifted_constants)
+      {
+        if(c.second->type == object_type::persistent_vector)
+        {
+          first_rooted = c.first;
+        }
+      }
+      REQUIRE(!first_rooted.empty());
+      CHECK(code.contains(util::format("GC_add_roots(&{}::{}, (&{}::{} + 1));",
+                                       native_ns,
+                                       first_rooted,
+                                       native_ns,
+                                       first_rooted)
+                            .c_str()));
+      auto const rooted_declaration{ code.find(util::format("{}{ _jank_null", first_rooted)) };
+      for(auto const &c : mod.lifted_constants)
+      {
+        if(c.first == first_rooted)
+        {
+          continue;
+        }
+        CHECK(!code.contains(util::format("GC_add_roots(&{}::{},", native_ns, c.first).c_str()));
+        CHECK(!code.contains(util::format("(&{}::{} + 1));", native_ns, c.first).c_str()));
+        CHECK_LT(code.find(util::format("{}{ _jank_null", c.first)), rooted_declaration);
+      }
+
+      __rt_ctx->jit_prc.eval_string(code);
+      reinterpret_cast<void (*)()>(__rt_ctx->jit_prc.find_symbol(load_function).expect_ok())();
+
+      /* The numbers live in the module itself, not on the GC heap. */
+      auto const root_of{ [&](char const * const name) {
+        return __rt_ctx->find_var(module_name, name)->deref();
+      } };
+      CHECK_EQ(GC_base(root_of("i").data), nullptr);
+      CHECK_EQ(GC_base(root_of("r").data), nullptr);
+      CHECK_NE(GC_base(root_of("v").data), nullptr);
+      CHECK_EQ(root_of("k"), __rt_ctx->intern_keyword("kw").expect_ok());
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#include <jank/gc.hpp>
+#include <gc/gc_mark.h>
+
+#include <jtl/string_builder.hpp>
+#include <jank/gc_native.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/call.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/uuid.hpp>
+#include <jank/runtime/var.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank
+{
+  using namespace jank::runtime;
+
+  /* Anything which can't hold GC pointers should be allocated as pointer free, so the GC
+   * doesn't need to scan it and nothing in it can keep other allocations alive. */
+  static int kind_of(void const * const p)
+  {
+    return GC_get_kind_and_size(GC_base(const_cast<void *>(p)), nullptr);
+  }
+
+  static object_ref call_gc_native(jtl::immutable_string const &name)
+  {
+    return dynamic_call(__rt_ctx->intern_var("jank.gc-native", name).expect_ok()->deref());
+  }
+
+  static i64 get_int(object_ref const m, char const * const key)
+  {
+    return to_int(get(m, __rt_ctx->intern_keyword(key).expect_ok()));
+  }
+
+  TEST_SUITE("gc")
+  {
+    TEST_CASE("strings")
+    {
+      jtl::immutable_string const large(128, 'a');
+      CHECK_EQ(GC_I_PTRFREE, kind_of(large.data()));
+
+      jtl::string_builder sb;
+      CHECK_EQ(GC_I_PTRFREE, kind_of(sb.data()));
+      sb(large)(large);
+      CHECK_EQ(GC_I_PTRFREE, kind_of(sb.data()));
+      auto const released{ sb.release() };
+      CHECK_EQ(GC_I_PTRFREE, kind_of(released.data()));
+    }
+
+    TEST_CASE("containers")
+    {
+      native_vector<i64> ints{ 1, 2, 3 };
+      CHECK_EQ(GC_I_PTRFREE, kind_of(ints.data()));
+
+      native_vector<object_ref> objects{ make_box(1) };
+      CHECK_EQ(GC_I_NORMAL, kind_of(objects.data()));
+    }
+
+    TEST_CASE("objects")
+    {
+      CHECK_EQ(GC_I_PTRFREE, kind_of(make_box(1).data));
+      CHECK_EQ(GC_I_PTRFREE, kind_of(make_box(1.5).data));
+      CHECK_EQ(GC_I_PTRFREE, kind_of(make_box<obj::uuid>()->value.data));
+      CHECK_EQ(GC_I_NORMAL, kind_of(make_box<obj::uuid>().data));
+      CHECK_EQ(GC_I_NORMAL, kind_of(make_box<obj::persistent_vector>().data));
+
+      auto const var{ __rt_ctx->intern_var("clojure.core", "*ns*").expect_ok() };
+      CHECK_EQ(GC_I_NORMAL, kind_of(make_box<var_unbound_root>(var).data));
+    }
+
+    TEST_CASE("jank.gc")
+    {
+      jank_load_jank_gc_native();
+
+      auto const before{ call_gc_native("stats") };
+      CHECK(get_int(before, "heap-size") > 0);
+      CHECK(get_int(before, "total-bytes") > 0);
+      call_gc_native("collect");
+      auto const after{ call_gc_native("stats") };
+      CHECK(get_int(before, "collections") < get_int(after, "collections"));
+
+      /* These are held on the stack, so they're live for the histogram. */
+      native_vector<object_ref> uuids;
+      for(usize i{}; i < 16; ++i)
+      {
+        uuids.emplace_back(make_box<obj::uuid>());
+      }
+      auto const histogram{ call_gc_native("histogram") };
+      auto const uuid_counts{ get(histogram, __rt_ctx->intern_keyword("uuid").expect_ok()) };
+      REQUIRE(uuid_counts.is_some());
+      CHECK(get_int(uuid_counts, "count") >= 16);
+      CHECK(get_int(uuid_counts, "bytes") >= static_cast<i64>(16 * sizeof(obj::uuid)));
+    }
+  }
+}
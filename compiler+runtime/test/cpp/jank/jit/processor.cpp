@@ -1,9 +1,15 @@
 #include <filesystem>
+#include <fstream>
 #ifdef _WIN32
-  #include <fstream>
   #include <unordered_set>
 #endif
 
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/TextDiagnosticPrinter.h>
 
@@ -33,6 +39,26 @@ namespace jank::jit
 {
   using runtime::__rt_ctx;
 
+  /* A module with one C fn, which returns the answer, as bitcode, like an LTO module. */
+  static std::string answer_bitcode(char const * const fn_name, i64 const answer)
+  {
+    llvm::LLVMContext ctx;
+    llvm::Module module{ "answer", ctx };
+    llvm::IRBuilder<> builder{ ctx };
+    auto const fn{ llvm::Function::Create(llvm::FunctionType::get(builder.getInt64Ty(), false),
+                                          llvm::Function::ExternalLinkage,
+                                          fn_name,
+                                          module) };
+    builder.SetInsertPoint(llvm::BasicBlock::Create(ctx, "entry", fn));
+    builder.CreateRet(builder.getInt64(answer));
+
+    std::string bitcode;
+    llvm::raw_string_ostream os{ bitcode };
+    llvm::WriteBitcodeToFile(module, os);
+    os.flush();
+    return bitcode;
+  }
+
   struct failure
   {
     std::filesystem::path path;
@@ -41,6 +67,32 @@ namespace jank::jit
 
   TEST_SUITE("jit")
   {
+    TEST_CASE("bitcode modules")
+    {
+      auto const &jit_prc{ __rt_ctx->jit_prc };
+
+      auto const bitcode{ answer_bitcode("jank_test_bitcode_answer", 42) };
+      jit_prc.load_bitcode("answer", { bitcode.data(), bitcode.size() });
+      auto const answer{ jit_prc.find_symbol("jank_test_bitcode_answer") };
+      REQUIRE(answer.is_ok());
+      CHECK(reinterpret_cast<i64 (*)()>(answer.expect_ok())() == 42);
+
+      /* LTO modules are bitcode with an object extension, so load_object takes them too. */
+      auto const path{ std::filesystem::temp_directory_path() / "jank-test-bitcode.o" };
+      {
+        auto const object_bitcode{ answer_bitcode("jank_test_bitcode_object_answer", 7) };
+        std::ofstream out{ path, std::ios::binary };
+        out.write(object_bitcode.data(), static_cast<std::streamsize>(object_bitcode.size()));
+      }
+      jit_prc.load_object(path.string());
+      std::filesystem::remove(path);
+      auto const object_answer{ jit_prc.find_symbol("jank_test_bitcode_object_answer") };
+      REQUIRE(object_answer.is_ok());
+      CHECK(reinterpret_cast<i64 (*)()>(object_answer.expect_ok())() == 7);
+
+      CHECK_THROWS_AS(jit_prc.load_bitcode("garbage", "not bitcode"), std::runtime_error);
+    }
+
     TEST_CASE("files")
     {
       auto const cardinal_result(__rt_ctx->intern_keyword("success").expect_ok());
@@ -0,0 +1,143 @@
+#include <jank/nrepl/bencode.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::nrepl::bencode
+{
+  using namespace jank::runtime;
+
+  static object_ref decode_one(std::string_view const input)
+  {
+    decoder d;
+    d.feed(input);
+    return d.next().expect_ok().unwrap();
+  }
+
+  TEST_SUITE("nrepl::bencode")
+  {
+    TEST_CASE("decode")
+    {
+      SUBCASE("integer")
+      {
+        CHECK(equal(decode_one("i42e"), make_box(42)));
+        CHECK(equal(decode_one("i-7e"), make_box(-7)));
+      }
+
+      SUBCASE("string")
+      {
+        CHECK(equal(decode_one("4:spam"), make_box("spam")));
+        CHECK(equal(decode_one("0:"), make_box("")));
+      }
+
+      SUBCASE("list")
+      {
+        CHECK(equal(decode_one("li1e3:fooe"),
+                    make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box("foo"))));
+      }
+
+      SUBCASE("dict")
+      {
+        CHECK(equal(decode_one("d2:op4:eval4:code5:(+ 1)e"),
+                    obj::persistent_array_map::create_unique(make_box("op"),
+                                                             make_box("eval"),
+                                                             make_box("code"),
+                                                             make_box("(+ 1)"))));
+      }
+
+      SUBCASE("many values")
+      {
+        decoder d;
+        d.feed("i1ei2e");
+        CHECK(equal(d.next().expect_ok().unwrap(), make_box(1)));
+        CHECK(equal(d.next().expect_ok().unwrap(), make_box(2)));
+        CHECK(d.next().expect_ok().is_none());
+        CHECK_EQ(d.pending(), 0);
+      }
+    }
+
+    TEST_CASE("decode incomplete")
+    {
+      decoder d;
+      d.feed("d2:op");
+      CHECK(d.next().expect_ok().is_none());
+      d.feed("4:ev");
+      CHECK(d.next().expect_ok().is_none());
+      d.feed("ale");
+      CHECK(equal(d.next().expect_ok().unwrap(),
+                  obj::persistent_array_map::create_unique(make_box("op"), make_box("eval"))));
+      CHECK_EQ(d.pending(), 0);
+    }
+
+    TEST_CASE("decode invalid")
+    {
+      SUBCASE("integer")
+      {
+        decoder d;
+        d.feed("i4x2e");
+        CHECK(d.next().is_err());
+      }
+
+      SUBCASE("string length")
+      {
+        decoder d;
+        d.feed("x:foo");
+        CHECK(d.next().is_err());
+      }
+    }
+
+    TEST_CASE("encode")
+    {
+      SUBCASE("scalars")
+      {
+        CHECK_EQ(encode(make_box(42)).expect_ok(), "i42e");
+        CHECK_EQ(encode(make_box("spam")).expect_ok(), "4:spam");
+      }
+
+      SUBCASE("sorted keys")
+      {
+        auto const m{ obj::persistent_array_map::create_unique(make_box("session"),
+                                                               make_box("a"),
+                                                               make_box("id"),
+                                                               make_box("b")) };
+        CHECK_EQ(encode(m).expect_ok(), "d2:id1:b7:session1:ae");
+      }
+
+      SUBCASE("nil")
+      {
+        CHECK(encode(jank_nil).is_err());
+      }
+
+      SUBCASE("chunks")
+      {
+        native_vector<std::string> chunks;
+        encoder enc{ 4, [&](std::string &&chunk) { chunks.emplace_back(std::move(chunk)); } };
+        CHECK(enc.encode(make_box("abcdefgh")).is_ok());
+        enc.finish();
+        CHECK_GT(chunks.size(), 1);
+        std::string joined;
+        for(auto const &chunk : chunks)
+        {
+          joined += chunk;
+        }
+        CHECK_EQ(joined, "8:abcdefgh");
+      }
+    }
+
+    TEST_CASE("roundtrip")
+    {
+      auto const m{ obj::persistent_array_map::create_unique(
+        make_box("status"),
+        make_box<obj::persistent_vector>(std::in_place, make_box("done")),
+        make_box("value"),
+        make_box("3")) };
+      auto const encoded{ encode(m).expect_ok() };
+      CHECK(equal(decode_one({ encoded.data(), encoded.size() }), m));
+    }
+  }
+}
@@ -0,0 +1,115 @@
+#include <jank/profile/allocations.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile::allocations
+{
+  TEST_SUITE("profile::allocations")
+  {
+    TEST_CASE("invalid intervals")
+    {
+      CHECK(start(0).is_err());
+      CHECK(start(1 << 30).is_err());
+      CHECK_FALSE(is_enabled());
+    }
+
+    TEST_CASE("every box is sampled with an interval of one")
+    {
+      clear();
+      REQUIRE(start(1).is_ok());
+      CHECK(is_enabled());
+      CHECK(start(1).is_err());
+      for(i64 i{}; i < 100; ++i)
+      {
+        runtime::make_box<runtime::obj::integer>(i);
+      }
+      stop();
+      CHECK_FALSE(is_enabled());
+      /* Not sampled, since we've stopped. */
+      runtime::make_box<runtime::obj::integer>(0);
+
+      u64 count{};
+      u64 bytes{};
+      for(auto const &s : sites())
+      {
+        if(s.type == runtime::object_type::integer)
+        {
+          count += s.count;
+          bytes += s.bytes;
+          CHECK_FALSE(s.caller.contains("jank::runtime::make_box"));
+        }
+      }
+      CHECK(count == 100);
+      CHECK(bytes == 100 * sizeof(runtime::obj::integer));
+      CHECK(elapsed_seconds() > 0);
+
+      clear();
+      CHECK(sites().empty());
+    }
+
+    TEST_CASE("restarting with a smaller interval resets the countdown")
+    {
+      static constexpr u32 large_interval{ 1 << 24 };
+
+      clear();
+      /* This draws a countdown in the millions, which we won't get through. */
+      REQUIRE(start(large_interval).is_ok());
+      runtime::make_box<runtime::obj::integer>(0);
+      stop();
+      clear();
+
+      REQUIRE(start(1).is_ok());
+      for(i64 i{}; i < 100; ++i)
+      {
+        runtime::make_box<runtime::obj::integer>(i);
+      }
+      stop();
+
+      u64 count{};
+      for(auto const &s : sites())
+      {
+        if(s.type == runtime::object_type::integer)
+        {
+          count += s.count;
+        }
+      }
+      CHECK(count == 100);
+
+      clear();
+    }
+
+    TEST_CASE("boxes are charged to the jank fn which allocated them")
+    {
+      /* The fn is compiled before the profiler starts, which is fine, since every fn is
+       * registered as it's compiled. */
+      runtime::__rt_ctx->eval_string(R"((defn jank-test-allocating [n]
+                                           (loop [i 0
+                                                  acc []]
+                                             (if (< i n)
+                                               (recur (inc i) (conj acc (* 1.5 i)))
+                                               acc))))");
+
+      clear();
+      REQUIRE(start(1).is_ok());
+      runtime::__rt_ctx->eval_string("(jank-test-allocating 100)");
+      stop();
+
+      u64 count{};
+      for(auto const &s : sites())
+      {
+        if(s.type == runtime::object_type::real && s.jank_fn.is_some()
+           && s.jank_fn.unwrap().contains("jank-test-allocating"))
+        {
+          count += s.count;
+        }
+      }
+      CHECK(count >= 100);
+
+      clear();
+    }
+  }
+}
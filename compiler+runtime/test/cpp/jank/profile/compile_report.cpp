@@ -0,0 +1,51 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <jank/profile/compile_report.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile::compile_report
+{
+  TEST_SUITE("profile::compile_report")
+  {
+    TEST_CASE("json output")
+    {
+      using util::cli::opts;
+
+      auto const saved{ opts };
+      util::scope_exit const restore{ [&] { opts = saved; } };
+      auto const path{ std::filesystem::temp_directory_path() / "jank-compile-report.json" };
+      opts.compile_report_file = path.string();
+
+      /* configure() would write the report again at exit, so it's enabled directly. */
+      enabled.store(true);
+      __rt_ctx->eval_string("(def jank-test-compile-report-a 1)\n"
+                            "(def jank-test-compile-report-b\n  [1, 2])");
+      write();
+      CHECK_FALSE(is_enabled());
+
+      std::ifstream in{ path };
+      std::stringstream ss;
+      ss << in.rdbuf();
+      jtl::immutable_string const json{ ss.str() };
+      std::filesystem::remove(path);
+
+      CHECK(json.starts_with("{\n\"total\":{"));
+      CHECK(json.ends_with("]}\n"));
+      CHECK(json.contains(R"("phases-ms":{"read":)"));
+      CHECK(json.contains(R"("eval":)"));
+      CHECK_FALSE(json.contains(R"("lex":)"));
+      CHECK(json.contains(R"("form":"(def jank-test-compile-report-a 1)")"));
+      /* Forms are collapsed onto one line. */
+      CHECK(json.contains(R"("form":"(def jank-test-compile-report-b [1 2])")"));
+      CHECK(json.contains(R"("line":2)"));
+      CHECK(json.contains("\"slowest\":["));
+    }
+  }
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <thread>
+
+#include <signal.h>
+
+#include <jank/profile/sampler.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile::sampler
+{
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static volatile u64 spin_sink{};
+
+  [[gnu::noinline]]
+  static void spin()
+  {
+    for(u64 i{}; i < 1'000'000; ++i)
+    {
+      spin_sink = spin_sink + i;
+    }
+  }
+
+  TEST_SUITE("profile::sampler")
+  {
+    TEST_CASE("invalid rates")
+    {
+      CHECK(start(0).is_err());
+      CHECK(start(1'000'000).is_err());
+      CHECK_FALSE(is_running());
+    }
+
+    TEST_CASE("jank fns are symbolized")
+    {
+      /* We pretend spin was JIT compiled from jank, so its samples should be shown as
+       * the jank fn. The size only needs to cover spin. */
+      read::source_position position;
+      position.line = 3;
+      register_jit_symbol(reinterpret_cast<uptr>(&spin), 256, "test_spin_12_0");
+      register_jank_fn("test_spin_12", "test/spin", { "spin.jank", "test", position, position });
+
+      clear();
+      REQUIRE(start(1000).is_ok());
+      CHECK(is_running());
+      CHECK(start(1000).is_err());
+
+      auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 5 } };
+      jtl::immutable_string stacks;
+      while(std::chrono::steady_clock::now() < deadline)
+      {
+        spin();
+        stacks = folded_stacks();
+        if(stacks.contains("test/spin (spin.jank:3)"))
+        {
+          break;
+        }
+      }
+      stop();
+      CHECK_FALSE(is_running());
+
+      CHECK(stacks.contains("test/spin (spin.jank:3)"));
+      /* Each line ends with its count. */
+      CHECK(stacks.ends_with("\n"));
+
+      clear();
+      CHECK(folded_stacks().empty());
+    }
+
+    TEST_CASE("stopping restores the previous SIGPROF action")
+    {
+      struct sigaction previous{};
+      previous.sa_handler = SIG_IGN;
+      sigemptyset(&previous.sa_mask);
+      struct sigaction saved{};
+      REQUIRE(sigaction(SIGPROF, &previous, &saved) == 0);
+
+      REQUIRE(start(1000).is_ok());
+      struct sigaction during{};
+      sigaction(SIGPROF, nullptr, &during);
+      CHECK(during.sa_handler != SIG_IGN);
+      stop();
+
+      struct sigaction after{};
+      sigaction(SIGPROF, &saved, &after);
+      CHECK(after.sa_handler == SIG_IGN);
+      clear();
+    }
+
+    TEST_CASE("concurrent starts and stops")
+    {
+      /* Either thread may find the sampler already running or already stopped, but neither
+       * may start it over a drain thread which is still being joined. */
+      auto const toggle{ [] {
+        for(usize i{}; i < 50; ++i)
+        {
+          static_cast<void>(start(1000));
+          stop();
+        }
+      } };
+      std::thread other{ toggle };
+      toggle();
+      other.join();
+      CHECK_FALSE(is_running());
+      clear();
+    }
+  }
+}
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <jank/profile/time.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile
+{
+  /* Just enough of a JSON parser to tell whether a trace is well formed. */
+  struct json_checker
+  {
+    void skip_space()
+    {
+      while(pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos])) != 0)
+      {
+        ++pos;
+      }
+    }
+
+    bool consume(char const c)
+    {
+      skip_space();
+      if(pos < json.size() && json[pos] == c)
+      {
+        ++pos;
+        return true;
+      }
+      return false;
+    }
+
+    bool literal(std::string_view const word)
+    {
+      if(json.substr(pos, word.size()) != word)
+      {
+        return false;
+      }
+      pos += word.size();
+      return true;
+    }
+
+    bool string()
+    {
+      if(!consume('"'))
+      {
+        return false;
+      }
+      while(pos < json.size())
+      {
+        auto const c{ json[pos++] };
+        if(c == '"')
+        {
+          return true;
+        }
+        if(static_cast<unsigned char>(c) < 0x20)
+        {
+          return false;
+        }
+        if(c != '\\')
+        {
+          continue;
+        }
+        if(pos == json.size())
+        {
+          return false;
+        }
+        auto const escaped{ json[pos++] };
+        if(escaped == 'u')
+        {
+          for(usize i{}; i < 4; ++i, ++pos)
+          {
+            if(pos == json.size() || std::isxdigit(static_cast<unsigned char>(json[pos])) == 0)
+            {
+              return false;
+            }
+          }
+        }
+        else if(std::string_view{ "\"\\/bfnrt" }.find(escaped) == std::string_view::npos)
+        {
+          return false;
+        }
+      }
+      return false;
+    }
+
+    bool number()
+    {
+      consume('-');
+      auto const start{ pos };
+      while(pos < json.size()
+            && (std::isdigit(static_cast<unsigned char>(json[pos])) != 0
+                || std::string_view{ ".eE+-" }.find(json[pos]) != std::string_view::npos))
+      {
+        ++pos;
+      }
+      return pos != start && std::isdigit(static_cast<unsigned char>(json[start])) != 0;
+    }
+
+    template <typename F>
+    bool sequence(char const close, F const &element)
+    {
+      if(consume(close))
+      {
+        return true;
+      }
+      do
+      {
+        if(!element())
+        {
+          return false;
+        }
+      } while(consume(','));
+      return consume(close);
+    }
+
+    bool value()
+    {
+      skip_space();
+      if(pos == json.size())
+      {
+        return false;
+      }
+      switch(json[pos])
+      {
+        case '{':
+          ++pos;
+          return sequence('}', [this] { return string() && consume(':') && value(); });
+        case '[':
+          ++pos;
+          return sequence(']', [this] { return value(); });
+        case '"':
+          return string();
+        case 't':
+          return literal("true");
+        case 'f':
+          return literal("false");
+        case 'n':
+          return literal("null");
+        default:
+          return number();
+      }
+    }
+
+    bool document()
+    {
+      if(!value())
+      {
+        return false;
+      }
+      skip_space();
+      return pos == json.size();
+    }
+
+    std::string_view json;
+    usize pos{};
+  };
+
+  /* Each trace event is on its own line, so fields can be found without parsing. This
+   * gives the raw JSON of the field's value, so strings keep their quotes. */
+  static std::string_view field(std::string_view const event, std::string_view const key)
+  {
+    std::string needle{ '"' };
+    needle += key;
+    needle += "\":";
+    auto start{ event.find(needle) };
+    if(start == std::string_view::npos)
+    {
+      return {};
+    }
+    start += needle.size();
+    return event.substr(start, event.find_first_of(",}", start) - start);
+  }
+
+  TEST_SUITE("profile::time")
+  {
+    TEST_CASE("disabled timers record nothing")
+    {
+      REQUIRE_FALSE(is_enabled());
+
+      char const * const fmt{ "jank-test disabled {}" };
+      timer const plain{ "jank-test disabled" };
+      timer const formatted{ fmt, 1 };
+      CHECK_FALSE(plain.active);
+      CHECK_FALSE(formatted.active);
+      /* Regions are only formatted once they're going to be recorded. */
+      CHECK(formatted.formatted.empty());
+      CHECK_EQ(formatted.region.data(), fmt);
+    }
+
+    TEST_CASE("chrome trace")
+    {
+      using util::cli::opts;
+
+      auto const saved{ opts };
+      util::scope_exit const restore{ [&] { opts = saved; } };
+      auto const path{ std::filesystem::temp_directory_path() / "jank-profile.json" };
+
+      /* Nothing from before profiling is configured makes it into the trace. */
+      {
+        timer const t{ "jank-test disabled" };
+        counter("jank-test disabled", 1);
+      }
+
+      opts.profiler_enabled = true;
+      opts.profiler_format = util::cli::profiler_format::chrome_trace;
+      opts.profiler_file = path.string();
+      configure();
+      REQUIRE(is_enabled());
+
+      auto const flow{ next_flow_id() };
+      {
+        timer const t{ "jank-test main {}", 1 };
+        flow_start("jank-test flow", flow);
+        counter("jank-test counter", 42);
+        timer const escaped{ "jank-test \"quoted\"\tregion" };
+      }
+      std::thread worker{ [flow] {
+        timer const t{ "jank-test worker" };
+        flow_end("jank-test flow", flow);
+      } };
+      worker.join();
+      shutdown();
+      CHECK_FALSE(is_enabled());
+
+      std::ifstream in{ path };
+      std::stringstream ss;
+      ss << in.rdbuf();
+      auto const trace{ ss.str() };
+      std::filesystem::remove(path);
+
+      CHECK(json_checker{ trace }.document());
+      CHECK(trace.find("jank-test disabled") == std::string::npos);
+
+      std::vector<std::string_view> events;
+      std::string_view rest{ trace };
+      while(!rest.empty())
+      {
+        auto const end{ std::min(rest.find('\n'), rest.size()) };
+        auto const line{ rest.substr(0, end) };
+        if(line.find(R"("name":"jank-test)") != std::string_view::npos)
+        {
+          events.emplace_back(line);
+        }
+        rest.remove_prefix(std::min(end + 1, rest.size()));
+      }
+
+      auto const find_event{ [&](std::string_view const name, std::string_view const ph) {
+        for(auto const e : events)
+        {
+          if(field(e, "name") == name && field(e, "ph") == ph)
+          {
+            return e;
+          }
+        }
+        return std::string_view{};
+      } };
+
+      auto const main_enter{ find_event(R"("jank-test main 1")", R"("B")") };
+      auto const main_exit{ find_event(R"("jank-test main 1")", R"("E")") };
+      auto const worker_enter{ find_event(R"("jank-test worker")", R"("B")") };
+      auto const worker_exit{ find_event(R"("jank-test worker")", R"("E")") };
+      REQUIRE_FALSE(main_enter.empty());
+      REQUIRE_FALSE(main_exit.empty());
+      REQUIRE_FALSE(worker_enter.empty());
+      REQUIRE_FALSE(worker_exit.empty());
+      CHECK_FALSE(find_event(R"("jank-test \"quoted\"\u0009region")", R"("B")").empty());
+
+      /* Each thread gets its own id, which is shared by all of its events. Zero is the
+       * process wide track. */
+      auto const main_tid{ field(main_enter, "tid") };
+      auto const worker_tid{ field(worker_enter, "tid") };
+      CHECK(main_tid != "0");
+      CHECK(worker_tid != "0");
+      CHECK(main_tid != worker_tid);
+      CHECK(field(main_exit, "tid") == main_tid);
+      CHECK(field(worker_exit, "tid") == worker_tid);
+      CHECK(field(main_enter, "pid") == field(worker_enter, "pid"));
+
+      auto const counter_event{ find_event(R"("jank-test counter")", R"("C")") };
+      CHECK(counter_event.find(R"("args":{"value":42})") != std::string_view::npos);
+
+      /* The flow starts on the main thread and ends within the worker's region. */
+      auto const flow_id{ std::to_string(flow) };
+      auto const started{ find_event(R"("jank-test flow")", R"("s")") };
+      auto const ended{ find_event(R"("jank-test flow")", R"("f")") };
+      CHECK(field(started, "id") == flow_id);
+      CHECK(field(started, "tid") == main_tid);
+      CHECK(field(ended, "id") == flow_id);
+      CHECK(field(ended, "tid") == worker_tid);
+      CHECK(field(ended, "bp") == R"("e")");
+    }
+  }
+}
@@ -0,0 +1,172 @@
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <jtl/string_builder.hpp>
+
+#include <jank/runtime/perf.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::perf
+{
+  static object_ref kw(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  /* Small, quiet runs, so these stay fast. */
+  static object_ref quick_opts(jtl::immutable_string const &extra)
+  {
+    jtl::string_builder sb;
+    sb("{:samples 3 :warmup 1 :min-iterations 1 :quiet? true ")(extra)("}");
+    return __rt_ctx->read_string(sb.release());
+  }
+
+  static object_ref quick_fn()
+  {
+    return __rt_ctx->find_var("clojure.core", "vector")->deref();
+  }
+
+  static jtl::immutable_string slurp(std::filesystem::path const &path)
+  {
+    std::ifstream in{ path };
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  TEST_SUITE("perf")
+  {
+    TEST_CASE("units can be keywords or strings")
+    {
+      auto const from_keyword{ benchmark(quick_opts(":unit :ns"), quick_fn()) };
+      CHECK(equal(get(from_keyword, kw("unit")), make_box("ns")));
+      auto const from_string{ benchmark(quick_opts(":unit \"us\""), quick_fn()) };
+      CHECK(equal(get(from_string, kw("unit")), make_box("us")));
+      CHECK_THROWS_AS(benchmark(quick_opts(":unit :minutes"), quick_fn()), std::runtime_error);
+    }
+
+    TEST_CASE("baselines")
+    {
+      /* Calling vector is far quicker than a second and far slower than an attosecond. */
+      auto const faster{ benchmark(quick_opts(":baseline {:median 1 :unit :s}"),
+                                   quick_fn()) };
+      auto const faster_baseline{ get(faster, kw("baseline")) };
+      CHECK(to_real(get(faster_baseline, kw("change"))) < 0);
+      CHECK_FALSE(truthy(get(faster_baseline, kw("regression?"))));
+
+      auto const slower{ benchmark(quick_opts(":baseline {:median 1.0e-9 :unit \"ns\"}"),
+                                   quick_fn()) };
+      auto const slower_baseline{ get(slower, kw("baseline")) };
+      CHECK(to_real(get(slower_baseline, kw("change"))) > 0);
+      CHECK(truthy(get(slower_baseline, kw("regression?"))));
+
+      /* A regression only throws when asked to. */
+      CHECK_THROWS_AS(
+        benchmark(quick_opts(":baseline {:median 1.0e-9 :unit :ns} :fail-on-regression? true"),
+                  quick_fn()),
+        std::runtime_error);
+      CHECK_NOTHROW(benchmark(
+        quick_opts(":baseline {:median 1 :unit :s} :fail-on-regression? true"),
+        quick_fn()));
+    }
+
+    TEST_CASE("an edn output can be used as a baseline")
+    {
+      auto const path{ std::filesystem::temp_directory_path() / "jank-perf-baseline.edn" };
+      auto const recorded{ benchmark(
+        quick_opts(util::format(":unit :us :output \"{}\"", path.string())),
+        quick_fn()) };
+
+      auto const compared{ benchmark(
+        quick_opts(util::format(":unit :ns :baseline \"{}\"", path.string())),
+        quick_fn()) };
+      auto const baseline{ get(compared, kw("baseline")) };
+      CHECK(to_real(get(baseline, kw("median")))
+            == doctest::Approx(to_real(get(recorded, kw("median")))));
+      CHECK(equal(get(baseline, kw("unit")), make_box("us")));
+      std::filesystem::remove(path);
+    }
+
+    TEST_CASE("allocation sites")
+    {
+      __rt_ctx->eval_string(R"((defn jank-test-perf-allocating [n]
+                                 (loop [i 0
+                                        acc []]
+                                   (if (< i n)
+                                     (recur (inc i) (conj acc (* 2.5 i)))
+                                     acc))))");
+
+      clear_allocations();
+      start_allocation_profile(__rt_ctx->read_string("{:interval 1}"));
+      __rt_ctx->eval_string("(jank-test-perf-allocating 100)");
+      stop_allocation_profile();
+
+      /* Compiling the call allocates too, so every site is needed to find the fn's. */
+      auto const sites{ allocation_sites(
+        __rt_ctx->read_string("{:sort-by :count :limit 1000000}")) };
+      i64 previous_count{ std::numeric_limits<i64>::max() };
+      bool found_fn{};
+      for(auto it{ seq(sites) }; it.is_some(); it = next(it))
+      {
+        auto const site{ first(it) };
+        CHECK(get(site, kw("type"))->type == object_type::keyword);
+        CHECK(get(site, kw("caller"))->type == object_type::persistent_string);
+        CHECK(get(site, kw("address"))->type == object_type::integer);
+        CHECK(get(site, kw("bytes"))->type == object_type::integer);
+        CHECK(get(site, kw("bytes-per-second"))->type == object_type::real);
+
+        auto const count{ to_int(get(site, kw("count"))) };
+        CHECK(count <= previous_count);
+        previous_count = count;
+
+        auto const fn{ get(site, kw("fn")) };
+        if(!fn.is_nil() && to_string(fn).contains("jank-test-perf-allocating")
+           && equal(get(site, kw("type")), kw("real")))
+        {
+          found_fn = true;
+        }
+      }
+      CHECK(found_fn);
+      CHECK(sequence_length(allocation_sites(__rt_ctx->read_string("{:limit 2}"))) <= 2);
+
+      CHECK_THROWS_AS(allocation_sites(__rt_ctx->read_string("{:sort-by :name}")),
+                      std::runtime_error);
+      clear_allocations();
+    }
+
+    TEST_CASE("outputs escape labels")
+    {
+      auto const md_path{ std::filesystem::temp_directory_path() / "jank-perf-label.md" };
+      benchmark(quick_opts(util::format(":label \"a|b\\nc\" :output \"{}\"", md_path.string())),
+                quick_fn());
+      auto const md{ slurp(md_path) };
+      CHECK(md.contains("| a\\|b c |"));
+      std::filesystem::remove(md_path);
+
+      auto const json_path{ std::filesystem::temp_directory_path() / "jank-perf-label.json" };
+      benchmark(
+        quick_opts(util::format(":label \"a\\\"b\\nc\" :output \"{}\"", json_path.string())),
+        quick_fn());
+      auto const json{ slurp(json_path) };
+      CHECK(json.contains(R"("label":"a\"b\nc")"));
+      CHECK_FALSE(json.contains("b\nc"));
+      std::filesystem::remove(json_path);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+#include <jank/gc.hpp>
+#include <jank/util/arena.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::util
+{
+  struct arena_test_value
+  {
+    i64 a{};
+    alignas(16) i64 b{};
+  };
+
+  TEST_SUITE("util::arena")
+  {
+    TEST_CASE("no arena")
+    {
+      CHECK_EQ(nullptr, arena::current());
+      auto const v{ make_arena_ref<arena_test_value>(1, 2) };
+      CHECK_EQ(v.data, GC_base(v.data));
+    }
+
+    TEST_CASE("bump allocation")
+    {
+      arena a;
+      CHECK_EQ(&a, arena::current());
+
+      auto const first{ make_arena_ref<arena_test_value>(1, 2) };
+      auto const second{ make_arena_ref<arena_test_value>(3, 4) };
+      CHECK_EQ(1, first->a);
+      CHECK_EQ(4, second->b);
+      CHECK_EQ(0, reinterpret_cast<uptr>(second.data) % alignof(arena_test_value));
+      CHECK_EQ(a.chunk, GC_base(first.data));
+      CHECK_EQ(a.chunk, GC_base(second.data));
+    }
+
+    TEST_CASE("new chunks")
+    {
+      arena a;
+      auto const first{ make_arena_ref<arena_test_value>() };
+      auto const first_chunk{ a.chunk };
+      for(usize i{}; i < arena::chunk_size / sizeof(arena_test_value); ++i)
+      {
+        make_arena_ref<arena_test_value>();
+      }
+      CHECK_NE(first_chunk, a.chunk);
+      CHECK_EQ(first_chunk, GC_base(first.data));
+    }
+
+    TEST_CASE("large allocations")
+    {
+      arena a;
+      auto const p{ a.allocate(arena::max_inline_size + 1, 8) };
+      CHECK_EQ(p, GC_base(p));
+      CHECK_EQ(nullptr, a.chunk);
+    }
+
+    TEST_CASE("nesting")
+    {
+      arena outer;
+      {
+        arena inner;
+        CHECK_EQ(&inner, arena::current());
+      }
+      CHECK_EQ(&outer, arena::current());
+    }
+  }
+}
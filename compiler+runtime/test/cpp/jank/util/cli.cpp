@@ -0,0 +1,64 @@
+#include <vector>
+
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::util::cli
+{
+  /* The opts are global, so each parse gets a fresh set, and the test runner gets its own
+   * back once we're done. */
+  static jtl::result<void, int> parse(std::initializer_list<char const *> const args)
+  {
+    opts = {};
+    std::vector<char const *> argv{ "jank" };
+    argv.insert(argv.end(), args);
+    return parse_opts(static_cast<int>(argv.size()), argv.data());
+  }
+
+  TEST_SUITE("util::cli")
+  {
+    TEST_CASE("AOT optimization flags")
+    {
+      auto const saved{ opts };
+      util::scope_exit const restore{ [&] { opts = saved; } };
+
+      SUBCASE("lto")
+      {
+        REQUIRE(parse({ "compile", "app" }).is_ok());
+        CHECK(opts.lto == lto_mode::none);
+        REQUIRE(parse({ "--lto", "thin", "compile", "app" }).is_ok());
+        CHECK(opts.lto == lto_mode::thin);
+        REQUIRE(parse({ "--lto", "full", "compile", "app" }).is_ok());
+        CHECK(opts.lto == lto_mode::full);
+        REQUIRE(parse({ "--lto", "none", "compile", "app" }).is_ok());
+        CHECK(opts.lto == lto_mode::none);
+        CHECK(parse({ "--lto", "fat", "compile", "app" }).is_err());
+      }
+
+      SUBCASE("profile generate")
+      {
+        REQUIRE(parse({ "compile", "app" }).is_ok());
+        CHECK_FALSE(opts.profile_generate);
+        CHECK_EQ(module_output_dir(), "target");
+
+        REQUIRE(parse({ "--profile-generate", "compile", "app" }).is_ok());
+        CHECK(opts.profile_generate);
+        CHECK_EQ(module_output_dir(), "target-profile-generate");
+
+        REQUIRE(
+          parse({ "--profile-generate", "--output-dir", "build/out/", "compile", "app" }).is_ok());
+        CHECK_EQ(module_output_dir(), "build/out-profile-generate");
+      }
+
+      SUBCASE("profile use")
+      {
+        REQUIRE(parse({ "--profile-use", "app.profdata", "compile", "app" }).is_ok());
+        CHECK_EQ(opts.profile_use, "app.profdata");
+        CHECK(parse({ "compile", "app", "--profile-use" }).is_err());
+      }
+    }
+  }
+}